@@ -0,0 +1,176 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef AGGREGATOR_H
+#define AGGREGATOR_H
+
+#include <algorithm> // std::max, std::remove_if
+#include <chrono> // std::chrono::steady_clock
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <type_traits> // std::enable_if
+#include <utility> // std::move
+#include <vector>
+#include <NiceMPI/NiceMPI.h> // Communicator
+
+namespace NiceMPI {
+
+/** \brief Coalesces many small messages of type \p Type: the messages sent to a destination are buffered, and the
+  buffer is sent as a single message when it holds \p threshold bytes, when its oldest message waited for
+  \p timeout, or when flush() is called. The receiver unpacks the buffers with poll(), which calls the handler
+  once per message. Every process must call poll() regularly, and drain() at the end of a phase, to find out when
+  every message is handled. An aggregator communicates on its own duplicate of the communicator, and it is not
+  thread-safe. */
+template<class Type>
+class Aggregator {
+	static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be aggregated.");
+
+public:
+	/** \brief Function called for each message received, with the rank of its source. */
+	using Handler = std::function<void(int source, const Type& data)>;
+
+	/** \brief Prepares the aggregation of messages on \p communicator, handled by \p handler. Collective. */
+	Aggregator(const Communicator& communicator, Handler handler, std::size_t threshold = 16384,
+		std::chrono::microseconds timeout = std::chrono::microseconds{1000})
+	: communicator(communicator.duplicate()), handler(std::move(handler)),
+		capacity(std::max<std::size_t>(1,threshold/sizeof(Type))), timeout(timeout),
+		buffers(static_cast<std::size_t>(communicator.size())), oldest(), sent(0), received(0)
+	{
+		receiveNext();
+	}
+
+	/** \brief Handles messages until every message sent by every process is handled, including those sent by the
+  handlers. Detects the termination with waves of reductions of the counts of messages sent and received: it
+  ends when two consecutive waves find the same counts, and as many messages received as sent. Collective. */
+	void drain() {
+		std::vector<unsigned long long> previous;
+		while(true) {
+			flush();
+			poll();
+			ReceiveRequest<std::vector<unsigned long long>> wave = communicator.asyncAllReduce(
+				std::vector<unsigned long long>{ sent, received });
+			while(!wave.isCompleted()) {
+				poll();
+				flush();
+			}
+			wave.wait();
+			const std::vector<unsigned long long> totals = wave.take();
+			if(totals[0] == totals[1] and totals == previous) break;
+			previous = totals;
+		}
+		for(auto&& x: pending) x.wait();
+		pending.clear();
+	}
+	/** \brief Sends every buffer that holds messages. */
+	void flush() {
+		for(std::size_t destination = 0; destination < buffers.size(); ++destination) {
+			flush(static_cast<int>(destination));
+		}
+		pending.erase(std::remove_if(pending.begin(),pending.end(),[](SendRequest& x) {
+			return x.isCompleted();
+		}),pending.end());
+	}
+	/** \brief Handles the messages that are received, without waiting, and sends the buffers that waited for too
+  long. Returns the number of messages handled. */
+	std::size_t poll() {
+		std::size_t handled = 0;
+		while(incoming->isCompleted()) {
+			const int source = incoming->source();
+			const std::vector<Type> batch = incoming->take();
+			receiveNext();
+			for(auto&& x: batch) handler(source,x);
+			handled += batch.size();
+			received += batch.size();
+		}
+		if(isLate()) flush();
+		return handled;
+	}
+	/** \brief Returns the number of messages handled by this process. */
+	unsigned long long receivedCount() const {
+		return received;
+	}
+	/** \brief Buffers the \p data to be sent to the \p destination. */
+	void send(const Type& data, int destination) {
+		std::vector<Type>& buffer = buffers[static_cast<std::size_t>(destination)];
+		if(buffer.empty()) {
+			buffer.reserve(capacity);
+			if(isIdle()) oldest = std::chrono::steady_clock::now();
+		}
+		buffer.push_back(data);
+		if(buffer.size() >= capacity) flush(destination);
+		else if(isLate()) flush();
+	}
+	/** \brief Returns the number of messages sent by this process, not counting those still buffered. */
+	unsigned long long sentCount() const {
+		return sent;
+	}
+
+private:
+	/** \brief Sends the buffer of the \p destination, if it holds messages. */
+	void flush(int destination) {
+		std::vector<Type>& buffer = buffers[static_cast<std::size_t>(destination)];
+		if(buffer.empty()) return;
+		sent += buffer.size();
+		pending.push_back(communicator.asyncSend(std::move(buffer),destination));
+		buffer = std::vector<Type>();
+		if(isIdle()) oldest = std::chrono::steady_clock::time_point();
+	}
+	/** \brief Returns true if no message is buffered. */
+	bool isIdle() const {
+		return std::all_of(buffers.begin(),buffers.end(),[](const std::vector<Type>& x) { return x.empty(); });
+	}
+	/** \brief Returns true if a message is buffered for longer than the timeout. */
+	bool isLate() const {
+		return oldest != std::chrono::steady_clock::time_point() and
+			std::chrono::steady_clock::now() - oldest >= timeout;
+	}
+	/** \brief Starts to receive the next buffer, from any process. */
+	void receiveNext() {
+		incoming.reset(new ReceiveRequest<std::vector<Type>>(
+			communicator.asyncReceiveMessage<std::vector<Type>>(MPI_ANY_SOURCE)));
+	}
+
+	/** \brief Duplicate of the communicator, which isolates the messages. */
+	Communicator communicator;
+	/** \brief Function called for each message received. */
+	Handler handler;
+	/** \brief Number of messages in a full buffer. */
+	std::size_t capacity;
+	/** \brief Time after which a message buffered is sent. */
+	std::chrono::microseconds timeout;
+	/** \brief Messages buffered, for each destination. */
+	std::vector<std::vector<Type>> buffers;
+	/** \brief Time at which the oldest message buffered was buffered, or the epoch if none. */
+	std::chrono::steady_clock::time_point oldest;
+	/** \brief Buffers sent and not completed yet. */
+	std::vector<SendRequest> pending;
+	/** \brief Receive of the next buffer. */
+	std::unique_ptr<ReceiveRequest<std::vector<Type>>> incoming;
+	/** \brief Number of messages sent. */
+	unsigned long long sent;
+	/** \brief Number of messages handled. */
+	unsigned long long received;
+};
+
+} // NiceMPi
+
+#endif  /* AGGREGATOR_H */
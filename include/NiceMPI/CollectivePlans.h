@@ -0,0 +1,351 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef COLLECTIVEPLANS_H
+#define COLLECTIVEPLANS_H
+
+#include <algorithm> // std::max
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <vector>
+#include <mpi.h> // MPI_Request
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/NiceMPI.h> // Communicator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Profiler.h> // NICEMPI_PROFILE_WAIT
+#include <NiceMPI/Span.h> // Span
+#include "private/LargeCount.h" // maxIntCount
+
+namespace NiceMPI {
+
+/** \brief Collective bound once to its counts, displacements and buffers, that can be run again and again without
+  preparation nor allocation. With MPI-4, the plan is a persistent collective, and start() is MPI_Start. Without
+  it, start() calls the nonblocking collective with the counts and displacements computed once by the plan. A plan
+  can't be copied nor moved, since MPI keeps the addresses of its buffers. */
+class CollectivePlan {
+public:
+	/** \brief This object can't be copied nor moved, since MPI keeps the addresses of its buffers. **/
+	CollectivePlan(const CollectivePlan&) = delete;
+	/** \brief This object can't be copied nor moved, since MPI keeps the addresses of its buffers. **/
+	CollectivePlan& operator=(const CollectivePlan&) = delete;
+
+	/** \brief Returns true if the collective is completed, or if it is not started. */
+	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("CollectivePlan::isCompleted");
+		int flag = 0;
+		handleError(MPI_Test(&value, &flag, MPI_STATUS_IGNORE));
+		return flag != 0;
+	}
+	/** \brief Starts the collective and waits for it to complete. Collective. */
+	void run() {
+		start();
+		wait();
+	}
+	/** \brief Starts the collective. The previous one must be completed. Collective. */
+	void start() {
+		handleError(begin());
+	}
+	/** \brief Waits for the collective to complete. */
+	void wait() {
+		NICEMPI_PROFILE_WAIT("CollectivePlan::wait");
+		handleError(MPI_Wait(&value,MPI_STATUS_IGNORE));
+	}
+
+protected:
+	/** \brief Initializes a plan on \p communicator, that isn't bound to a collective yet. */
+	explicit CollectivePlan(const Communicator& communicator): communicator(communicator.shared()),
+		value(MPI_REQUEST_NULL)
+	{}
+	/** \brief The derived plans must call complete() in their destructor, since their buffers are destroyed
+  before this. */
+	virtual ~CollectivePlan() {
+		complete();
+	}
+	/** \brief Waits for an active collective and frees the MPI implementation, if MPI is not finalized yet. */
+	void complete() {
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+		if(value == MPI_REQUEST_NULL or finalized) return;
+		int error = MPI_Wait(&value,MPI_STATUS_IGNORE);
+#if MPI_VERSION >= 4
+		if(error == MPI_SUCCESS) error = MPI_Request_free(&value);
+#endif
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Ignore MPI_Wait and MPI_Request_free errors in release
+	}
+	/** \brief Returns the displacements of the data of each process: \p displacements, or the data placed
+  sequentially according to \p counts if there is no displacement. */
+	static std::vector<std::size_t> plannedDisplacements(const std::vector<int>& counts,
+		const std::vector<int>& displacements)
+	{
+		if(!displacements.empty()) return std::vector<std::size_t>(displacements.begin(),displacements.end());
+		std::vector<std::size_t> x(counts.size());
+		for(std::size_t i = 1; i < x.size(); ++i) x[i] = x[i-1] + static_cast<std::size_t>(counts[i-1]);
+		return x;
+	}
+	/** \brief Returns the number of elements needed to hold \p counts elements at the \p displacements. */
+	static std::size_t extent(const std::vector<int>& counts, const std::vector<std::size_t>& displacements) {
+		std::size_t x = 0;
+		for(std::size_t i = 0; i < counts.size(); ++i) {
+			x = std::max(x, displacements[i] + static_cast<std::size_t>(counts[i]));
+		}
+		return x;
+	}
+#if MPI_VERSION >= 4
+	/** \brief Returns the \p values as large counts or displacements, for the _init_c variants. */
+	template<typename Large, typename Value>
+	static std::vector<Large> toLarge(const std::vector<Value>& values) {
+		return std::vector<Large>(values.begin(),values.end());
+	}
+#else
+	/** \brief Returns the \p displacements as ints. Throws NiceMPIexception with MPI_ERR_COUNT if one of them is
+  larger than INT_MAX, since the nonblocking collectives don't have large counts without MPI-4. */
+	static std::vector<int> toIntDisplacements(const std::vector<std::size_t>& displacements) {
+		for(std::size_t x: displacements) {
+			if(x > maxIntCount) handleError(MPI_ERR_COUNT);
+		}
+		return std::vector<int>(displacements.begin(),displacements.end());
+	}
+#endif
+
+	/** \brief Cheap copy of the communicator of the collective. */
+	Communicator communicator;
+	/** \brief MPI implementation: the persistent collective with MPI-4, or the last nonblocking collective. */
+	MPI_Request value;
+
+private:
+	/** \brief Starts the collective, and returns the MPI error code. */
+	virtual int begin() = 0;
+};
+
+/** \brief Plan of varyingAllGather() with fixed counts: \p receiveCounts[i] data is received from the process with
+  rank \p i, at the index \p displacements[i] of result(). Every process gives the same counts and displacements.
+  The data to send are written in toSend() before each start(). */
+template<class Type>
+class VaryingAllGatherPlan: public CollectivePlan {
+	static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be gathered.");
+
+public:
+	/** \brief Binds the plan to its counts and buffers. Collective. */
+	VaryingAllGatherPlan(const Communicator& communicator, const std::vector<int>& receiveCounts,
+		const std::vector<int>& displacements = {})
+	: CollectivePlan(communicator), counts(receiveCounts),
+		sent(static_cast<std::size_t>(receiveCounts[static_cast<std::size_t>(communicator.rank())]))
+	{
+		const std::vector<std::size_t> actualDisplacements = plannedDisplacements(receiveCounts,displacements);
+		received.resize(extent(receiveCounts,actualDisplacements));
+#if MPI_VERSION >= 4
+		largeCounts = toLarge<MPI_Count>(counts);
+		largeDisplacements = toLarge<MPI_Aint>(actualDisplacements);
+		handleError(MPI_Allgatherv_init_c(sent.data(),sent.size(),mpi_datatype<Type>::get(),received.data(),
+			largeCounts.data(),largeDisplacements.data(),mpi_datatype<Type>::get(),this->communicator.get(),
+			MPI_INFO_NULL,&value));
+#else
+		intDisplacements = toIntDisplacements(actualDisplacements);
+#endif
+	}
+	/** \brief Waits for an active collective, since it uses the buffers. */
+	~VaryingAllGatherPlan() {
+		complete();
+	}
+
+	/** \brief Returns the data gathered by the last collective. */
+	Span<const Type> result() const {
+		return Span<const Type>(received.data(),received.size());
+	}
+	/** \brief Returns the data this process sends, that can be changed between the collectives. */
+	Span<Type> toSend() {
+		return Span<Type>(sent.data(),sent.size());
+	}
+
+private:
+	/** \brief Starts the persistent collective, or MPI_Iallgatherv without MPI-4. */
+	int begin() override {
+#if MPI_VERSION >= 4
+		return MPI_Start(&value);
+#else
+		return MPI_Iallgatherv(sent.data(),static_cast<int>(sent.size()),mpi_datatype<Type>::get(),received.data(),
+			counts.data(),intDisplacements.data(),mpi_datatype<Type>::get(),communicator.get(),&value);
+#endif
+	}
+
+	/** \brief Number of data received from each process. */
+	std::vector<int> counts;
+#if MPI_VERSION >= 4
+	/** \brief Counts given to MPI_Allgatherv_init_c. */
+	std::vector<MPI_Count> largeCounts;
+	/** \brief Displacements given to MPI_Allgatherv_init_c. */
+	std::vector<MPI_Aint> largeDisplacements;
+#else
+	/** \brief Displacements given to MPI_Iallgatherv. */
+	std::vector<int> intDisplacements;
+#endif
+	/** \brief Data sent. */
+	std::vector<Type> sent;
+	/** \brief Data received. */
+	std::vector<Type> received;
+};
+
+/** \brief Plan of varyingGather() with fixed counts: \p receiveCounts[i] data is received by the \p source from the
+  process with rank \p i, at the index \p displacements[i] of result(). Every process gives the same counts and
+  displacements. The data to send are written in toSend() before each start(). */
+template<class Type>
+class VaryingGatherPlan: public CollectivePlan {
+	static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be gathered.");
+
+public:
+	/** \brief Binds the plan to its counts and buffers. Collective. */
+	VaryingGatherPlan(const Communicator& communicator, int source, const std::vector<int>& receiveCounts,
+		const std::vector<int>& displacements = {})
+	: CollectivePlan(communicator), source(source), counts(receiveCounts),
+		sent(static_cast<std::size_t>(receiveCounts[static_cast<std::size_t>(communicator.rank())]))
+	{
+		const std::vector<std::size_t> actualDisplacements = plannedDisplacements(receiveCounts,displacements);
+		if(communicator.rank() == source) received.resize(extent(receiveCounts,actualDisplacements));
+#if MPI_VERSION >= 4
+		largeCounts = toLarge<MPI_Count>(counts);
+		largeDisplacements = toLarge<MPI_Aint>(actualDisplacements);
+		handleError(MPI_Gatherv_init_c(sent.data(),sent.size(),mpi_datatype<Type>::get(),received.data(),
+			largeCounts.data(),largeDisplacements.data(),mpi_datatype<Type>::get(),source,this->communicator.get(),
+			MPI_INFO_NULL,&value));
+#else
+		intDisplacements = toIntDisplacements(actualDisplacements);
+#endif
+	}
+	/** \brief Waits for an active collective, since it uses the buffers. */
+	~VaryingGatherPlan() {
+		complete();
+	}
+
+	/** \brief Returns the data gathered by the last collective, on the \p source only. */
+	Span<const Type> result() const {
+		return Span<const Type>(received.data(),received.size());
+	}
+	/** \brief Returns the data this process sends, that can be changed between the collectives. */
+	Span<Type> toSend() {
+		return Span<Type>(sent.data(),sent.size());
+	}
+
+private:
+	/** \brief Starts the persistent collective, or MPI_Igatherv without MPI-4. */
+	int begin() override {
+#if MPI_VERSION >= 4
+		return MPI_Start(&value);
+#else
+		return MPI_Igatherv(sent.data(),static_cast<int>(sent.size()),mpi_datatype<Type>::get(),received.data(),
+			counts.data(),intDisplacements.data(),mpi_datatype<Type>::get(),source,communicator.get(),&value);
+#endif
+	}
+
+	/** \brief Rank of the process receiving the data. */
+	int source;
+	/** \brief Number of data received from each process. */
+	std::vector<int> counts;
+#if MPI_VERSION >= 4
+	/** \brief Counts given to MPI_Gatherv_init_c. */
+	std::vector<MPI_Count> largeCounts;
+	/** \brief Displacements given to MPI_Gatherv_init_c. */
+	std::vector<MPI_Aint> largeDisplacements;
+#else
+	/** \brief Displacements given to MPI_Igatherv. */
+	std::vector<int> intDisplacements;
+#endif
+	/** \brief Data sent. */
+	std::vector<Type> sent;
+	/** \brief Data received, on the source only. */
+	std::vector<Type> received;
+};
+
+/** \brief Plan of varyingScatter() with fixed counts: \p sendCounts[i] data, from the index \p displacements[i] of
+  toSend(), is sent by the \p source to the process with rank \p i. Every process gives the same counts and
+  displacements. The \p source writes the data to send in toSend() before each start(). */
+template<class Type>
+class VaryingScatterPlan: public CollectivePlan {
+	static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be scattered.");
+
+public:
+	/** \brief Binds the plan to its counts and buffers. Collective. */
+	VaryingScatterPlan(const Communicator& communicator, int source, const std::vector<int>& sendCounts,
+		const std::vector<int>& displacements = {})
+	: CollectivePlan(communicator), source(source), counts(sendCounts),
+		received(static_cast<std::size_t>(sendCounts[static_cast<std::size_t>(communicator.rank())]))
+	{
+		const std::vector<std::size_t> actualDisplacements = plannedDisplacements(sendCounts,displacements);
+		if(communicator.rank() == source) sent.resize(extent(sendCounts,actualDisplacements));
+#if MPI_VERSION >= 4
+		largeCounts = toLarge<MPI_Count>(counts);
+		largeDisplacements = toLarge<MPI_Aint>(actualDisplacements);
+		handleError(MPI_Scatterv_init_c(sent.data(),largeCounts.data(),largeDisplacements.data(),
+			mpi_datatype<Type>::get(),received.data(),received.size(),mpi_datatype<Type>::get(),source,
+			this->communicator.get(),MPI_INFO_NULL,&value));
+#else
+		intDisplacements = toIntDisplacements(actualDisplacements);
+#endif
+	}
+	/** \brief Waits for an active collective, since it uses the buffers. */
+	~VaryingScatterPlan() {
+		complete();
+	}
+
+	/** \brief Returns the data received by this process in the last collective. */
+	Span<const Type> result() const {
+		return Span<const Type>(received.data(),received.size());
+	}
+	/** \brief Returns the data sent by the \p source, that can be changed between the collectives. Empty on the
+  other processes. */
+	Span<Type> toSend() {
+		return Span<Type>(sent.data(),sent.size());
+	}
+
+private:
+	/** \brief Starts the persistent collective, or MPI_Iscatterv without MPI-4. */
+	int begin() override {
+#if MPI_VERSION >= 4
+		return MPI_Start(&value);
+#else
+		return MPI_Iscatterv(sent.data(),counts.data(),intDisplacements.data(),mpi_datatype<Type>::get(),
+			received.data(),static_cast<int>(received.size()),mpi_datatype<Type>::get(),source,communicator.get(),
+			&value);
+#endif
+	}
+
+	/** \brief Rank of the process sending the data. */
+	int source;
+	/** \brief Number of data sent to each process. */
+	std::vector<int> counts;
+#if MPI_VERSION >= 4
+	/** \brief Counts given to MPI_Scatterv_init_c. */
+	std::vector<MPI_Count> largeCounts;
+	/** \brief Displacements given to MPI_Scatterv_init_c. */
+	std::vector<MPI_Aint> largeDisplacements;
+#else
+	/** \brief Displacements given to MPI_Iscatterv. */
+	std::vector<int> intDisplacements;
+#endif
+	/** \brief Data sent, on the source only. */
+	std::vector<Type> sent;
+	/** \brief Data received. */
+	std::vector<Type> received;
+};
+
+} // NiceMPi
+
+#endif  /* COLLECTIVEPLANS_H */
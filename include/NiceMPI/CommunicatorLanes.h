@@ -0,0 +1,70 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef COMMUNICATORLANES_H
+#define COMMUNICATORLANES_H
+
+#include <cassert>
+#include <vector>
+#include <NiceMPI/NiceMPI.h>
+
+namespace NiceMPI {
+
+/** \brief Communicators congruent to a given one, one for each worker thread. Each thread communicates through its
+  own lane: the messages of different threads can't match each other, and they don't contend on the lock that MPI
+  implementations may keep for each communicator. Concurrent use requires MPI_THREAD_MULTIPLE, see Initializer. */
+class CommunicatorLanes {
+public:
+	/** \brief Creates \p count lanes congruent to \p communicator. This is collective: every processes must create
+  the same lanes in the same order. The duplications overlap, with MPI_Comm_idup. */
+	CommunicatorLanes(const Communicator& communicator, int count) {
+		assert(count >= 0);
+		std::vector<CommunicatorRequest> requests;
+		requests.reserve(count);
+		for(int i = 0; i < count; ++i) requests.push_back(communicator.asyncDuplicate());
+		lanes.reserve(count);
+		for(auto&& r: requests) lanes.push_back(r.take());
+	}
+
+	/** \brief Returns the communicator of the \p lane, usually the index of the calling thread. */
+	Communicator& operator[](int lane) {
+		assert(lane >= 0 and lane < size());
+		return lanes[lane];
+	}
+	/** \brief Returns the communicator of the \p lane, usually the index of the calling thread. */
+	const Communicator& operator[](int lane) const {
+		assert(lane >= 0 and lane < size());
+		return lanes[lane];
+	}
+	/** \brief Returns the number of lanes. */
+	int size() const {
+		return static_cast<int>(lanes.size());
+	}
+
+private:
+	/** \brief Communicator of each lane. */
+	std::vector<Communicator> lanes;
+};
+
+} // NiceMPi
+
+#endif  /* COMMUNICATORLANES_H */
@@ -0,0 +1,135 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#if __cplusplus < 202002L
+#error "NiceMPI/Coroutine.h requires C++20"
+#endif
+
+#include <coroutine> // std::coroutine_handle
+#include <functional> // std::function
+#include <optional> // std::optional
+#include <utility> // std::move
+#include <NiceMPI/NiceMPI.h> // ReceiveRequest, SendRequest
+#include <NiceMPI/ProgressEngine.h> // ProgressEngine
+
+namespace NiceMPI {
+
+/** \brief Resumes a coroutine, given as a function, for instance by queueing it in a thread pool. */
+using Executor = std::function<void(std::function<void()>)>;
+
+/** \brief Returned by co_await on a ReceiveRequest, this object suspends the coroutine until the data are
+  received, and returns them. The request is handed over to ProgressEngine, which must be polled, and the coroutine
+  is resumed by the thread that polls, unless an Executor is given. */
+template<class Type>
+class ReceiveAwaiter {
+public:
+	/** \brief Type of the data received. */
+	using Data = typename ReceiveRequest<Type>::Data;
+
+	/** \brief Awaits the \p request, and resumes the coroutine with the \p executor, if any. */
+	explicit ReceiveAwaiter(ReceiveRequest<Type>&& request, Executor executor = nullptr)
+	: request(std::move(request)), executor(std::move(executor))
+	{}
+
+	/** \brief Returns true if the data were already received, in which case the coroutine is not suspended. */
+	bool await_ready() {
+		return request.isCompleted();
+	}
+	/** \brief Hands the request over to ProgressEngine, which resumes the \p coroutine. */
+	void await_suspend(std::coroutine_handle<> coroutine) {
+		request.then([this,coroutine](Data received) {
+			data = std::move(received);
+			if(executor) executor([coroutine]() { coroutine.resume(); });
+			else coroutine.resume();
+		});
+	}
+	/** \brief Returns the data received. */
+	Data await_resume() {
+		return data ? std::move(*data) : request.take();
+	}
+
+private:
+	/** \brief Request awaited. */
+	ReceiveRequest<Type> request;
+	/** \brief Resumes the coroutine, if not null. */
+	Executor executor;
+	/** \brief Data received, if the coroutine was suspended. */
+	std::optional<Data> data;
+};
+
+/** \brief Returned by co_await on a SendRequest, this object suspends the coroutine until the data are sent. See
+  ReceiveAwaiter. */
+class SendAwaiter {
+public:
+	/** \brief Awaits the \p request, and resumes the coroutine with the \p executor, if any. */
+	explicit SendAwaiter(SendRequest&& request, Executor executor = nullptr)
+	: request(std::move(request)), executor(std::move(executor))
+	{}
+
+	/** \brief Returns true if the data were already sent, in which case the coroutine is not suspended. */
+	bool await_ready() {
+		return request.isCompleted();
+	}
+	/** \brief Hands the request over to ProgressEngine, which resumes the \p coroutine. */
+	void await_suspend(std::coroutine_handle<> coroutine) {
+		request.then([this,coroutine]() {
+			if(executor) executor([coroutine]() { coroutine.resume(); });
+			else coroutine.resume();
+		});
+	}
+	/** \brief Nothing to return. */
+	void await_resume() {}
+
+private:
+	/** \brief Request awaited. */
+	SendRequest request;
+	/** \brief Resumes the coroutine, if not null. */
+	Executor executor;
+};
+
+/** \brief Allows to write co_await comm.asyncReceive<Type>(source). */
+template<class Type>
+ReceiveAwaiter<Type> operator co_await(ReceiveRequest<Type>&& request) {
+	return ReceiveAwaiter<Type>(std::move(request));
+}
+/** \brief Allows to write co_await comm.asyncSend(data,destination). */
+inline SendAwaiter operator co_await(SendRequest&& request) {
+	return SendAwaiter(std::move(request));
+}
+/** \brief Allows to write co_await resumeOn(comm.asyncReceive<Type>(source),executor), so that the coroutine is
+  resumed by the \p executor. */
+template<class Type>
+ReceiveAwaiter<Type> resumeOn(ReceiveRequest<Type>&& request, Executor executor) {
+	return ReceiveAwaiter<Type>(std::move(request),std::move(executor));
+}
+/** \brief Allows to write co_await resumeOn(comm.asyncSend(data,destination),executor), so that the coroutine is
+  resumed by the \p executor. */
+inline SendAwaiter resumeOn(SendRequest&& request, Executor executor) {
+	return SendAwaiter(std::move(request),std::move(executor));
+}
+
+} // NiceMPi
+
+#endif  /* COROUTINE_H */
@@ -0,0 +1,77 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef DEFAULTINITALLOCATOR_H
+#define DEFAULTINITALLOCATOR_H
+
+#include <memory> // std::allocator, std::allocator_traits
+#include <new> // placement new
+#include <type_traits> // std::is_nothrow_default_constructible
+#include <utility> // std::forward
+#include <vector>
+
+namespace NiceMPI {
+
+/** \brief Allocator that default-initializes the elements constructed without arguments, instead of
+  value-initializing them. For trivial types, a std::vector with this allocator then leaves its memory
+  uninitialized when it is resized, for instance before MPI overwrites it by a receive. The allocation itself is
+  made by \p Base. */
+template<class Type, class Base = std::allocator<Type>>
+class DefaultInitAllocator: public Base {
+	/** \brief Type traits of the allocator that allocates. */
+	using Traits = std::allocator_traits<Base>;
+
+public:
+	/** \brief Type traits that defines the DefaultInitAllocator of elements of type \p Other. */
+	template<class Other>
+	struct rebind {
+		using other = DefaultInitAllocator<Other,typename Traits::template rebind_alloc<Other>>;
+	};
+
+	/** \brief Creates the base allocator by default. */
+	DefaultInitAllocator() = default;
+	/** \brief Creates the base allocator from \p base. */
+	DefaultInitAllocator(const Base& base): Base(base)
+	{}
+	/** \brief Creates the allocator of elements of type \p Type from an allocator of elements of another type. */
+	template<class Other, class OtherBase>
+	DefaultInitAllocator(const DefaultInitAllocator<Other,OtherBase>& rhs): Base(static_cast<const OtherBase&>(rhs))
+	{}
+
+	/** \brief Default-initializes an element at \p p. */
+	template<class Element>
+	void construct(Element* p) noexcept(std::is_nothrow_default_constructible<Element>::value) {
+		::new(static_cast<void*>(p)) Element;
+	}
+	/** \brief Constructs an element at \p p from the \p arguments, by the base allocator. */
+	template<class Element, class... Arguments>
+	void construct(Element* p, Arguments&&... arguments) {
+		Traits::construct(static_cast<Base&>(*this),p,std::forward<Arguments>(arguments)...);
+	}
+};
+
+/** \brief Vector whose elements are default-initialized, so that it can be received in without zero-filling. */
+template<class Type>
+using UninitializedVector = std::vector<Type,DefaultInitAllocator<Type>>;
+
+} // NiceMPi
+
+#endif  /* DEFAULTINITALLOCATOR_H */
@@ -0,0 +1,223 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef DEVICESPAN_H
+#define DEVICESPAN_H
+
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+#include <memory> // std::shared_ptr
+#include <mpi.h> // MPI_Request
+#include <utility> // std::move
+#include <vector>
+#include <NiceMPI/DefaultInitAllocator.h> // DefaultInitAllocator
+#include <NiceMPI/MemoryPool.h> // PoolAllocator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Profiler.h> // NICEMPI_PROFILE_WAIT
+#include <NiceMPI/private/DetachedRequests.h> // DetachedRequests
+
+namespace NiceMPI {
+
+/** \brief Non-owning view of \p size contiguous elements of type \p Type in the memory of a device, like a GPU.
+  The \p stream, which is a cudaStream_t or a hipStream_t for instance, orders the operations of NiceMPI on the
+  data with those of the caller: the stream is synchronized before the data are sent, and the data received are
+  copied on it. */
+template<class Type>
+class DeviceSpan {
+public:
+	/** \brief Type of the elements. */
+	using element_type = Type;
+
+	/** \brief Creates a view of the \p size elements that start at \p data in the memory of the device, used on
+  the \p stream. */
+	DeviceSpan(Type* data, std::size_t size, void* stream = nullptr): first(data), count(size), queue(stream)
+	{}
+	/** \brief A view of non-const elements can be used as a view of const elements. */
+	template<class OtherType>
+	DeviceSpan(const DeviceSpan<OtherType>& rhs): first(rhs.data()), count(rhs.size()), queue(rhs.stream())
+	{}
+
+	/** \brief Returns the address of the first element, in the memory of the device. */
+	Type* data() const {
+		return first;
+	}
+	/** \brief Returns the number of elements. */
+	std::size_t size() const {
+		return count;
+	}
+	/** \brief Returns the stream on which the data are used. */
+	void* stream() const {
+		return queue;
+	}
+
+private:
+	/** \brief Address of the first element. */
+	Type* first;
+	/** \brief Number of elements. */
+	std::size_t count;
+	/** \brief Stream on which the data are used. */
+	void* queue;
+};
+
+
+
+/** \brief Device spans are not communicated as their bytes, so we need to distinguish them. */
+template<class T>
+struct is_device_span {
+	static constexpr bool value = false;
+};
+/** \brief Device spans are not communicated as their bytes, so we need to distinguish them. *Specialization*.*/
+template<class T>
+struct is_device_span<DeviceSpan<T>> {
+	static constexpr bool value = true;
+};
+
+/** \brief Returns a view of the \p size elements that start at \p data in the memory of a device, used on the
+  \p stream. */
+template<class Type>
+DeviceSpan<Type> makeDeviceSpan(Type* data, std::size_t size, void* stream = nullptr) {
+	return DeviceSpan<Type>(data,size,stream);
+}
+
+
+
+/** \brief Operations on the memory of a device, used to communicate a DeviceSpan. When MPI is aware of the
+  device, the addresses of the device are given to MPI directly. Otherwise, the data are staged through the host
+  in chunks, and the copy of a chunk overlaps the communication of the previous one. A backend for CUDA or HIP is
+  built in when NiceMPI is configured with NICEMPI_WITH_CUDA or NICEMPI_WITH_HIP, and other backends, like SYCL,
+  can be provided by the user. */
+class DeviceBackend {
+public:
+	/** \brief Polymorphic base class. */
+	virtual ~DeviceBackend() = default;
+
+	/** \brief Returns true if MPI can read and write the memory of the device directly. */
+	virtual bool isMPIaware() const = 0;
+	/** \brief Starts to copy \p bytes bytes from the \p device to the \p host, on the \p stream. */
+	virtual void copyToHost(void* host, const void* device, std::size_t bytes, void* stream) = 0;
+	/** \brief Starts to copy \p bytes bytes from the \p host to the \p device, on the \p stream. */
+	virtual void copyToDevice(void* device, const void* host, std::size_t bytes, void* stream) = 0;
+	/** \brief Waits until the operations started on the \p stream complete. */
+	virtual void synchronize(void* stream) = 0;
+	/** \brief Returns the size of the chunks of the staging through the host. The sender and the receiver must
+  use the same size. */
+	virtual std::size_t chunkBytes() const {
+		return 1 << 20;
+	}
+
+	/** \brief Returns the backend used to communicate a DeviceSpan. Throws if there is none. */
+	static std::shared_ptr<DeviceBackend> current();
+	/** \brief Uses the \p backend to communicate a DeviceSpan from now on. */
+	static void set(std::shared_ptr<DeviceBackend> backend);
+};
+
+
+
+/** \brief Host memory in which the data of a DeviceSpan are staged: it is pooled, so that it stays registered, and
+  it is not initialized, since it is overwritten. */
+template<class Type>
+using StagingBuffer = std::vector<Type,DefaultInitAllocator<Type,PoolAllocator<Type>>>;
+
+
+
+/** \brief Returns after an asyncSend or an asyncReceive call with a DeviceSpan, this object allows to control the
+  status of the call. When the data are staged through the host, they are communicated in chunks, and each chunk
+  received is copied to the device when the request is found completed. If it is destroyed before, a send, or a
+  receive that did not match its first chunk yet, is detached, and the data received are not copied, while a
+  receive of many chunks posted at once is completed. */
+class DeviceRequest {
+public:
+	/** \brief Called each time the MPI implementation completes, with its status. Returns true if the operation is
+  finished, or false if it started its next step in the MPI implementation. */
+	using Step = std::function<bool(MPI_Request&, const MPI_Status&)>;
+
+	/** \brief Initializes this request with its MPI implementation, which is \p cancellable if it receives, the
+  \p payload that must stay alive until the operation completes, and the step that \p advance it, if any. */
+	DeviceRequest(MPI_Request value, bool cancellable, std::shared_ptr<void> payload = nullptr, Step advance = nullptr)
+	: value(value), cancellable(cancellable), payload(std::move(payload)), advance(std::move(advance))
+	{}
+	/** \brief Detaches or completes the operation if it is not completed. */
+	~DeviceRequest() {
+		if(advance and !cancellable) wait();
+		DetachedRequests::add(value,std::move(payload),cancellable);
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	DeviceRequest(const DeviceRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	DeviceRequest(DeviceRequest&& rhs): value(rhs.value), cancellable(rhs.cancellable),
+		payload(std::move(rhs.payload)), advance(std::move(rhs.advance))
+	{
+		rhs.value = MPI_REQUEST_NULL;
+		rhs.advance = nullptr;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	DeviceRequest& operator=(const DeviceRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	DeviceRequest& operator=(DeviceRequest&&) = delete;
+
+	/** \brief Returns true if the operation is completed, and the data are on the device. */
+	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("DeviceRequest::isCompleted");
+		while(true) {
+			int flag = 0;
+			MPI_Status status;
+			handleError(MPI_Test(&value, &flag, &status));
+			if(flag == 0) return false;
+			if(advanceOnce(status)) return true;
+		}
+	}
+	/** \brief Waits for the operation to complete, and for the data to be on the device. */
+	void wait() {
+		NICEMPI_PROFILE_WAIT("DeviceRequest::wait");
+		while(true) {
+			MPI_Status status;
+			handleError(MPI_Wait(&value,&status));
+			if(advanceOnce(status)) return;
+		}
+	}
+
+private:
+	/** \brief Calls the step of the operation, whose MPI implementation completed with the \p status. Returns true
+  if the operation is finished, and frees then the payload. Once it started its second step, a receive matched
+  its message, and it can't be cancelled anymore. */
+	bool advanceOnce(const MPI_Status& status) {
+		if(advance and !advance(value,status)) {
+			cancellable = false;
+			return false;
+		}
+		advance = nullptr;
+		payload.reset();
+		return true;
+	}
+
+	/** \brief MPI implementation. */
+	MPI_Request value;
+	/** \brief True for a receive, which is cancelled if it is detached and never matched. */
+	bool cancellable;
+	/** \brief Staging buffer of the operation, if any. */
+	std::shared_ptr<void> payload;
+	/** \brief Communicates the next chunk, and copies the data received to the device, if they are staged. */
+	Step advance;
+};
+
+} // NiceMPi
+
+#endif  /* DEVICESPAN_H */
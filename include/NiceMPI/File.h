@@ -0,0 +1,228 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef FILE_H
+#define FILE_H
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <memory> // std::make_shared
+#include <string>
+#include <type_traits> // std::decay, std::enable_if
+#include <utility> // std::forward
+#include <vector>
+#include <mpi.h> // MPI_File
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/NiceMPI.h> // Communicator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Span.h> // Span
+#include <NiceMPI/StridedView.h> // StridedView
+#include "private/LargeCount.h"
+
+namespace NiceMPI {
+
+/** \brief File opened by every process of a communicator, with MPI-IO: each process reads and writes its own part
+  of the file directly, so that a checkpoint uses the bandwidth of the whole file system instead of the memory of a
+  single process. The offsets are in bytes until a view is set, and then in elements of the view, relatively to its
+  displacement. The functions whose name ends with All are collective, and let MPI aggregate the accesses. */
+class File {
+public:
+	/** \brief Opens the file at \p path with the MPI_MODE_* flags of \p mode, like
+  MPI_MODE_CREATE | MPI_MODE_WRONLY. Collective on \p communicator. */
+	File(const Communicator& communicator, const std::string& path, int mode = MPI_MODE_RDONLY)
+	: value(MPI_FILE_NULL)
+	{
+		handleError(MPI_File_open(communicator.get(),path.c_str(),mode,MPI_INFO_NULL,&value));
+	}
+	/** \brief Closes the file with the collective MPI_File_close, if MPI is not finalized yet. The nonblocking
+  operations must be completed before. */
+	~File() {
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+		if(value == MPI_FILE_NULL or finalized) return;
+		int error = MPI_File_close(&value);
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Ignore MPI_File_close error in release
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	File(const File&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	File(File&& rhs): value(rhs.value) {
+		rhs.value = MPI_FILE_NULL;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	File& operator=(const File&) = delete;
+	/** \brief Can't be assigned, since closing the file is collective. **/
+	File& operator=(File&&) = delete;
+
+	/** \brief Returns the MPI implementation. Minimize its use. */
+	MPI_File get() const {
+		return value;
+	}
+	/** \brief Returns the size of the file, in bytes. */
+	MPI_Offset size() const {
+		MPI_Offset result = 0;
+		handleError(MPI_File_get_size(value,&result));
+		return result;
+	}
+
+	/** \brief Truncates or extends the file to \p size bytes. Collective. */
+	void resize(MPI_Offset size) {
+		handleError(MPI_File_set_size(value,size));
+	}
+	/** \brief Sets the view of this process to the elements of \p Type that start at the \p displacement, in
+  bytes. Collective, but each process can give a different \p displacement. */
+	template<class Type>
+	void setView(MPI_Offset displacement) {
+		static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be written.");
+		handleError(MPI_File_set_view(value,displacement,mpi_datatype<Type>::get(),mpi_datatype<Type>::get(),
+			"native",MPI_INFO_NULL));
+	}
+	/** \brief Sets the view of this process to the elements of the \p layout, repeated from the \p displacement, in
+  bytes. The address of the \p layout is not used, only its datatype. Collective. */
+	template<class Type>
+	void setView(MPI_Offset displacement, StridedView<Type> layout) {
+		using Element = typename std::remove_const<Type>::type;
+		static_assert(is_trivially_communicable<Element>::value, "Only trivially copyable types can be written.");
+		handleError(MPI_File_set_view(value,displacement,mpi_datatype<Element>::get(),layout.datatype(),"native",
+			MPI_INFO_NULL));
+	}
+	/** \brief Sets the view of this process to its block of \p subshape elements, that starts at \p start, of the
+  row-major array of \p shape elements stored from the \p displacement, in bytes, like the part of a global grid
+  owned by this process. Collective. */
+	template<class Type>
+	void setSubarrayView(MPI_Offset displacement, const std::vector<int>& shape, const std::vector<int>& subshape,
+		const std::vector<int>& start)
+	{
+		setView(displacement,subarrayView(static_cast<const Type*>(nullptr),shape,subshape,start));
+	}
+	/** \brief Transfers the data written by this process to the storage device. Collective. Together with a
+  barrier, makes the data written by a process visible to the reads of the other processes. */
+	void sync() {
+		handleError(MPI_File_sync(value));
+	}
+
+	/** \brief Starts to read \p count elements at the \p offset, on every process. Returns a ReceiveRequest that
+  owns the elements. The elements after the end of the file are not read. Collective. */
+	template<class Type>
+	ReceiveRequest<std::vector<Type>> asyncReadAtAll(MPI_Offset offset, std::size_t count) {
+		static_assert(is_trivially_communicable<Type>::value, "Only trivially copyable types can be read.");
+		ReceiveRequest<std::vector<Type>> r(count);
+		r.cancellable = false;
+		handleError(LargeCount::asyncReadAtAll(value,offset,r.data->data(),count,mpi_datatype<Type>::get(),
+			&r.value));
+		return r;
+	}
+	/** \brief Starts to write the \p data at the \p offset, on every process, to overlap a checkpoint with the
+  computation. Returns a SendRequest that owns the \p data. Collective. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value and
+			!is_span<typename std::decay<Collection>::type>::value,bool>::type = true
+	>
+	SendRequest asyncWriteAtAll(MPI_Offset offset, Collection&& data) {
+		using Owned = typename std::decay<Collection>::type;
+		using Type = typename Owned::value_type;
+		const auto owned = std::make_shared<Owned>(std::forward<Collection>(data));
+		MPI_Request x;
+		handleError(LargeCount::asyncWriteAtAll(value,offset,owned->data(),owned->size(),mpi_datatype<Type>::get(),
+			&x));
+		return SendRequest(x,owned);
+	}
+	/** \brief Starts to write the \p data at the \p offset, on every process, without copying them: they must stay
+  alive until the request completes. Collective. */
+	template<class Type>
+	SendRequest asyncWriteAtAll(MPI_Offset offset, Span<Type> data) {
+		using Element = typename std::remove_const<Type>::type;
+		static_assert(is_trivially_communicable<Element>::value, "Only trivially copyable types can be written.");
+		MPI_Request x;
+		handleError(LargeCount::asyncWriteAtAll(value,offset,data.data(),data.size(),mpi_datatype<Element>::get(),
+			&x));
+		return SendRequest(x);
+	}
+	/** \brief Reads the elements at the \p offset in \p result. Returns the number of elements read, which is
+  smaller than the size of \p result at the end of the file. */
+	template<class Type>
+	std::size_t readAt(MPI_Offset offset, Span<Type> result) {
+		MPI_Status status;
+		handleError(LargeCount::readAt(value,offset,result.data(),result.size(),mpi_datatype<Type>::get(),&status));
+		return countRead<Type>(status);
+	}
+	/** \brief Same as readAt(), on every process. Collective. At the end of the file, some implementations count
+  the elements requested instead of the elements read. */
+	template<class Type>
+	std::size_t readAtAll(MPI_Offset offset, Span<Type> result) {
+		MPI_Status status;
+		handleError(LargeCount::readAtAll(value,offset,result.data(),result.size(),mpi_datatype<Type>::get(),
+			&status));
+		return countRead<Type>(status);
+	}
+	/** \brief Returns at most \p count elements read at the \p offset, on every process. Collective. */
+	template<class Type>
+	std::vector<Type> readAtAll(MPI_Offset offset, std::size_t count) {
+		std::vector<Type> result(count);
+		result.resize(readAtAll(offset,makeSpan(result)));
+		return result;
+	}
+	/** \brief Writes the \p data at the \p offset. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	void writeAt(MPI_Offset offset, const Collection& data) {
+		using Type = typename Collection::value_type;
+		handleError(LargeCount::writeAt(value,offset,data.data(),data.size(),mpi_datatype<Type>::get(),
+			MPI_STATUS_IGNORE));
+	}
+	/** \brief Writes the \p data at the \p offset, on every process. Collective. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	void writeAtAll(MPI_Offset offset, const Collection& data) {
+		using Type = typename Collection::value_type;
+		handleError(LargeCount::writeAtAll(value,offset,data.data(),data.size(),mpi_datatype<Type>::get(),
+			MPI_STATUS_IGNORE));
+	}
+	/** \brief Writes the \p data of every process one after the other, in the order of the ranks, from the shared
+  file pointer, so that processes don't need to know the sizes of the others. Collective. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	void writeOrdered(const Collection& data) {
+		using Type = typename Collection::value_type;
+		handleError(LargeCount::writeOrdered(value,data.data(),data.size(),mpi_datatype<Type>::get(),
+			MPI_STATUS_IGNORE));
+	}
+
+private:
+	/** \brief Returns the number of elements of \p Type read by the operation of \p status. */
+	template<class Type>
+	static std::size_t countRead(const MPI_Status& status) {
+		std::size_t count = 0;
+		handleError(LargeCount::getCount(status,mpi_datatype<Type>::get(),&count));
+		return count;
+	}
+
+	/** \brief MPI implementation. */
+	MPI_File value;
+};
+
+} // NiceMPi
+
+#endif  /* FILE_H */
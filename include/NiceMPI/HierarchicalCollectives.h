@@ -0,0 +1,190 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef HIERARCHICALCOLLECTIVES_H
+#define HIERARCHICALCOLLECTIVES_H
+
+#include <algorithm> // std::copy, std::sort
+#include <cstddef> // std::size_t
+#include <functional> // std::plus
+#include <numeric> // std::iota
+#include <type_traits> // std::enable_if
+#include <utility> // std::move
+#include <vector>
+#include <NiceMPI/MPIoperator.h> // mpi_operator
+#include <NiceMPI/NiceMPI.h> // Communicator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Span.h> // makeSpan
+
+namespace NiceMPI {
+
+/** \brief Node-aware collectives on a communicator: the data are first combined inside each node, the collective
+  runs only among the node leaders, and its result is then broadcast inside each node. Faster than the flat
+  collectives of Communicator when the interconnect is slow compared to the shared memory of fat nodes. The
+  collectives of less than threshold bytes, and the reductions with a non-commutative operator, use the flat
+  collectives. Every process must call the collectives in the same order, as with Communicator. */
+class HierarchicalCollectives {
+public:
+	/** \brief Prepares the hierarchical collectives on \p communicator, with the nodes given by splitShared().
+  Collective. */
+	explicit HierarchicalCollectives(const Communicator& communicator, std::size_t threshold = 0)
+	: HierarchicalCollectives(communicator,communicator.splitShared(),threshold)
+	{}
+	/** \brief Prepares the hierarchical collectives on \p communicator, with the groups of processes given by \p
+  node instead of the nodes, which must be a split of \p communicator. Collective. */
+	HierarchicalCollectives(const Communicator& communicator, Communicator node, std::size_t threshold)
+	: flat(communicator.shared()), node(std::move(node)),
+		leaders(communicator.split(this->node.rank() == 0 ? 0 : MPI_UNDEFINED,communicator.rank())),
+		threshold(threshold)
+	{
+		nodeRanks = flat.allGather(this->node.rank());
+		leaderRanks = flat.allGather(this->node.broadcast(0,leaders.rank()));
+		order.resize(nodeRanks.size());
+		std::iota(order.begin(),order.end(),0);
+		std::sort(order.begin(),order.end(),[this](int a, int b) {
+			return leaderRanks[a] != leaderRanks[b] ? leaderRanks[a] < leaderRanks[b] : nodeRanks[a] < nodeRanks[b];
+		});
+		nodeSizes.assign(static_cast<std::size_t>(leaderRanks[order.back()] + 1),0);
+		for(int x: leaderRanks) ++nodeSizes[x];
+	}
+
+	/** \brief Regroups the \p data of every processes in a single vector and returns it, ordered by rank. */
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	std::vector<Type> allGather(Type data) {
+		return allGather(std::vector<Type>(1,data));
+	}
+	/** \brief Regroups the \p data of every processes in a single vector and returns it, ordered by rank. \p data
+  contains the same number of elements for each process. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	std::vector<typename Collection::value_type> allGather(const Collection& data) {
+		using Type = typename Collection::value_type;
+		const std::size_t count = data.size();
+		if(!isHierarchical(sizeof(Type)*count*nodeRanks.size())) return flat.allGather(data);
+
+		const std::vector<Type> nodeData = node.gather(0,data);
+		std::vector<Type> gathered(count*nodeRanks.size());
+		if(isLeader()) {
+			std::vector<int> counts(nodeSizes.size());
+			for(std::size_t i = 0; i < counts.size(); ++i) counts[i] = static_cast<int>(count*nodeSizes[i]);
+			leaders.varyingAllGather(nodeData,makeSpan(gathered),counts);
+		}
+		node.broadcast(0,makeSpan(gathered));
+
+		std::vector<Type> result(gathered.size());
+		for(std::size_t i = 0; i < order.size(); ++i) {
+			std::copy(gathered.begin() + i*count,gathered.begin() + (i+1)*count,result.begin() + order[i]*count);
+		}
+		return result;
+	}
+	/** \brief Combines the \p data of every processes with the operator \p op and returns the result to every
+  processes. */
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type allReduce(Type data, Operator op = Operator{}) {
+		if(!isHierarchical(sizeof(Type)) or !isCommutative<Type>(op)) return flat.allReduce(data,op);
+		Type partial = node.reduce(0,data,op);
+		if(isLeader()) partial = leaders.allReduce(partial,op);
+		return node.broadcast(0,partial);
+	}
+	/** \brief Combines element-wise the \p data of every processes with the operator \p op and returns the result
+  to every processes. */
+	template<class Collection, class Operator = std::plus<typename Collection::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Collection allReduce(const Collection& data, Operator op = Operator{}) {
+		using Type = typename Collection::value_type;
+		if(!isHierarchical(sizeof(Type)*data.size()) or !isCommutative<Type>(op)) return flat.allReduce(data,op);
+		Collection partial = node.reduce(0,data,op);
+		if(isLeader()) partial = leaders.allReduce(partial,op);
+		return node.broadcast(0,partial);
+	}
+	/** \brief The \p source broadcast its \p data to every processes. */
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type broadcast(int source, Type data) {
+		if(!isHierarchical(sizeof(Type))) return flat.broadcast(source,data);
+		broadcastInNodes(source,makeSpan(&data,1));
+		return data;
+	}
+	/** \brief The \p source broadcast its \p data to every processes. The number of elements is broadcast first,
+  so that the same algorithm is chosen by every processes. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> broadcast(int source, std::vector<Type> data) {
+		data.resize(flat.broadcast(source,data.size()));
+		if(!isHierarchical(sizeof(Type)*data.size())) flat.broadcast(source,makeSpan(data));
+		else broadcastInNodes(source,makeSpan(data));
+		return data;
+	}
+
+private:
+	/** \brief Broadcasts \p data from \p source inside its node, then among the leaders, and then inside the other
+  nodes. Every processes must provide the same number of elements. */
+	template<typename Type>
+	void broadcastInNodes(int source, Span<Type> data) {
+		const bool isSourceNode = leaderRanks[source] == leaderRanks[flat.rank()];
+		if(isSourceNode and nodeRanks[source] != 0) node.broadcast(nodeRanks[source],data);
+		if(isLeader()) leaders.broadcast(leaderRanks[source],data);
+		if(!isSourceNode or nodeRanks[source] == 0) node.broadcast(0,data);
+	}
+	/** \brief Returns true if \p op is commutative, so that the data can be combined in any order. */
+	template<typename Type, class Operator>
+	static bool isCommutative(const Operator& op) {
+		int commutative = 0;
+		handleError(MPI_Op_commutative(mpi_operator<Operator,Type>::get(op),&commutative));
+		return commutative != 0;
+	}
+	/** \brief Returns true if the hierarchical algorithm is used for \p bytes. */
+	bool isHierarchical(std::size_t bytes) const {
+		return bytes >= threshold;
+	}
+	/** \brief Returns true if this process is the leader of its node. */
+	bool isLeader() const {
+		return leaders.get() != MPI_COMM_NULL;
+	}
+
+	/** \brief Communicator on which the collectives are made. */
+	Communicator flat;
+	/** \brief Processes of the node of this process. */
+	Communicator node;
+	/** \brief Leaders of the nodes. Null on the other processes. */
+	Communicator leaders;
+	/** \brief Number of bytes from which the hierarchical algorithms are used. */
+	std::size_t threshold;
+	/** \brief Rank in its node of each process. */
+	std::vector<int> nodeRanks;
+	/** \brief Rank among the leaders of the leader of the node of each process. */
+	std::vector<int> leaderRanks;
+	/** \brief Ranks of the processes, ordered by node, and by rank in the node. */
+	std::vector<int> order;
+	/** \brief Number of processes of each node, ordered like the leaders. */
+	std::vector<int> nodeSizes;
+};
+
+} // NiceMPi
+
+#endif  /* HIERARCHICALCOLLECTIVES_H */
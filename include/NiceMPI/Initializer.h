@@ -23,8 +23,13 @@ SOFTWARE. */
 #ifndef INITIALIZER_H
 #define INITIALIZER_H
 
-#include <mpi.h> // MPI_Init
+#include <chrono> // std::chrono::microseconds
+#include <mpi.h> // MPI_Init, MPI_Init_thread
+#include <NiceMPI/MemoryPool.h> // MemoryPool
 #include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Profiler.h> // Profiler
+#include <NiceMPI/ProgressEngine.h> // ProgressEngine
+#include <NiceMPI/private/DetachedRequests.h> // DetachedRequests
 
 namespace NiceMPI {
 
@@ -34,9 +39,21 @@ struct Initializer {
 	/** \brief Initializes MPI. */
 	Initializer(int argc, char* argv[]) {
 		handleError(MPI_Init(&argc, &argv));
+		handleError(MPI_Query_thread(&provided));
 	}
-	/** \brief Finalizes MPI. */
+	/** \brief Initializes MPI with the \p requiredThreadLevel: MPI_THREAD_SINGLE, MPI_THREAD_FUNNELED,
+  MPI_THREAD_SERIALIZED or MPI_THREAD_MULTIPLE. The MPI implementation may provide a lower level, given by
+  providedThreadLevel(). */
+	Initializer(int argc, char* argv[], int requiredThreadLevel) {
+		handleError(MPI_Init_thread(&argc, &argv, requiredThreadLevel, &provided));
+	}
+	/** \brief Completes the requests destroyed before their completion, and the requests handed over to
+  ProgressEngine, writes the files of the Profiler, frees the memory cached by MemoryPool, and finalizes MPI. */
 	~Initializer() {
+		ProgressEngine::finishAll();
+		DetachedRequests::completeAll();
+		Profiler::finish();
+		MemoryPool::release();
 		MPI_Finalize(); // Never fails (with MPICH implementation)
 	}
 	/** \brief Can't copy, or MPI_Finalize will be called twice. */
@@ -47,6 +64,20 @@ struct Initializer {
 	Initializer& operator=(const Initializer&) = delete;
 	/** \brief Can be moved. */
 	Initializer& operator=(Initializer&&) = default;
+
+	/** \brief Returns the thread level provided by the MPI implementation. */
+	int providedThreadLevel() const {
+		return provided;
+	}
+	/** \brief Starts the background thread of ProgressEngine, which polls every \p interval. Requires
+  MPI_THREAD_MULTIPLE. The thread is stopped before MPI is finalized. */
+	void startProgressThread(std::chrono::microseconds interval = std::chrono::microseconds{50}) const {
+		ProgressEngine::startThread(interval);
+	}
+
+private:
+	/** \brief Thread level provided by the MPI implementation. */
+	int provided;
 };
 
 } // NiceMPi
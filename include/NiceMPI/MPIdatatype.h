@@ -0,0 +1,89 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef MPIDATATYPE_H
+#define MPIDATATYPE_H
+
+#include <complex>
+#include <mpi.h> // MPI_Datatype
+#include <NiceMPI/NiceMPIexception.h> // handleError
+
+namespace NiceMPI {
+
+/** \brief Type traits that returns the MPI_Datatype used to communicate \p Type. Arithmetic types and std::complex
+  are mapped at compile time on their MPI predefined datatype. By default, other types are communicated as a
+  committed contiguous datatype of sizeof(Type) bytes, created once per type. */
+template<class Type, class Enable = void>
+struct mpi_datatype {
+	/** \brief True if the datatype is predefined by MPI, so that MPI predefined operations can be applied on it. */
+	static constexpr bool isNative = false;
+	/** \brief Returns the MPI_Datatype of \p Type. */
+	static MPI_Datatype get() {
+		static const MPI_Datatype datatype = createContiguousBytes();
+		return datatype;
+	}
+
+private:
+	/** \brief Creates and commits a datatype that contains sizeof(Type) bytes. */
+	static MPI_Datatype createContiguousBytes() {
+		MPI_Datatype datatype;
+		handleError(MPI_Type_contiguous(sizeof(Type),MPI_BYTE,&datatype));
+		handleError(MPI_Type_commit(&datatype));
+		return datatype;
+	}
+};
+
+/** \brief Defines the specialization of mpi_datatype for the \p Type predefined by MPI as \p mpiDatatype. */
+#define NICEMPI_NATIVE_DATATYPE(Type, mpiDatatype) \
+	template<> \
+	struct mpi_datatype<Type> { \
+		static constexpr bool isNative = true; \
+		static MPI_Datatype get() { \
+			return mpiDatatype; \
+		} \
+	};
+
+NICEMPI_NATIVE_DATATYPE(char, MPI_CHAR)
+NICEMPI_NATIVE_DATATYPE(signed char, MPI_SIGNED_CHAR)
+NICEMPI_NATIVE_DATATYPE(unsigned char, MPI_UNSIGNED_CHAR)
+NICEMPI_NATIVE_DATATYPE(wchar_t, MPI_WCHAR)
+NICEMPI_NATIVE_DATATYPE(short, MPI_SHORT)
+NICEMPI_NATIVE_DATATYPE(unsigned short, MPI_UNSIGNED_SHORT)
+NICEMPI_NATIVE_DATATYPE(int, MPI_INT)
+NICEMPI_NATIVE_DATATYPE(unsigned, MPI_UNSIGNED)
+NICEMPI_NATIVE_DATATYPE(long, MPI_LONG)
+NICEMPI_NATIVE_DATATYPE(unsigned long, MPI_UNSIGNED_LONG)
+NICEMPI_NATIVE_DATATYPE(long long, MPI_LONG_LONG)
+NICEMPI_NATIVE_DATATYPE(unsigned long long, MPI_UNSIGNED_LONG_LONG)
+NICEMPI_NATIVE_DATATYPE(float, MPI_FLOAT)
+NICEMPI_NATIVE_DATATYPE(double, MPI_DOUBLE)
+NICEMPI_NATIVE_DATATYPE(long double, MPI_LONG_DOUBLE)
+NICEMPI_NATIVE_DATATYPE(bool, MPI_CXX_BOOL)
+NICEMPI_NATIVE_DATATYPE(std::complex<float>, MPI_CXX_FLOAT_COMPLEX)
+NICEMPI_NATIVE_DATATYPE(std::complex<double>, MPI_CXX_DOUBLE_COMPLEX)
+NICEMPI_NATIVE_DATATYPE(std::complex<long double>, MPI_CXX_LONG_DOUBLE_COMPLEX)
+
+#undef NICEMPI_NATIVE_DATATYPE
+
+} // NiceMPi
+
+#endif  /* MPIDATATYPE_H */
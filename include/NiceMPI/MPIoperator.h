@@ -0,0 +1,160 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef MPIOPERATOR_H
+#define MPIOPERATOR_H
+
+#include <complex>
+#include <functional> // std::plus, std::multiplies, std::logical_and, ...
+#include <type_traits> // std::enable_if, std::is_integral, std::is_same
+#include <mpi.h> // MPI_Op
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/NiceMPIexception.h> // handleError
+
+namespace NiceMPI {
+
+/** \brief Returns the maximum of two values. Mapped to MPI_MAX for the integer and floating point types. */
+template<class Type>
+struct Maximum {
+	/** \brief Returns the maximum of \p a and \p b. */
+	Type operator()(const Type& a, const Type& b) const {
+		return a < b ? b : a;
+	}
+};
+
+/** \brief Returns the minimum of two values. Mapped to MPI_MIN for the integer and floating point types. */
+template<class Type>
+struct Minimum {
+	/** \brief Returns the minimum of \p a and \p b. */
+	Type operator()(const Type& a, const Type& b) const {
+		return b < a ? b : a;
+	}
+};
+
+
+
+/** \brief Type traits that is true for the C integer types of MPI, on which every predefined operator can be
+  applied. The characters and bool have their own MPI datatypes, on which the arithmetic operators are not
+  defined. */
+template<class Type>
+struct is_mpi_integer {
+	static constexpr bool value = std::is_integral<Type>::value and !std::is_same<Type,bool>::value and
+		!std::is_same<Type,char>::value and !std::is_same<Type,wchar_t>::value;
+};
+/** \brief Type traits that is true for the types on which MPI_MAX and MPI_MIN can be applied. */
+template<class Type>
+struct is_integer_or_floating_point {
+	static constexpr bool value = is_mpi_integer<Type>::value or std::is_floating_point<Type>::value;
+};
+/** \brief Type traits that is true for the types on which MPI_LAND and MPI_LOR can be applied. */
+template<class Type>
+struct is_integer_or_bool {
+	static constexpr bool value = is_mpi_integer<Type>::value or std::is_same<Type,bool>::value;
+};
+/** \brief Type traits that is true for the types on which MPI_SUM and MPI_PROD can be applied. */
+template<class Type>
+struct is_arithmetic_or_complex {
+	static constexpr bool value = is_integer_or_floating_point<Type>::value;
+};
+/** \brief Type traits that is true for the types on which MPI_SUM and MPI_PROD can be applied. *Specialization*. */
+template<class Type>
+struct is_arithmetic_or_complex<std::complex<Type>> {
+	static constexpr bool value = true;
+};
+
+
+
+/** \brief Type traits that tells MPI if a user-defined \p Operator is commutative. Specialize it to allow MPI to
+  combine the data in any order. Operators are assumed non-commutative by default. */
+template<class Operator>
+struct is_commutative {
+	static constexpr bool value = false;
+};
+
+
+
+/** \brief Type traits that returns the MPI_Op that applies \p Operator on \p Type. By default, a user-defined
+  MPI_Op is created once for each \p Type and \p Operator pair. Hence, \p Operator must be default constructible
+  and stateless. */
+template<class Operator, class Type, class Enable = void>
+struct mpi_operator {
+	/** \brief Returns the MPI_Op that applies \p Operator. */
+	static MPI_Op get(const Operator&) {
+		static const MPI_Op op = create();
+		return op;
+	}
+
+private:
+	/** \brief Applies \p Operator element-wise, as required by MPI_Op_create. */
+	static void apply(void* in, void* inout, int* length, MPI_Datatype*) {
+		const Type* lhs = static_cast<const Type*>(in);
+		Type* result = static_cast<Type*>(inout);
+		const Operator op{};
+		for(int i = 0; i < *length; ++i) result[i] = op(lhs[i],result[i]);
+	}
+	/** \brief Creates the user-defined MPI_Op. */
+	static MPI_Op create() {
+		static_assert(std::is_default_constructible<Operator>::value,
+			"User-defined operators must be default constructible.");
+		MPI_Op op;
+		handleError(MPI_Op_create(&apply,is_commutative<Operator>::value,&op));
+		return op;
+	}
+};
+
+/** \brief Type traits that returns the MPI_Op that applies \p Operator on \p Type. *Specialization* for MPI_Op
+  provided directly by the user. */
+template<class Type>
+struct mpi_operator<MPI_Op,Type> {
+	/** \brief Returns \p op. */
+	static MPI_Op get(MPI_Op op) {
+		return op;
+	}
+};
+
+/** \brief Defines the specialization of mpi_operator that maps \p Functor on the MPI predefined \p mpiOp, for the
+  types that satisfy \p Condition. */
+#define NICEMPI_PREDEFINED_OPERATOR(Functor, Condition, mpiOp) \
+	template<class Type> \
+	struct mpi_operator<Functor<Type>,Type, \
+		typename std::enable_if<mpi_datatype<Type>::isNative and Condition<Type>::value>::type> \
+	{ \
+		static MPI_Op get(const Functor<Type>&) { \
+			return mpiOp; \
+		} \
+	};
+
+NICEMPI_PREDEFINED_OPERATOR(std::plus, is_arithmetic_or_complex, MPI_SUM)
+NICEMPI_PREDEFINED_OPERATOR(std::multiplies, is_arithmetic_or_complex, MPI_PROD)
+NICEMPI_PREDEFINED_OPERATOR(Maximum, is_integer_or_floating_point, MPI_MAX)
+NICEMPI_PREDEFINED_OPERATOR(Minimum, is_integer_or_floating_point, MPI_MIN)
+NICEMPI_PREDEFINED_OPERATOR(std::logical_and, is_integer_or_bool, MPI_LAND)
+NICEMPI_PREDEFINED_OPERATOR(std::logical_or, is_integer_or_bool, MPI_LOR)
+NICEMPI_PREDEFINED_OPERATOR(std::bit_and, is_mpi_integer, MPI_BAND)
+NICEMPI_PREDEFINED_OPERATOR(std::bit_or, is_mpi_integer, MPI_BOR)
+NICEMPI_PREDEFINED_OPERATOR(std::bit_xor, is_mpi_integer, MPI_BXOR)
+
+#undef NICEMPI_PREDEFINED_OPERATOR
+
+} // NiceMPi
+
+#endif  /* MPIOPERATOR_H */
@@ -0,0 +1,114 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef MEMORYPOOL_H
+#define MEMORYPOOL_H
+
+#include <cstddef> // std::size_t
+#include <vector>
+
+namespace NiceMPI {
+
+/** \brief Memory from which MemoryPool allocates. */
+enum class MemoryKind {
+	/** \brief Memory of the C++ free store. */
+	host,
+	/** \brief Memory allocated by MPI_Alloc_mem, which can be registered with the network once for all. Requires
+  MPI to be initialized. */
+	mpi,
+	/** \brief Memory mapped on huge pages when the system has them, or on pages advised to become huge, so that
+  the network registers fewer pages. */
+	hugePages,
+#if defined(NICEMPI_CUDA) || defined(NICEMPI_HIP)
+	/** \brief Memory of the GPU, for a GPU-aware MPI. It can't be accessed from the host, so it is only used
+  through raw buffers, not as the memory of vectors whose elements are constructed. */
+	device,
+#endif
+};
+
+/** \brief Cache of memory blocks, reused from one allocation to the next instead of being returned to the system.
+  The blocks stay mapped and registered with the network, so that the hot loops that receive the same sizes
+  again and again do not pay for the registration. Blocks are sized in powers of two, and they are cached per
+  MemoryKind. */
+class MemoryPool {
+public:
+	/** \brief Returns a block of at least \p bytes bytes of the memory \p kind, reused from the cache if possible.
+  Throws std::bad_alloc if the memory can't be allocated. */
+	static void* allocate(std::size_t bytes, MemoryKind kind);
+	/** \brief Returns the number of bytes in the blocks that are cached, so not in use. */
+	static std::size_t cachedBytes();
+	/** \brief Gives back to the cache the block \p data, allocated for \p bytes bytes of the memory \p kind. */
+	static void deallocate(void* data, std::size_t bytes, MemoryKind kind);
+	/** \brief Frees the blocks that are cached. Called before MPI is finalized, since MPI_Free_mem can't be
+  called later. */
+	static void release();
+};
+
+
+
+/** \brief Allocator of elements of type \p Type in the MemoryPool, from the memory \p kind. */
+template<class Type, MemoryKind kind = MemoryKind::mpi>
+class PoolAllocator {
+public:
+	/** \brief Type of the elements allocated. */
+	using value_type = Type;
+	/** \brief Type traits that defines the PoolAllocator of elements of type \p Other. */
+	template<class Other>
+	struct rebind {
+		using other = PoolAllocator<Other,kind>;
+	};
+
+	/** \brief Every pool allocators share the MemoryPool. */
+	PoolAllocator() = default;
+	/** \brief Every pool allocators share the MemoryPool. */
+	template<class Other>
+	PoolAllocator(const PoolAllocator<Other,kind>&)
+	{}
+
+	/** \brief Returns the memory of \p count elements. */
+	Type* allocate(std::size_t count) {
+		return static_cast<Type*>(MemoryPool::allocate(count*sizeof(Type),kind));
+	}
+	/** \brief Gives back the memory of the \p count elements at \p data. */
+	void deallocate(Type* data, std::size_t count) {
+		MemoryPool::deallocate(data,count*sizeof(Type),kind);
+	}
+};
+
+/** \brief Every pool allocators of the same memory share the MemoryPool, so they are equal. */
+template<class Type, class Other, MemoryKind kind>
+bool operator==(const PoolAllocator<Type,kind>&, const PoolAllocator<Other,kind>&) {
+	return true;
+}
+/** \brief Every pool allocators of the same memory share the MemoryPool, so they are equal. */
+template<class Type, class Other, MemoryKind kind>
+bool operator!=(const PoolAllocator<Type,kind>&, const PoolAllocator<Other,kind>&) {
+	return false;
+}
+
+/** \brief Vector whose memory is allocated by MPI_Alloc_mem and reused through the MemoryPool. It can be used as
+  the collection received, so that its memory stays registered from one iteration to the next. */
+template<class Type>
+using PooledVector = std::vector<Type,PoolAllocator<Type>>;
+
+} // NiceMPi
+
+#endif  /* MEMORYPOOL_H */
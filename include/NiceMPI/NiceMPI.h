@@ -23,16 +23,35 @@ SOFTWARE. */
 #ifndef NICEMPI_H
 #define NICEMPI_H
 
+#include <algorithm> // std::max, std::min
 #include <array>
+#include <cassert>
 #include <cstddef> // std::size_t
-#include <memory> // unique_ptr
-#include <type_traits> // std::is_pod, std::enable_if
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcpy
+#include <deque>
+#include <functional> // std::plus, std::function
+#include <memory> // std::shared_ptr
+#include <type_traits> // std::is_trivially_copyable, std::enable_if
+#include <typeinfo> // std::type_info
 #include <utility> // std::move
 #include <vector>
 #include <mpi.h> // MPI_Comm
+#include <NiceMPI/DefaultInitAllocator.h> // for convenience
+#include <NiceMPI/DeviceSpan.h> // DeviceSpan
 #include <NiceMPI/Initializer.h> // for convenience
+#include <NiceMPI/MemoryPool.h> // for convenience
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/MPIoperator.h> // mpi_operator
 #include <NiceMPI/NiceMPIexception.h> // for convenience
+#include <NiceMPI/Profiler.h> // NICEMPI_PROFILE
+#include <NiceMPI/ProgressEngine.h> // ProgressEngine
+#include <NiceMPI/Serializer.h> // Serializer
+#include <NiceMPI/Span.h> // Span
+#include <NiceMPI/StridedView.h> // StridedView
+#include "private/DetachedRequests.h"
 #include "private/MPIcommunicatorHandle.h"
+#include "private/OrderedBroadcasts.h"
 
 #define UNUSED(x) ((void)x)
 
@@ -47,13 +66,14 @@ Communicator createProxy(MPI_Comm mpiCommunicator); // Forward declaration
 
 
 
-/** \brief std::array that contains PODs are both POD and collection, so we need to distinguish them. */
+/** \brief std::array that contains trivially copyable elements are both trivially communicable and collection,
+  so we need to distinguish them. */
 template<class T>
 struct is_std_array {
 	static constexpr bool value = false;
 };
-/** \brief std::array that contains PODs are both POD and collection, so we need to distinguish them.
-  *Specialization*.*/
+/** \brief std::array that contains trivially copyable elements are both trivially communicable and collection,
+  so we need to distinguish them. *Specialization*.*/
 template<class T, std::size_t N>
 struct is_std_array<std::array<T,N>> {
 	static constexpr bool value = true;
@@ -61,6 +81,18 @@ struct is_std_array<std::array<T,N>> {
 
 
 
+/** \brief True if \p T is communicated as its bytes: it is trivially copyable, which includes the types with
+  default member initializers or user-provided constructors, it is copy assignable, so that it can be received
+  over, unlike the elements of a std::map, and it is not a view, which is communicated as the elements it refers
+  to. */
+template<class T>
+struct is_trivially_communicable {
+	static constexpr bool value = std::is_trivially_copyable<T>::value and std::is_copy_assignable<T>::value and
+		!is_span<T>::value and !is_strided_view<T>::value and !is_device_span<T>::value;
+};
+
+
+
 /** \brief Type traits that defines an alias for the type contained in a container. Usefull in ReceiveRequest.
   *Specialization*.*/
 template<class T>
@@ -84,74 +116,652 @@ struct to_contained_type<std::array<T,N>> {
 template<class T>
 using to_contained_type_t = typename to_contained_type<T>::type;
 
+/** \brief Type traits that defines the vector in which a ReceiveRequest receives data of type \p T. A vector keeps
+  its allocator, so that the requests of a pooled or uninitialized vector allocate with it. */
+template<class T>
+struct to_receive_buffer {
+	using type = std::vector<to_contained_type_t<T>>;
+};
+/** \brief Type traits that defines the vector in which a ReceiveRequest receives data of type \p T.
+  *Specialization*.*/
+template<class T, class Allocator>
+struct to_receive_buffer<std::vector<T,Allocator>> {
+	using type = std::vector<T,Allocator>;
+};
+/** \brief Type traits that defines the vector in which a ReceiveRequest receives data of type \p T. *Alias*.*/
+template<class T>
+using to_receive_buffer_t = typename to_receive_buffer<T>::type;
+
 
 
-/** \brief Returns after an asyncSend call, this object allows to control the status of the call. */
+/** \brief Returns after an asyncSend call, this object allows to control the status of the call. It owns the
+  data sent, unless they were borrowed through a Span. If it is destroyed before the data are sent, the send
+  operation continues in the background and the data are kept alive until it completes. It also reports the
+  completion of the receives in borrowed data, which are cancellable, so that a receive that is never matched
+  doesn't stop the finalization. */
 class SendRequest {
 public:
-	/** \brief Initializes this request with its MPI implementation. */
-	SendRequest(MPI_Request value): value(value)
+	/** \brief Initializes this request with its MPI implementation, the \p payload that must stay alive until
+  the operation completes, and true if it is a \p cancellable receive. */
+	SendRequest(MPI_Request value, std::shared_ptr<void> payload = nullptr, bool cancellable = false)
+	: value(value), payload(std::move(payload)), cancellable(cancellable)
 	{}
+	/** \brief Detaches the send operation if it is not completed. */
+	~SendRequest() {
+		detach();
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	SendRequest(const SendRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	SendRequest(SendRequest&& rhs): value(rhs.value), payload(std::move(rhs.payload)), cancellable(rhs.cancellable) {
+		rhs.value = MPI_REQUEST_NULL;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	SendRequest& operator=(const SendRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. The operation of \p this is
+  detached if it is not completed. **/
+	SendRequest& operator=(SendRequest&& rhs) {
+		if(this == &rhs) return *this;
+		detach();
+		value = rhs.value;
+		payload = std::move(rhs.payload);
+		cancellable = rhs.cancellable;
+		rhs.value = MPI_REQUEST_NULL;
+		return *this;
+	}
+
 	/** \brief Returns true if the send operation is completed. */
 	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("SendRequest::isCompleted");
 		int flag = 0;
 		handleError(MPI_Test(&value, &flag, MPI_STATUS_IGNORE));
+		if(flag != 0) payload.reset();
 		return flag != 0;
 	}
 	/** \brief Waits for the data to be sent. */
 	void wait() {
+		NICEMPI_PROFILE_WAIT("SendRequest::wait");
 		handleError(MPI_Wait(&value,MPI_STATUS_IGNORE));
+		payload.reset();
+	}
+	/** \brief Hands the operation over to ProgressEngine, which calls \p continuation when the data are sent.
+  This request is then empty. */
+	void then(std::function<void()> continuation) {
+		std::shared_ptr<void> kept = std::move(payload);
+		MPI_Request handed = value;
+		value = MPI_REQUEST_NULL; // The continuation may destroy this request, before add returns
+		ProgressEngine::add(handed,[kept](MPI_Request&) { return true; },std::move(continuation),cancellable);
 	}
 
+	/** \brief RequestSet takes the MPI implementation and the payload of the requests added to it. */
+	friend class RequestSet;
+
 private:
+	/** \brief Gives the operation, if it is not completed, to DetachedRequests. */
+	void detach() {
+		DetachedRequests::add(value,std::move(payload),cancellable);
+		value = MPI_REQUEST_NULL;
+	}
+
 	/** \brief MPI implementation. */
 	MPI_Request value;
+	/** \brief Data sent, if they are owned by this request. */
+	std::shared_ptr<void> payload;
+	/** \brief True for a receive, which is cancelled if it is detached and never matched. */
+	bool cancellable;
 };
 
 
 
-/** \brief Returns after an asyncReceive call, this object allows to control the status of the call. */
+/** \brief Returns after an asyncReceive call or a nonblocking collective, this object allows to control the status
+  of the call, and owns the data received. A request can be made of many steps, like the size and then the data
+  of a broadcast: the next step is started when the previous one completes. If it is destroyed before the data are
+  received, a single step request is detached, and the memory of the data is kept alive until it completes, while
+  a request made of many steps is completed. */
 template<class Type>
 class ReceiveRequest {
 public:
-	/** \brief The function asyncReceive initializes the member of the request directly. */
-	ReceiveRequest(int count): data(count)
+	/** \brief Type of the data received. */
+	using Data = to_receive_buffer_t<Type>;
+	/** \brief Step of a request, that starts an operation in the given MPI implementation. Returns false if the
+  operation can't be started yet, in which case the step is tried again later. */
+	using Step = std::function<bool(MPI_Request&)>;
+
+	/** \brief The functions like asyncReceive initialize the members of the request directly. */
+	ReceiveRequest(std::size_t count)
+	: value(MPI_REQUEST_NULL), data(std::make_shared<Data>(count)), cancellable(true), status{}
 	{}
-	/** \brief Destroys the handle \p rhs. Only there because of the
-		[rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
-	~ReceiveRequest() = default;
-	/** \brief This object can only be moved, since the call to asyncReceive depends on the address of \p data. **/
+	/** \brief Detaches or completes the operation if it is not completed. The steps of the receive operations are
+  dropped, since they did not match any message yet. */
+	~ReceiveRequest() {
+		if(nextStep and !cancellable) wait();
+		if(value != MPI_REQUEST_NULL) DetachedRequests::add(value,bundle(),cancellable);
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
 	ReceiveRequest(const ReceiveRequest&) = delete;
-	/** \brief This object can only be moved, since the call to asyncReceive depends on the address of \p data. **/
-	ReceiveRequest(ReceiveRequest&&) = default;
-	/** \brief This object can only be moved, since the call to asyncReceive depends on the address of \p data. **/
+	/** \brief This object can only be moved, since it owns a MPI implementation. The address of the data does not
+  change. **/
+	ReceiveRequest(ReceiveRequest&& rhs)
+	: value(rhs.value), data(std::move(rhs.data)), payload(std::move(rhs.payload)),
+		nextStep(std::move(rhs.nextStep)), cancellable(rhs.cancellable), status(rhs.status)
+	{
+		rhs.value = MPI_REQUEST_NULL;
+		rhs.nextStep = nullptr;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
 	ReceiveRequest& operator=(const ReceiveRequest&) = delete;
-	/** \brief This object can only be moved, since the call to asyncReceive depends on the address of \p data. **/
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
 	ReceiveRequest& operator=(ReceiveRequest&&) = delete;
 
 	/** \brief Returns true if the receive operation is completed. */
 	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("ReceiveRequest::isCompleted");
+		while(true) {
+			if(value != MPI_REQUEST_NULL) {
+				int flag = 0;
+				handleError(MPI_Test(&value, &flag, &status));
+				if(flag == 0) return false;
+			}
+			if(!nextStep) return true;
+			if(!startNextStep()) return false;
+		}
+	}
+	/** \brief Waits for the data to be received. */
+	void wait() {
+		NICEMPI_PROFILE_WAIT("ReceiveRequest::wait");
+		while(true) {
+			if(value != MPI_REQUEST_NULL) handleError(MPI_Wait(&value,&status));
+			if(!nextStep) return;
+			startNextStep();
+		}
+	}
+	/** Returns the data, assuming that the user made sure that the receiving operation was completed. */
+	Data take() {
+		return std::move(*data);
+	}
+	/** \brief Returns the rank of the process that sent the data received by a point-to-point operation, assuming
+  that it was completed. Useful with MPI_ANY_SOURCE. */
+	int source() const {
+		return status.MPI_SOURCE;
+	}
+	/** \brief Returns the tag of the data received by a point-to-point operation, assuming that it was completed.
+  Useful with MPI_ANY_TAG. */
+	int tag() const {
+		return status.MPI_TAG;
+	}
+	/** \brief Hands the operation over to ProgressEngine, which starts its next steps and calls \p continuation
+  with the data when they are received. This request is then empty. */
+	void then(std::function<void(Data)> continuation) {
+		std::shared_ptr<Data> received = data;
+		std::shared_ptr<void> kept = payload;
+		Step step = std::move(nextStep);
+		nextStep = nullptr;
+		MPI_Request handed = value;
+		value = MPI_REQUEST_NULL; // The continuation may destroy this request, before add returns
+		ProgressEngine::add(handed,[kept,step](MPI_Request& request) mutable {
+			while(step) {
+				Step current = std::move(step);
+				step = nullptr;
+				if(!current(request)) {
+					step = std::move(current);
+					return false;
+				}
+				if(request != MPI_REQUEST_NULL) return false;
+			}
+			return true;
+		},[received,continuation]() { continuation(std::move(*received)); },cancellable);
+	}
+
+	/** \brief The functions like asyncReceive need the address of \p data. */
+	friend Communicator;
+	/** \brief The nonblocking reads of a File need the address of \p data. */
+	friend class File;
+	/** \brief RequestSet takes the MPI implementation and the data of the requests added to it. */
+	friend class RequestSet;
+
+private:
+	/** \brief Returns an object that keeps \p data and \p payload alive. */
+	std::shared_ptr<void> bundle() const {
+		return std::make_shared<std::array<std::shared_ptr<void>,2>>(std::array<std::shared_ptr<void>,2>{{
+			data, payload }});
+	}
+	/** \brief Starts the next step, which may set the step after it. Returns false if it must be tried again. */
+	bool startNextStep() {
+		Step step = std::move(nextStep);
+		nextStep = nullptr;
+		if(step(value)) return true;
+		nextStep = std::move(step);
+		return false;
+	}
+
+	/** \brief MPI implementation. */
+	MPI_Request value;
+	/** \brief \p data to be received. Shared with the steps, so that they can resize it. */
+	std::shared_ptr<Data> data;
+	/** \brief Other data used by the operation, like the data sent or the counts of a collective. */
+	std::shared_ptr<void> payload;
+	/** \brief Step to start when the current operation completes, if any. */
+	Step nextStep;
+	/** \brief False for the collectives, which can't be cancelled. */
+	bool cancellable;
+	/** \brief Status of the last operation completed. */
+	MPI_Status status;
+};
+
+
+
+/** \brief Returns after a makePersistentSend or makePersistentReceive call, this object is a communication
+  channel bound once to a buffer, a rank and a tag, that can be restarted without setup nor allocation. The buffer
+  is borrowed: it must stay alive as long as the request. */
+class PersistentRequest {
+public:
+	/** \brief Initializes this request with its MPI implementation, which is inactive, and the \p payload that
+  must stay alive as long as the MPI implementation. */
+	explicit PersistentRequest(MPI_Request value, std::shared_ptr<void> payload = nullptr)
+	: value(value), payload(std::move(payload))
+	{}
+	/** \brief Frees the MPI implementation. An active operation still completes. */
+	~PersistentRequest() {
+		free();
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	PersistentRequest(const PersistentRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	PersistentRequest(PersistentRequest&& rhs): value(rhs.value), payload(std::move(rhs.payload)) {
+		rhs.value = MPI_REQUEST_NULL;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	PersistentRequest& operator=(const PersistentRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	PersistentRequest& operator=(PersistentRequest&& rhs) {
+		if(this == &rhs) return *this;
+		free();
+		value = rhs.value;
+		payload = std::move(rhs.payload);
+		rhs.value = MPI_REQUEST_NULL;
+		return *this;
+	}
+
+	/** \brief Returns true if the operation is completed, or if it is not started. */
+	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("PersistentRequest::isCompleted");
 		int flag = 0;
 		handleError(MPI_Test(&value, &flag, MPI_STATUS_IGNORE));
 		return flag != 0;
 	}
-	/** \brief Waits for the data to be received. */
+	/** \brief Starts the operation. The previous one must be completed. */
+	void start() {
+		handleError(MPI_Start(&value));
+	}
+	/** \brief Waits for the operation to complete. */
 	void wait() {
+		NICEMPI_PROFILE_WAIT("PersistentRequest::wait");
 		handleError(MPI_Wait(&value,MPI_STATUS_IGNORE));
 	}
-	/** Returns the data, assuming that the user made sure that the receiving operation was completed. */
-	std::vector<to_contained_type_t<Type>> take() {
-		return std::move(data);
+#if MPI_VERSION >= 4
+	/** \brief Returns true if the \p partition was received. Only for requests created by
+  makePartitionedReceive.*/
+	bool hasArrived(int partition) {
+		int flag = 0;
+		handleError(MPI_Parrived(value,partition,&flag));
+		return flag != 0;
+	}
+	/** \brief Marks the \p partition ready to be sent. Only for requests created by makePartitionedSend. */
+	void markReady(int partition) {
+		handleError(MPI_Pready(partition,value));
+	}
+#endif
+
+	/** \brief RequestSet takes the MPI implementation of the requests added to it. */
+	friend class RequestSet;
+
+private:
+	/** \brief Frees the MPI implementation, if MPI is not finalized yet. */
+	void free() {
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+		if(value == MPI_REQUEST_NULL or finalized) return;
+		int error = MPI_Request_free(&value);
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Ignore MPI_Request_free error in release
+	}
+
+	/** \brief MPI implementation. */
+	MPI_Request value;
+	/** \brief Data used by the MPI implementation, like a derived datatype. */
+	std::shared_ptr<void> payload;
+};
+
+
+
+/** \brief Pool of requests, stored contiguously, that can be completed together with the vector MPI calls. The
+  requests are identified by the index returned when they are added. Requests can be completed in any order, and
+  the data received are taken by index, so that the first data received can be processed while the others are
+  still in flight. */
+class RequestSet {
+public:
+	/** \brief Creates an empty pool. */
+	RequestSet() = default;
+	/** \brief Detaches the requests that are not completed, after having started all the steps of the
+  collectives. The steps of the receive operations are dropped, since they did not match any message yet. */
+	~RequestSet() {
+		for(std::size_t i = 0; i < requests.size(); ++i) {
+			Entry& x = entries[i];
+			if(x.persistent) {
+				PersistentRequest toFree(requests[i],std::move(x.keptAlive));
+				continue;
+			}
+			while(x.nextStep and !x.cancellable) {
+				MPI_Wait(&requests[i],MPI_STATUS_IGNORE);
+				startNextStep(i);
+			}
+			if(requests[i] != MPI_REQUEST_NULL) DetachedRequests::add(requests[i],x.bundle(),x.cancellable);
+		}
+	}
+	/** \brief This object can only be moved, since it owns MPI implementations. **/
+	RequestSet(const RequestSet&) = delete;
+	/** \brief This object can only be moved, since it owns MPI implementations. **/
+	RequestSet(RequestSet&&) = default;
+	/** \brief This object can only be moved, since it owns MPI implementations. **/
+	RequestSet& operator=(const RequestSet&) = delete;
+	/** \brief This object can only be moved, since it owns MPI implementations. **/
+	RequestSet& operator=(RequestSet&&) = delete;
+
+	/** \brief Adds the persistent \p request to this pool, and returns its index. It is started by startAll(),
+  and can be completed many times. */
+	std::size_t add(PersistentRequest&& request) {
+		Entry x;
+		x.keptAlive = std::move(request.payload);
+		x.persistent = true;
+		++persistentCount;
+		const std::size_t index = add(request.value,std::move(x));
+		request.value = MPI_REQUEST_NULL;
+		return index;
+	}
+	/** \brief Adds the send \p request to this pool, and returns its index. */
+	std::size_t add(SendRequest&& request) {
+		Entry x;
+		x.keptAlive = std::move(request.payload);
+		x.cancellable = request.cancellable;
+		const std::size_t index = add(request.value,std::move(x));
+		request.value = MPI_REQUEST_NULL;
+		return index;
+	}
+	/** \brief Adds the receive \p request to this pool, and returns its index. Use take() to get its data. */
+	template<class Type>
+	std::size_t add(ReceiveRequest<Type>&& request) {
+		using Data = typename ReceiveRequest<Type>::Data;
+		Entry x;
+		x.data = std::move(request.data);
+		x.keptAlive = std::move(request.payload);
+		x.type = &typeid(Data);
+		x.cancellable = request.cancellable;
+		x.nextStep = std::move(request.nextStep);
+		request.nextStep = nullptr;
+		const std::size_t index = add(request.value,std::move(x));
+		request.value = MPI_REQUEST_NULL;
+		return index;
+	}
+	/** \brief Returns the number of requests added to this pool. */
+	std::size_t size() const {
+		return requests.size();
+	}
+
+	/** \brief Starts every persistent requests of this pool. Their previous operations must be completed. */
+	void startAll() {
+		if(persistentCount == requests.size()) {
+			handleError(MPI_Startall(static_cast<int>(requests.size()),requests.data()));
+			return;
+		}
+		for(std::size_t i = 0; i < requests.size(); ++i) {
+			if(entries[i].persistent) handleError(MPI_Start(&requests[i]));
+		}
+	}
+	/** \brief Returns the indices of the requests that are completed, in the order of their completion, without
+  waiting. A request is reported only once, until a persistent request is started again. */
+	std::vector<std::size_t> testSome() {
+		std::vector<std::size_t> result;
+		startDeferredSteps();
+		while(completeSome(MPI_Testsome,result)) {}
+		return result;
+	}
+	/** \brief Waits for every requests to complete. */
+	void waitAll() {
+		NICEMPI_PROFILE_WAIT("RequestSet::waitAll");
+		bool stepPending = true;
+		while(stepPending) {
+			handleError(MPI_Waitall(static_cast<int>(requests.size()),requests.data(),MPI_STATUSES_IGNORE));
+			stepPending = false;
+			for(std::size_t i = 0; i < requests.size(); ++i) {
+				if(entries[i].nextStep) {
+					startNextStep(i);
+					stepPending = true;
+				}
+				else releaseIfSent(i);
+			}
+		}
+	}
+	/** \brief Waits for one request to complete, and returns its index. Returns size() if every requests were
+  already reported completed. */
+	std::size_t waitAny() {
+		NICEMPI_PROFILE_WAIT("RequestSet::waitAny");
+		while(true) {
+			const bool deferred = startDeferredSteps();
+			int index = MPI_UNDEFINED;
+			int flag = 1;
+			if(deferred) {
+				handleError(MPI_Testany(static_cast<int>(requests.size()),requests.data(),&index,&flag,
+					MPI_STATUS_IGNORE));
+			}
+			else {
+				handleError(MPI_Waitany(static_cast<int>(requests.size()),requests.data(),&index,
+					MPI_STATUS_IGNORE));
+			}
+			if(flag == 0 or (index == MPI_UNDEFINED and deferred)) continue;
+			if(index == MPI_UNDEFINED) return requests.size();
+			if(!entries[index].nextStep) {
+				releaseIfSent(index);
+				return index;
+			}
+			startNextStep(index);
+		}
+	}
+	/** \brief Waits for at least one request to complete, and returns the indices of the requests completed, in
+  the order of their completion. Returns an empty vector if every requests were already reported completed. */
+	std::vector<std::size_t> waitSome() {
+		NICEMPI_PROFILE_WAIT("RequestSet::waitSome");
+		std::vector<std::size_t> result;
+		while(result.empty()) {
+			const bool deferred = startDeferredSteps();
+			const bool stepStarted = completeSome(deferred ? MPI_Testsome : MPI_Waitsome,result);
+			if(!stepStarted and !hasDeferredSteps()) break;
+		}
+		return result;
+	}
+	/** \brief Returns the data of the receive request of the \p index, assuming that it was completed. \p Type
+  must be the type of the ReceiveRequest added. */
+	template<class Type>
+	typename ReceiveRequest<Type>::Data take(std::size_t index) {
+		using Data = typename ReceiveRequest<Type>::Data;
+		assert(index < requests.size() and entries[index].type != nullptr and *entries[index].type == typeid(Data));
+		assert(requests[index] == MPI_REQUEST_NULL);
+		return std::move(*std::static_pointer_cast<Data>(entries[index].data));
+	}
+
+private:
+	/** \brief Signature of MPI_Testsome and MPI_Waitsome. */
+	using CompleteSome = int (*)(int, MPI_Request[], int*, int[], MPI_Status[]);
+
+	/** \brief Everything about a request, except its MPI implementation. */
+	struct Entry {
+		/** \brief Returns an object that keeps \p data and \p keptAlive alive. */
+		std::shared_ptr<void> bundle() const {
+			return std::make_shared<std::array<std::shared_ptr<void>,2>>(std::array<std::shared_ptr<void>,2>{{
+				data, keptAlive }});
+		}
+
+		/** \brief Data received, for receive requests. */
+		std::shared_ptr<void> data;
+		/** \brief Data sent, or other data used by the operation. */
+		std::shared_ptr<void> keptAlive;
+		/** \brief Type of \p data, nullptr for the requests that don't receive data. */
+		const std::type_info* type = nullptr;
+		/** \brief Step to start when the current operation completes, if any. */
+		std::function<bool(MPI_Request&)> nextStep;
+		/** \brief True for requests that are persistent. */
+		bool persistent = false;
+		/** \brief True for receive requests, which can be cancelled. */
+		bool cancellable = false;
+	};
+
+	/** \brief Adds a request to this pool, and returns its index. */
+	std::size_t add(MPI_Request value, Entry&& entry) {
+		requests.push_back(value);
+		entries.push_back(std::move(entry));
+		return requests.size() - 1;
+	}
+	/** \brief Completes some requests with \p function, and appends to \p result the indices of the completed
+  requests. Returns true if a step was started, in which case some requests may still complete. */
+	bool completeSome(CompleteSome function, std::vector<std::size_t>& result) {
+		int outcount = 0;
+		completedIndices.resize(requests.size());
+		handleError(function(static_cast<int>(requests.size()),requests.data(),&outcount,completedIndices.data(),
+			MPI_STATUSES_IGNORE));
+		if(outcount == MPI_UNDEFINED) return false;
+		bool stepStarted = false;
+		for(int i = 0; i < outcount; ++i) {
+			const std::size_t index = completedIndices[i];
+			if(entries[index].nextStep) {
+				if(startNextStep(index)) stepStarted = true;
+				continue;
+			}
+			releaseIfSent(index);
+			result.push_back(index);
+		}
+		return stepStarted;
+	}
+	/** \brief Returns true if some steps could not be started yet. */
+	bool hasDeferredSteps() const {
+		for(std::size_t i = 0; i < requests.size(); ++i) {
+			if(requests[i] == MPI_REQUEST_NULL and entries[i].nextStep) return true;
+		}
+		return false;
+	}
+	/** \brief Frees the data sent by the request of the \p index, unless it is persistent. */
+	void releaseIfSent(std::size_t index) {
+		if(!entries[index].persistent) entries[index].keptAlive.reset();
+	}
+	/** \brief Tries again the steps that could not be started yet. Returns true if some of them still can't be
+  started, in which case the requests must be polled instead of waited. */
+	bool startDeferredSteps() {
+		bool deferred = false;
+		for(std::size_t i = 0; i < requests.size(); ++i) {
+			if(requests[i] != MPI_REQUEST_NULL or !entries[i].nextStep) continue;
+			if(!startNextStep(i)) deferred = true;
+		}
+		return deferred;
+	}
+	/** \brief Starts the next step of the request of the \p index. Returns false if it must be tried again. */
+	bool startNextStep(std::size_t index) {
+		std::function<bool(MPI_Request&)> step = std::move(entries[index].nextStep);
+		entries[index].nextStep = nullptr;
+		if(step(requests[index])) return true;
+		entries[index].nextStep = std::move(step);
+		return false;
+	}
+
+	/** \brief MPI implementations, stored contiguously as required by the vector MPI calls. */
+	std::vector<MPI_Request> requests;
+	/** \brief Everything else about the request of the same index. */
+	std::vector<Entry> entries;
+	/** \brief Number of persistent requests. */
+	std::size_t persistentCount = 0;
+	/** \brief Buffer for the indices returned by MPI, kept to avoid allocations. */
+	std::vector<int> completedIndices;
+};
+
+
+
+/** \brief Request of a communicator created by a nonblocking operation, like Communicator::asyncDuplicate(). The
+  communicator can't be used before the request completes. */
+class CommunicatorRequest {
+public:
+	/** \brief The functions like asyncDuplicate initialize the members of the request directly. */
+	CommunicatorRequest(): value(MPI_REQUEST_NULL), mpiCommunicator(MPI_COMM_NULL)
+	{}
+	/** \brief Completes the operation if it is not completed, and frees the communicator if it was not taken. */
+	~CommunicatorRequest() {
+		if(value != MPI_REQUEST_NULL) {
+			int error = MPI_Wait(&value,MPI_STATUS_IGNORE);
+			((void)error); // Unused in release mode
+			assert(error == MPI_SUCCESS);
+		}
+		if(mpiCommunicator != MPI_COMM_NULL) {
+			int error = MPI_Comm_free(&mpiCommunicator);
+			((void)error); // Unused in release mode
+			assert(error == MPI_SUCCESS);
+		}
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	CommunicatorRequest(const CommunicatorRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	CommunicatorRequest(CommunicatorRequest&& rhs): value(rhs.value), mpiCommunicator(rhs.mpiCommunicator) {
+		rhs.value = MPI_REQUEST_NULL;
+		rhs.mpiCommunicator = MPI_COMM_NULL;
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	CommunicatorRequest& operator=(const CommunicatorRequest&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	CommunicatorRequest& operator=(CommunicatorRequest&&) = delete;
+
+	/** \brief Returns true if the communicator is created. */
+	bool isCompleted() {
+		NICEMPI_PROFILE_WAIT("CommunicatorRequest::isCompleted");
+		int flag = 0;
+		handleError(MPI_Test(&value, &flag, MPI_STATUS_IGNORE));
+		return flag != 0;
+	}
+	/** \brief Waits for the communicator to be created. */
+	void wait() {
+		NICEMPI_PROFILE_WAIT("CommunicatorRequest::wait");
+		handleError(MPI_Wait(&value,MPI_STATUS_IGNORE));
 	}
+	/** \brief Waits for the communicator to be created, and returns it. It can only be taken once. */
+	Communicator take();
 
-	/** \brief The function asyncReceive needs the address of \p data. */
+	/** \brief The functions like asyncDuplicate need the address of the members. */
 	friend Communicator;
 
 private:
 	/** \brief MPI implementation. */
 	MPI_Request value;
-	/** \brief \p data to be received. */
-	std::vector<to_contained_type_t<Type>> data;
+	/** \brief Communicator created, owned by this request until it is taken. */
+	MPI_Comm mpiCommunicator;
+};
+
+
+
+/** \brief Data received with the rank of the process that sent them and their tag. Returned by the receive
+  operations that find out who sent the data, like Communicator::receiveMessage(). */
+template<class Collection>
+struct Message {
+	/** \brief Data received. */
+	Collection data;
+	/** \brief Rank of the process that sent the data. */
+	int source;
+	/** \brief Tag of the data. */
+	int tag;
+};
+
+
+
+/** \brief Ranks of the neighbors of a process along a dimension of a Cartesian communicator, returned by
+  Communicator::shift(). MPI_PROC_NULL if there is no neighbor, at the border of a non-periodic dimension. */
+struct Shift {
+	/** \brief Rank of the process the data are received from, in the negative direction. */
+	int source;
+	/** \brief Rank of the process the data are sent to, in the positive direction. */
+	int destination;
 };
 
 
@@ -159,37 +769,220 @@ private:
 /** \brief Represents a MPI communitator. */
 class Communicator {
 public:
-	/** \brief Creates a communicator congruent (but not equal) to MPI_COMM_WORLD. */
+	/** \brief Creates a communicator congruent (but not equal) to MPI_COMM_WORLD. Copying a communicator also
+  creates a congruent communicator, with the collective MPI_Comm_dup: use shared() for cheap copies. */
 	explicit Communicator(MPI_Comm mpiCommunicator = MPI_COMM_WORLD);
+	/** \brief Starts to create a communicator congruent (but not equal) to \p this, with MPI_Comm_idup. */
+	CommunicatorRequest asyncDuplicate() const;
+	/** \brief Returns a communicator with a Cartesian topology of the given \p dimensions, which are periodic
+  according to \p periods, with MPI_Cart_create. If \p reorder, MPI can reorder the ranks to match the physical
+  network. The communicator is null on the processes that don't fit in the dimensions. Collective. */
+	Communicator cartesian(const std::vector<int>& dimensions, const std::vector<bool>& periods,
+		bool reorder = true) const;
+	/** \brief Returns the coordinates of this process in a Cartesian communicator. */
+	std::vector<int> coordinates() const;
+	/** \brief Returns a communicator with a distributed graph topology, with MPI_Dist_graph_create_adjacent: this
+  process receives from the \p sources and sends to the \p destinations, given as ranks of \p this. Every edge
+  must be given by both its ends. If \p reorder, MPI can reorder the ranks. Collective. */
+	Communicator distGraph(const std::vector<int>& sources, const std::vector<int>& destinations,
+		bool reorder = true) const;
+	/** \brief Returns a communicator congruent (but not equal) to \p this, like a copy. Its messages are isolated
+  from the messages of \p this, at the price of a collective MPI_Comm_dup. */
+	Communicator duplicate() const;
 	/** \brief Returns the MPI communicator associated to \p this. This method breaks encapsulation, but it is
   provided in order to facilitate the interface with MPI functions not implemented here. Minimize its use. */
 	MPI_Comm get() const;
-	/** \brief Returns the rank of the process in this communicator. */
+	/** \brief Returns the ranks of the neighbors that this process sends to, in the order of the neighborhood
+  collectives, for a Cartesian or a distributed graph communicator. */
+	std::vector<int> neighborDestinations() const;
+	/** \brief Returns the ranks of the neighbors that this process receives from, in the order of the
+  neighborhood collectives, for a Cartesian or a distributed graph communicator. Along each dimension of a
+  Cartesian communicator, the neighbor in the negative direction comes first. */
+	std::vector<int> neighborSources() const;
+	/** \brief Returns the rank of the process in this communicator. It is queried once, when the communicator is
+  created. */
 	int rank() const;
-	/** \brief Returns the size of this communicator. */
+	/** \brief Returns the rank of the process at the \p coordinates in a Cartesian communicator. */
+	int rankOf(const std::vector<int>& coordinates) const;
+	/** \brief Returns a communicator identical to \p this, that shares its MPI implementation without duplicating
+  it. The MPI implementation is freed with the last communicator that shares it. This is the cheap way to pass a
+  communicator by value. A shared proxy is still a proxy. */
+	Communicator shared() const;
+	/** \brief Returns the neighbors of this process at \p displacement along the \p dimension of a Cartesian
+  communicator. */
+	Shift shift(int dimension, int displacement = 1) const;
+	/** \brief Returns the size of this communicator. It is queried once, when the communicator is created. */
 	int size() const;
 	/** \brief Splits this communicator. 'Processes with the same \p color are in the same new communicator.' The \p
   key control of rank assignment.*/
 	Communicator split(int color, int key) const;
+	/** \brief Returns a communicator made of one process per node, the process of rank 0 in splitShared(), with
+  the rank order of \p this. The communicator is null on the other processes. Collective. */
+	Communicator splitNodeLeaders() const;
+	/** \brief Splits this communicator in the groups of processes that can share memory, usually the processes of
+  a node, with MPI_Comm_split_type(MPI_COMM_TYPE_SHARED). The rank order of \p this is kept. */
+	Communicator splitShared() const;
+	/** \brief Returns the topology of this communicator: MPI_CART, MPI_GRAPH, MPI_DIST_GRAPH or MPI_UNDEFINED if it
+  has none. */
+	int topology() const;
 
 
 	/** \brief Regroups the \p data of every processes in a single vector and returns it. */
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	std::vector<Type> allGather(Type data);
 
 	/** \brief Regroups the \p data of every processes in a single vector and returns it. */
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
 	>
 	std::vector<typename Collection::value_type> allGather(const Collection& data);
 
+	/** \brief Regroups the \p data of every processes in \p result, which must contain one element for each
+  process. No allocation is made.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	void allGather(Type data, Span<Type> result);
+
+	/** \brief Regroups the \p data of every processes in \p result, which must contain data.size() elements for
+  each process. No allocation is made.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	void allGather(const Collection& data, Span<typename Collection::value_type> result);
+
+	/** \brief Regroups the \p data of every processes in place. \p data contains the same number of elements for
+  each process, and the elements of this process are already at their place in \p data. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void allGatherInPlace(Span<Type> data);
+
+	/** \brief Combines the \p data of every processes with the operator \p op and returns the result to every
+  processes. \p op is either a MPI_Op or a functor, like std::plus or Maximum.*/
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type allReduce(Type data, Operator op = Operator{});
+
+	/** \brief Combines element-wise the \p data of every processes with the operator \p op and returns the result
+  to every processes. \p op is either a MPI_Op or a functor, like std::plus or Maximum.*/
+	template<class Collection, class Operator = std::plus<typename Collection::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Collection allReduce(const Collection& data, Operator op = Operator{});
+
+	/** \brief Sends \p sendCount elements of \p toSend to every processes: the process with rank \p i receives
+  the data from \p toSend[i*sendCount] to toSend[(i+1)*\p sendCount]. Returns the \p sendCount elements received
+  from every processes, ordered by rank.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> allToAll(const std::vector<Type>& toSend, std::size_t sendCount);
+
+	/** \brief Same as allToAll(), but the data are received directly in \p result, which must contain the same
+  number of elements for each process. No allocation is made.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void allToAll(const std::vector<Type>& toSend, Span<Type> result);
+
+	/** \brief Starts to regroup the \p data of every processes. Returns a ReceiveRequest that owns the result, with
+  one element for each process, that can be taken once the request is completed.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	ReceiveRequest<std::vector<Type>> asyncAllGather(Type data);
+
+	/** \brief Starts to regroup the \p data of every processes. \p data contains the same number of elements for
+  each process. Returns a ReceiveRequest that owns the result. A rvalue std::vector is moved, instead of copied.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+			bool>::type = true
+	>
+	ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+		asyncAllGather(Collection&& data);
+
+	/** \brief Starts to combine the \p data of every processes with the operator \p op. Returns a ReceiveRequest
+  that owns the result. Without MPI-4, collections of more than INT_MAX elements are not supported.*/
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	ReceiveRequest<Type> asyncAllReduce(Type data, Operator op = Operator{});
+
+	/** \brief Starts to combine element-wise the \p data of every processes with the operator \p op. Returns a
+  ReceiveRequest that owns the result. A rvalue std::vector is moved, instead of copied.*/
+	template<class Collection, class Operator = std::plus<typename std::decay<Collection>::type::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+			bool>::type = true
+	>
+	ReceiveRequest<typename std::decay<Collection>::type> asyncAllReduce(Collection&& data,
+		Operator op = Operator{});
+
+	/** \brief Nonblocking allToAll(). \p toSend is moved if it is a rvalue, instead of copied. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncAllToAll(std::vector<Type> toSend, std::size_t sendCount);
+
+	/** \brief The \p source starts to broadcast its \p data to every processes. Returns a ReceiveRequest that owns
+  the result.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	ReceiveRequest<Type> asyncBroadcast(int source, Type data);
+
+	/** \brief The \p source starts to broadcast its \p data to every processes. Unless the size of \p Collection
+  is fixed, the request has two steps: the size is broadcast first, and the data are broadcast when it completes,
+  without blocking. The data are broadcast on a private duplicate of \p this communicator, in the order in which
+  the broadcasts were started, so that other collectives can be started on \p this communicator before it
+  completes. The duplicate is created by the first such broadcast on the communicator.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+			!is_span<Collection>::value,bool>::type = true
+	>
+	ReceiveRequest<Collection> asyncBroadcast(int source, Collection data);
+
+	/** \brief Starts to regroup the \p data of every processes on the \p source. The result is empty on the other
+  processes.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	ReceiveRequest<std::vector<Type>> asyncGather(int source, Type data);
+
+	/** \brief Starts to regroup the \p data of every processes on the \p source. \p data contains the same number
+  of elements for each process. The result is empty on the other processes. A rvalue std::vector is moved,
+  instead of copied.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+			bool>::type = true
+	>
+	ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+		asyncGather(int source, Collection&& data);
+
+	/** \brief Nonblocking neighborAllGather(). */
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	ReceiveRequest<std::vector<Type>> asyncNeighborAllGather(Type data);
+
+	/** \brief Nonblocking neighborAllGather(). A rvalue std::vector is moved, instead of copied. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+			bool>::type = true
+	>
+	ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+		asyncNeighborAllGather(Collection&& data);
+
+	/** \brief Nonblocking neighborAllToAll(). \p toSend is moved if it is a rvalue, instead of copied. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncNeighborAllToAll(std::vector<Type> toSend);
+
+	/** \brief Nonblocking neighborVaryingAllToAll(). Without MPI-4, displacements larger than INT_MAX are not
+  supported. \p toSend is moved if it is a rvalue, instead of copied. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncNeighborVaryingAllToAll(std::vector<Type> toSend,
+		const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts);
+
 	/** \brief Starts to receive data of type \p Type from the \p source. A \p tag can be required to be provided
   with the data. \p MPI_ANY_TAG can be used. Returns a ReceiveRequest object that can be used to find out if
   the data were received, or to wait until they are received and get them.*/
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	ReceiveRequest<Type> asyncReceive(int source, int tag = 0);
 
@@ -197,109 +990,482 @@ public:
   with the data. \p MPI_ANY_TAG can be used. Returns a ReceiveRequest object that can be used to find out if
   the data were received, or to wait until they are received and get them.*/
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	ReceiveRequest<Collection> asyncReceive(std::size_t count, int source, int tag = 0);
+
+	/** \brief Starts to receive data.size() elements from the \p source directly in the memory of the strided
+  \p data, without unpacking. The returned request only reports the completion of the receive, the data being
+  borrowed: they must stay alive until the receive completes. Like the other receives, the request is cancelled
+  if it is destroyed and never matched.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	SendRequest asyncReceive(StridedView<Type> data, int source, int tag = 0);
+
+	/** \brief Starts to receive data.size() elements from the \p source in the memory of the device of \p data.
+  The addresses of the device are given to MPI if it is aware of the device. Otherwise, the data are received on
+  the host in the chunks of receive(DeviceSpan), all started at once, and each one is copied to the device when
+  the returned request is found completed. With MPI_ANY_SOURCE or MPI_ANY_TAG, the first chunk fixes the source
+  and the tag of the others, which are started when it is found completed. The sender can use send or asyncSend
+  with a DeviceSpan.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	DeviceRequest asyncReceive(DeviceSpan<Type> data, int source, int tag = 0);
+
+	/** \brief Starts to receive a collection from the \p source, without knowing its size. As soon as a message
+  matching the \p source and the \p tag is found with MPI_Improbe, it is received in data of the exact size. A
+  message is probed when the request is created, and then each time it is tested or waited until one is found. The
+  actual source and tag are given by ReceiveRequest::source() and ReceiveRequest::tag().*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
 	>
-	ReceiveRequest<Collection> asyncReceive(int count, int source, int tag = 0);
+	ReceiveRequest<Collection> asyncReceiveMessage(int source, int tag = 0);
+
+	/** \brief The \p source starts to scatter \p sendCount of its data \p toSend to every processes. \p toSend is
+  moved if it is a rvalue, instead of copied.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncScatter(int source, std::vector<Type> toSend,
+		std::size_t sendCount);
 
 	/** \brief Starts to send \p data to the \p destination. A \p tag can be required to be provided with the data.
   \p MPI_ANY_TAG can be used. Returns a SendRequest object that can be used to find out if the data were sent, or
-  to wait until they are sent.*/
+  to wait until they are sent. The request owns a copy of \p data, hence it can be destroyed before the
+  completion of the send operation.*/
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	SendRequest asyncSend(Type data, int destination, int tag = 0);
 
 	/** \brief Starts to send \p data to the \p destination. A \p tag can be required to be provided with the data.
   \p MPI_ANY_TAG can be used. Returns a SendRequest object that can be used to find out if the data were sent, or
-  to wait until they are sent.*/
+  to wait until they are sent. The request owns the \p data: they are copied if they are a lvalue and moved
+  otherwise, hence the request can be destroyed before the completion of the send operation.*/
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value and
+			!is_span<typename std::decay<Collection>::type>::value,bool>::type = true
+	>
+	SendRequest asyncSend(Collection&& data, int destination, int tag = 0);
+
+	/** \brief Starts to send the \p data of a span to the \p destination, without copy. The data are borrowed:
+  the caller must keep them alive and unchanged until the send operation completes.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	SendRequest asyncSend(Span<Type> data, int destination, int tag = 0);
+
+	/** \brief Starts to send the elements of the strided \p data to the \p destination, without packing. The data
+  are borrowed: the caller must keep them alive and unchanged until the send operation completes.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	SendRequest asyncSend(StridedView<Type> data, int destination, int tag = 0);
+
+	/** \brief Starts to send the elements in the memory of the device of \p data to the \p destination, once the
+  stream of \p data is synchronized. The addresses of the device are given to MPI if it is aware of the device.
+  Otherwise, the data are copied to the host in the chunks of send(DeviceSpan), and each chunk is sent while the
+  next one is copied, so that the data of the device can be reused once the call returns. The receiver can use
+  receive or asyncReceive with a DeviceSpan. The data are borrowed: the caller must keep them alive until the send
+  operation completes.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
 	>
-	SendRequest asyncSend(const Collection& data, int destination, int tag = 0);
+	DeviceRequest asyncSend(DeviceSpan<Type> data, int destination, int tag = 0);
+
+	/** \brief Starts to send the \p data, packed by their Serializer, to the \p destination. The data are packed
+  once in a buffer owned by the returned request, so that they can be modified right away.*/
+	template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type = true>
+	SendRequest asyncSend(const Type& data, int destination, int tag = 0);
+
+	/** \brief Nonblocking varyingAllGather(). Without MPI-4, counts and displacements larger than INT_MAX are not
+  supported. \p data is moved if it is a rvalue, instead of copied.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncVaryingAllGather(std::vector<Type> data,
+		const std::vector<int>& receiveCounts, const std::vector<int>& displacements = {});
+
+	/** \brief Nonblocking varyingAllToAll(). Without MPI-4, displacements larger than INT_MAX are not
+  supported. \p toSend is moved if it is a rvalue, instead of copied.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncVaryingAllToAll(std::vector<Type> toSend,
+		const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts,
+		const std::vector<int>& sendDisplacements = {}, const std::vector<int>& receiveDisplacements = {});
+
+	/** \brief Nonblocking varyingGather(). Without MPI-4, counts and displacements larger than INT_MAX are not
+  supported. \p data is moved if it is a rvalue, instead of copied.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncVaryingGather(int source, std::vector<Type> data,
+		const std::vector<int>& receiveCounts, const std::vector<int>& displacements = {});
+
+	/** \brief Nonblocking varyingScatter(). Without MPI-4, counts and displacements larger than INT_MAX are not
+  supported. \p toSend is moved if it is a rvalue, instead of copied.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	ReceiveRequest<std::vector<Type>> asyncVaryingScatter(int source, std::vector<Type> toSend,
+		const std::vector<int>& sendCounts, const std::vector<int>& displacements = {});
 
 	/** \brief The \p source broadcast its \p data to every processes. */
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	Type broadcast(int source, Type data);
 
 	/** \brief The \p source broadcast its \p data to every processes. */
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+			!is_span<Collection>::value,bool>::type = true
 	>
 	Collection broadcast(int source, Collection data);
 
+	/** \brief The \p source broadcast its \p data, packed by their Serializer, to every processes.*/
+	template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type = true>
+	Type broadcast(int source, const Type& data);
+
+	/** \brief The \p source broadcast its \p data to every processes, in place. Every processes must provide
+  the same number of elements. No allocation is made.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void broadcast(int source, Span<Type> data);
+
+	/** \brief The \p source broadcast the elements in the memory of the device of its \p data to every
+  processes, in place. The data are staged through the host if MPI is not aware of the device.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void broadcast(int source, DeviceSpan<Type> data);
+
+	/** \brief Sends \p sendCounts[i] to the process with rank \p i and returns the counts received from every
+  processes. This is the usual first step of a varyingAllToAll(), when each process only knows what it sends.*/
+	std::vector<int> exchangeCounts(const std::vector<int>& sendCounts);
+
+	/** \brief Returns the combination with the operator \p op of the \p data of every processes with a rank lower
+  than the rank of this process. The result is undefined on the process with rank 0.*/
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type exScan(Type data, Operator op = Operator{});
+
+	/** \brief Returns the element-wise combination with the operator \p op of the \p data of every processes with
+  a rank lower than the rank of this process. The result is undefined on the process with rank 0.*/
+	template<class Collection, class Operator = std::plus<typename Collection::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Collection exScan(const Collection& data, Operator op = Operator{});
+
 	/** \brief The \p source gathers the \p data of every processes. */
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	std::vector<Type> gather(int source, Type data);
 
 	/** \brief The \p source gathers the \p data of every processes. */
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
 	>
 	std::vector<typename Collection::value_type> gather(int source, const Collection& data);
 
+	/** \brief The \p source gathers the \p data of every processes in \p result, which must contain one element
+  for each process on the \p source. \p result is not used on the other processes. No allocation is made.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	void gather(int source, Type data, Span<Type> result);
+
+	/** \brief The \p source gathers the \p data of every processes in \p result, which must contain data.size()
+  elements for each process on the \p source. \p result is not used on the other processes. No allocation is
+  made.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	void gather(int source, const Collection& data, Span<typename Collection::value_type> result);
+
+	/** \brief The \p source gathers the \p data of every processes in place. On the \p source, \p data contains
+  the same number of elements for each process, and the elements of the \p source are already at their place.
+  The other processes send their \p data.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void gatherInPlace(int source, Span<Type> data);
+
+#if MPI_VERSION >= 4
+	/** \brief Creates a partitioned receive of the \p data from the \p source, in \p partitions of equal size.
+  Use PersistentRequest::hasArrived() to process the partitions as they arrive.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	PersistentRequest makePartitionedReceive(Span<Type> data, int partitions, int source, int tag = 0);
+
+	/** \brief Creates a partitioned send of the \p data to the \p destination, in \p partitions of equal size.
+  Once started, each partition is sent when it is marked ready with PersistentRequest::markReady(), for instance
+  by the thread that produced it.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	PersistentRequest makePartitionedSend(Span<Type> data, int partitions, int destination, int tag = 0);
+#endif
+
+	/** \brief Creates a persistent receive of data.size() elements from the \p source directly in \p data. The
+  request is inactive, and can be started many times. \p data must stay alive as long as the request.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	PersistentRequest makePersistentReceive(Span<Type> data, int source, int tag = 0);
+
+	/** \brief Creates a persistent receive of data.size() elements from the \p source directly in the memory of
+  the strided \p data. The request is inactive, and can be started many times. \p data must stay alive as long
+  as the request.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	PersistentRequest makePersistentReceive(StridedView<Type> data, int source, int tag = 0);
+
+	/** \brief Creates a persistent send of the \p data to the \p destination. The request is inactive, and can be
+  started many times, the current content of \p data being sent each time. \p data must stay alive as long as
+  the request.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	PersistentRequest makePersistentSend(Span<Type> data, int destination, int tag = 0);
+
+	/** \brief Creates a persistent send of the strided \p data to the \p destination. The request is inactive,
+  and can be started many times, the current content of \p data being sent each time. \p data must stay alive as
+  long as the request.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	PersistentRequest makePersistentSend(StridedView<Type> data, int destination, int tag = 0);
+
+	/** \brief Sends the \p data to every neighbors of a Cartesian or a distributed graph communicator, and returns
+  the data received from every neighbors, in the order of neighborSources(). Nothing is received from the
+  MPI_PROC_NULL neighbors, whose elements are value-initialized. */
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	std::vector<Type> neighborAllGather(Type data);
+
+	/** \brief Same as neighborAllGather(), for \p data that contain the same number of elements for each
+  process. */
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	std::vector<typename Collection::value_type> neighborAllGather(const Collection& data);
+
+	/** \brief Sends a block of \p toSend to each neighbor, in the order of neighborDestinations(), and returns the
+  blocks received from every neighbors, in the order of neighborSources(). The blocks have the same number of
+  elements for every neighbors. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> neighborAllToAll(const std::vector<Type>& toSend);
+
+	/** \brief Same as neighborAllToAll(), but \p sendCounts[i] elements are sent, sequentially, to the neighbor
+  \p i, and \p receiveCounts[i] elements are received from the neighbor i. */
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> neighborVaryingAllToAll(const std::vector<Type>& toSend, const std::vector<int>& sendCounts,
+		const std::vector<int>& receiveCounts);
+
 	/** \brief Wait to receive data of type \p Type from the \p source. A \p tag can be required to be provided with
   the data. \p MPI_ANY_TAG can be used.*/
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	Type receive(int source, int tag = 0);
 
 	/** \brief Wait to receive data of type \p Type from the \p source. A \p tag can be required to be provided with
   the data. \p MPI_ANY_TAG can be used.*/
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Collection receive(std::size_t count, int source, int tag = 0);
+
+	/** \brief Wait to receive data.size() elements from the \p source directly in \p data. A \p tag can be
+  required to be provided with the data. \p MPI_ANY_TAG can be used. No allocation is made.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void receive(Span<Type> data, int source, int tag = 0);
+
+	/** \brief Wait to receive data.size() elements from the \p source directly in the memory of the strided
+  \p data, without unpacking. \p MPI_ANY_TAG can be used.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void receive(StridedView<Type> data, int source, int tag = 0);
+
+	/** \brief Wait to receive data.size() elements from the \p source in the memory of the device of \p data.
+  If MPI is not aware of the device, the data are received on the host in chunks, and the copy of a chunk to the
+  device overlaps the receive of the next one. The sender must send a DeviceSpan too, with send or asyncSend.
+  Threads that communicate between the same processes at the same time must then use different tags, since the
+  chunks are matched in order.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void receive(DeviceSpan<Type> data, int source, int tag = 0);
+
+	/** \brief Wait to receive data of type \p Type, packed by their Serializer, from the \p source. The size of
+  the packed data is probed, and they are unpacked from a buffer reused by the calling thread. \p MPI_ANY_TAG can
+  be used.*/
+	template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type = true>
+	Type receive(int source, int tag = 0);
+
+	/** \brief Receives a collection from the \p source, without knowing its size. The message is matched with
+  MPI_Mprobe and received in data of the exact size, hence no separate message is needed for the size. \p
+  MPI_ANY_SOURCE and \p MPI_ANY_TAG can be used: the returned Message tells who sent the data, and with which
+  tag.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Message<Collection> receiveMessage(int source, int tag = 0);
+
+	/** \brief The \p source receives the combination with the operator \p op of the \p data of every processes.
+  The result is undefined on the other processes.*/
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type reduce(int source, Type data, Operator op = Operator{});
+
+	/** \brief The \p source receives the element-wise combination with the operator \p op of the \p data of every
+  processes. The other processes receive an empty collection if the collection can be empty.*/
+	template<class Collection, class Operator = std::plus<typename Collection::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
 	>
-	Collection receive(int count, int source, int tag = 0);
+	Collection reduce(int source, const Collection& data, Operator op = Operator{});
+
+	/** \brief Returns the combination with the operator \p op of the \p data of every processes with a rank lower
+  or equal to the rank of this process.*/
+	template<typename Type, class Operator = std::plus<Type>,
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
+	>
+	Type scan(Type data, Operator op = Operator{});
+
+	/** \brief Returns the element-wise combination with the operator \p op of the \p data of every processes with
+  a rank lower or equal to the rank of this process.*/
+	template<class Collection, class Operator = std::plus<typename Collection::value_type>,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
+	>
+	Collection scan(const Collection& data, Operator op = Operator{});
 
 	/** \brief The \p source scatters \p sendCount of its data \p toSend to every processes. Hence, the process with
   rank \p i receives the data from \p toSend[i] to toSend[i+\p sendCount].*/
-	template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type = true>
-	std::vector<Type> scatter(int source, const std::vector<Type>& toSend, int sendCount);
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> scatter(int source, const std::vector<Type>& toSend, std::size_t sendCount);
+
+	/** \brief The \p source scatters result.size() of its data \p toSend to every processes, directly in \p
+  result. Every processes must provide the same number of elements. No allocation is made.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void scatter(int source, const std::vector<Type>& toSend, Span<Type> result);
+
+	/** \brief The \p source broadcast its \p data to every processes, in segments of \p segmentBytes streamed by
+  a few nonblocking broadcasts in flight, so that the \p consumer can process a segment, with its offset, as soon
+  as it arrives. The next segments are already in flight while the \p consumer runs. The count of elements is
+  packed in the first segment, which always has the full size: every call broadcasts at least \p segmentBytes
+  plus 8 bytes, 1 MiB by default, and copies the first segment through a buffer, even for a small collection, so
+  prefer broadcast for those. Every processes must provide the same \p segmentBytes. The \p consumer is called
+  in order on every processes, including the \p source. If it throws, the remaining segments are still broadcast,
+  without calling it again, so that the collective completes before the exception is propagated.*/
+	template<class Collection,
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+			!is_span<Collection>::value and !is_std_array<Collection>::value,bool>::type = true
+	>
+	Collection segmentedBroadcast(int source, Collection data, std::size_t segmentBytes = 1 << 20,
+		const std::function<void(std::size_t,Span<const typename Collection::value_type>)>& consumer = nullptr);
+
+	/** \brief Same as varyingAllToAll(toSend, sendCounts), but only the non empty pairs of processes communicate,
+  with point-to-point messages of the given \p tag. Prefer it when most of the \p sendCounts are zero. The messages
+  are exchanged on the private duplicate of \p this communicator, so that they can't match the receives of the
+  user, like a pending asyncReceive from MPI_ANY_SOURCE. The counts are still exchanged by exchangeCounts(), with a
+  dense MPI_Alltoall, so that the call is not sparse in the number of processes.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> sparseAllToAll(const std::vector<Type>& toSend, const std::vector<int>& sendCounts, int tag = 0);
 
 	/** \brief Wait to send \p data to the \p destination. A \p tag can be required to be provided with
   the data. \p MPI_ANY_TAG can be used.*/
 	template<typename Type,
-		typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type = true
 	>
 	void send(Type data, int destination, int tag = 0);
 
 	/** \brief Wait to send \p data to the \p destination. A \p tag can be required to be provided with
   the data. \p MPI_ANY_TAG can be used.*/
 	template<class Collection,
-		typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type = true
+		typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type = true
 	>
 	void send(const Collection& data, int destination, int tag = 0);
 
+	/** \brief Wait to send the elements of the strided \p data to the \p destination, without packing. \p MPI_ANY_TAG
+  can be used.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	void send(StridedView<Type> data, int destination, int tag = 0);
+
+	/** \brief Wait to send the elements in the memory of the device of \p data to the \p destination. If MPI is
+  not aware of the device, the data are copied to the host in chunks, and the copy of a chunk overlaps the send of
+  the previous one. The receiver must receive in a DeviceSpan too, with receive or asyncReceive. Threads that
+  communicate between the same processes at the same time must then use different tags, since the chunks are
+  matched in order.*/
+	template<typename Type,
+		typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,
+			bool>::type = true
+	>
+	void send(DeviceSpan<Type> data, int destination, int tag = 0);
+
+	/** \brief Wait to send the \p data, packed by their Serializer, to the \p destination. They are packed in a
+  buffer reused by the calling thread. \p MPI_ANY_TAG can be used.*/
+	template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type = true>
+	void send(const Type& data, int destination, int tag = 0);
+
 	/** \brief Regroups the \p data of every processes in a single vector and returns it. \p receiveCounts[i] data
   is received from the process with rank \p i. These data starts at the index \p displacements[i] of the
   returned vector.*/
-	template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type = true>
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
 	std::vector<Type> varyingAllGather(const std::vector<Type>& data, const std::vector<int>& receiveCounts,
 		const std::vector<int>& displacements = {});
 
+	/** \brief Same as varyingAllGather(), but the data are received directly in \p result. No allocation is made
+  for the result.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void varyingAllGather(const std::vector<Type>& data, Span<Type> result, const std::vector<int>& receiveCounts,
+		const std::vector<int>& displacements = {});
+
+	/** \brief Sends \p sendCounts[i] data of \p toSend to the process with rank \p i, and returns the data
+  received from every processes. The counts to receive are first exchanged with exchangeCounts(). The data sent and
+  received are placed sequentially.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> varyingAllToAll(const std::vector<Type>& toSend, const std::vector<int>& sendCounts);
+
+	/** \brief Sends \p sendCounts[i] data of \p toSend, starting at the index \p sendDisplacements[i], to the
+  process with rank \p i. Returns the \p receiveCounts[i] data received from the process \p i, placed starting at
+  the index \p receiveDisplacements[i]. Empty displacements place the data sequentially.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	std::vector<Type> varyingAllToAll(const std::vector<Type>& toSend, const std::vector<int>& sendCounts,
+		const std::vector<int>& receiveCounts, const std::vector<int>& sendDisplacements = {},
+		const std::vector<int>& receiveDisplacements = {});
+
+	/** \brief Same as varyingAllToAll(), but the data are received directly in \p result. No allocation is made
+  for the result.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void varyingAllToAll(const std::vector<Type>& toSend, Span<Type> result, const std::vector<int>& sendCounts,
+		const std::vector<int>& receiveCounts, const std::vector<int>& sendDisplacements = {},
+		const std::vector<int>& receiveDisplacements = {});
+
 	/** \brief The \p source gathers the \p data of every processes. \p receiveCounts[i] data
   is received from the process with rank \p i. These data starts at the index \p displacements[i] of the
-  returned vector. If the argument \p displacements is empty, the data are placed sequentially in the returned vector.*/
-	template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type = true>
+  returned vector. If the argument \p displacements is empty, the data are placed sequentially in the returned vector.
+  Every process gives the same \p receiveCounts.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
 	std::vector<Type> varyingGather(int source, const std::vector<Type>& data, const std::vector<int>& receiveCounts,
 		const std::vector<int>& displacements = {});
 
+	/** \brief Same as varyingGather(), but the data are received directly in \p result on the \p source. No
+  allocation is made for the result.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void varyingGather(int source, const std::vector<Type>& data, Span<Type> result,
+		const std::vector<int>& receiveCounts, const std::vector<int>& displacements = {});
+
 	/** \brief The \p source scatters the data \p toSend of every processes. \p sendCounts[i] data is sent to the
   process with rank \p i. These data are taken starting from the index \p displacements[i] of the vector \p
   toSend. If the argument \p displacements is empty, the data are taken sequentially in the vector \p toSend.*/
-	template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type = true>
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
 	std::vector<Type> varyingScatter(int source, const std::vector<Type>& toSend, const std::vector<int>& sendCounts,
 		const std::vector<int>& displacements = {});
 
+	/** \brief Same as varyingScatter(), but the data are received directly in \p result, which must contain \p
+  sendCounts[rank()] elements. No allocation is made for the result.*/
+	template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type = true>
+	void varyingScatter(int source, const std::vector<Type>& toSend, Span<Type> result,
+		const std::vector<int>& sendCounts, const std::vector<int>& displacements = {});
+
 
 	/** \brief Returns a proxy communicator identical to \p mpiCommunicator. */
 	friend Communicator createProxy(MPI_Comm mpiCommunicator) {
 		return Communicator{&mpiCommunicator};
 	}
+	/** \brief CommunicatorRequest creates the communicator it takes. */
+	friend class CommunicatorRequest;
 	/** \brief Returns a communicator identical to \p MPI_COMM_WORLD. */
 	friend Communicator &mpiWorld() {
 		thread_local MPI_Comm notRvalue = MPI_COMM_WORLD;
@@ -316,23 +1482,33 @@ public:
 private:
 	/** \brief Creates a proxy communicator identical to \p mpiCommunicatorRhs. */
 	Communicator(MPI_Comm* mpiCommunicatorRhs);
+	/** \brief Creates a communicator with the \p handle. */
+	explicit Communicator(MPIcommunicatorHandle&& handle);
+	/** \brief Returns the number of neighbors that this process receives from and sends to, in this order. */
+	std::array<int,2> countNeighbors() const;
 	/** \brief Returns a displacement vector that corresponds to the \p sendCounts[i] data placed sequentially. */
-	static std::vector<int> createDefaultDisplacements(const std::vector<int>& sendCounts);
-	/** \brief Returns the \p displacements scaled by the size of \p Type.*/
-	template<typename Type>
-	static std::vector<int> createScaledDisplacements(std::vector<int> displacements);
-	/** \brief Initializes the collection with \p count elements. */
-	template<typename Type>
-	static std::vector<Type> initializeWithCount(std::vector<Type>, int count);
+	static std::vector<std::size_t> createDefaultDisplacements(const std::vector<int>& sendCounts);
+	/** \brief Initializes the collection with \p count elements, constructed by its \p Allocator: they are not
+  zero-filled with a DefaultInitAllocator. */
+	template<typename Type, class Allocator>
+	static std::vector<Type,Allocator> initializeWithCount(std::vector<Type,Allocator>, std::size_t count);
 	/** \brief Initializes the collection with \p count elements. */
 	template<typename Type, std::size_t N>
-	static std::array<Type,N> initializeWithCount(std::array<Type,N> a, int /*count*/);
+	static std::array<Type,N> initializeWithCount(std::array<Type,N> a, std::size_t /*count*/);
+	/** \brief Returns an object that keeps both \p a and \p b alive. */
+	static std::shared_ptr<void> keepAlive(std::shared_ptr<void> a, std::shared_ptr<void> b);
+	/** \brief Returns the \p data sent by a nonblocking collective, which must stay alive until it completes. A
+  rvalue std::vector is moved. */
+	template<class Type>
+	static std::shared_ptr<std::vector<Type>> ownedData(std::vector<Type>&& data);
+	/** \brief Returns a copy of the \p data sent by a nonblocking collective, which must stay alive until it
+  completes. */
+	template<class Collection>
+	static std::shared_ptr<std::vector<typename Collection::value_type>> ownedData(const Collection& data);
 	/** \brief Returns the sum of the \p data. */
-	static int sum(const std::vector<int>& data);
-	/** \brief Implements \p varyingScatter(). */
-	template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type = true>
-	std::vector<Type> varyingScatterImpl(int source, const std::vector<Type>& toSend,const std::vector<int>& sendCounts,
-		const std::vector<int>& scaledSendCounts, const std::vector<int>& displacements);
+	static std::size_t sum(const std::vector<int>& data);
+	/** \brief Returns the \p displacements as displacements that can exceed the range of an int. */
+	static std::vector<std::size_t> toLargeDisplacements(const std::vector<int>& displacements);
 
 	/** \brief Handles the life of the MPI implementation of \p this communicator. */
 	MPIcommunicatorHandle handle;
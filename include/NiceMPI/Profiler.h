@@ -0,0 +1,148 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef> // std::size_t
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits> // std::is_trivially_copyable
+#include <mpi.h> // MPI_Comm
+
+namespace NiceMPI {
+
+/** \brief What the Profiler recorded for an operation. */
+struct ProfiledStatistics {
+	/** \brief Number of calls. */
+	unsigned long long calls = 0;
+	/** \brief Number of bytes given to the calls. */
+	unsigned long long bytes = 0;
+	/** \brief Time spent in the calls, in seconds. */
+	double time = 0;
+	/** \brief Part of \p time spent waiting for requests to complete, in seconds. */
+	double waitTime = 0;
+};
+
+/** \brief Records the calls to the functions of Communicator and to the wait() and isCompleted() of the requests,
+  when NiceMPI is built with the CMake option NICEMPI_PROFILING. Otherwise, nothing is recorded and the
+  instrumentation costs nothing. Only the outermost call is recorded, so that a function implemented with others
+  is counted once. The Initializer writes the files asked by setOutput() before MPI is finalized. Thread-safe. */
+class Profiler {
+public:
+	/** \brief Imbalance of an operation across the processes: minimum, mean and maximum of its time. */
+	struct Imbalance {
+		/** \brief Shortest time, in seconds. */
+		double minimum;
+		/** \brief Mean time, in seconds. */
+		double mean;
+		/** \brief Longest time, in seconds. */
+		double maximum;
+	};
+
+	/** \brief Writes, for each process, the summary of the statistics in \p prefix.<rank>.txt and, if \p trace,
+  the calls in a Chrome trace, readable by Perfetto, in \p prefix.<rank>.json. If \p imbalance, the first process
+  also writes the imbalance of the operations across the processes in \p prefix.imbalance.txt. The calls are
+  traced from now on. An empty \p prefix writes nothing. */
+	static void setOutput(const std::string& prefix, bool trace = false, bool imbalance = false);
+	/** \brief Writes the files asked by setOutput(). Called by the Initializer before MPI is finalized. Collective
+  on MPI_COMM_WORLD if an imbalance report was asked. */
+	static void finish();
+
+	/** \brief Returns the imbalance of the time of each operation, made with allReduce on \p communicator.
+  Collective: every process returns the operations recorded by any of them. */
+	static std::map<std::string,Imbalance> imbalance(MPI_Comm communicator);
+	/** \brief Returns the statistics recorded, by operation. */
+	static std::map<std::string,ProfiledStatistics> statistics();
+	/** \brief Records a call to \p operation, with \p bytes, from \p start to \p end, in seconds, waiting for a
+  request if \p isWait. */
+	static void record(const char* operation, std::size_t bytes, double start, double end, bool isWait);
+	/** \brief Forgets the statistics and the calls traced. */
+	static void reset();
+	/** \brief Writes the imbalance across \p communicator, one operation per line. Collective. */
+	static void writeImbalance(std::ostream& out, MPI_Comm communicator);
+	/** \brief Writes the statistics, one operation per line. */
+	static void writeSummary(std::ostream& out);
+	/** \brief Writes the calls traced since setOutput() in the JSON format of the Chrome traces, with \p process
+  as their process id. */
+	static void writeTrace(std::ostream& out, int process);
+};
+
+
+
+/** \brief Records in the Profiler the call that lasts as long as this object, unless it is nested in another
+  call recorded on the same thread. */
+class ProfiledCall {
+public:
+	/** \brief Starts the call to \p operation, with \p bytes, that waits for a request if \p isWait. */
+	ProfiledCall(const char* operation, std::size_t bytes = 0, bool isWait = false);
+	/** \brief Records the call. */
+	~ProfiledCall();
+	/** \brief A call is recorded once. */
+	ProfiledCall(const ProfiledCall&) = delete;
+	/** \brief A call is recorded once. */
+	ProfiledCall& operator=(const ProfiledCall&) = delete;
+
+private:
+	/** \brief Name of the operation. */
+	const char* operation;
+	/** \brief Bytes given to the call. */
+	std::size_t bytes;
+	/** \brief True for the wait of a request. */
+	bool isWait;
+	/** \brief False if the call is nested in another one. */
+	bool isOutermost;
+	/** \brief MPI_Wtime at the start of the call. */
+	double start;
+};
+
+
+
+/** \brief Returns the bytes of \p data, a collection like a std::vector or a Span. Zero for the collections of
+  types that are serialized. */
+template<class Type>
+auto profiledBytes(const Type& data, int) -> decltype(data.size()*sizeof(*data.data())) {
+	using Element = typename std::remove_reference<decltype(*data.data())>::type;
+	return std::is_trivially_copyable<Element>::value ? data.size()*sizeof(Element) : 0;
+}
+/** \brief Returns the bytes of \p data, a single element. Zero for the types that are serialized. */
+template<class Type>
+std::size_t profiledBytes(const Type&, long) {
+	return std::is_trivially_copyable<Type>::value ? sizeof(Type) : 0;
+}
+
+} // NiceMPi
+
+#ifdef NICEMPI_PROFILING
+	/** \brief Records the current function of Communicator, with the bytes of its \p data. */
+	#define NICEMPI_PROFILE(data) ::NiceMPI::ProfiledCall niceMPIprofiledCall(__func__,::NiceMPI::profiledBytes(data,0))
+	/** \brief Records the current function of Communicator, without data. */
+	#define NICEMPI_PROFILE_CALL() ::NiceMPI::ProfiledCall niceMPIprofiledCall(__func__)
+	/** \brief Records the wait for a request, as the \p operation. */
+	#define NICEMPI_PROFILE_WAIT(operation) ::NiceMPI::ProfiledCall niceMPIprofiledCall(operation,0,true)
+#else
+	#define NICEMPI_PROFILE(data)
+	#define NICEMPI_PROFILE_CALL()
+	#define NICEMPI_PROFILE_WAIT(operation)
+#endif
+
+#endif  /* PROFILER_H */
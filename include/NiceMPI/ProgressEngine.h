@@ -0,0 +1,71 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef PROGRESSENGINE_H
+#define PROGRESSENGINE_H
+
+#include <chrono> // std::chrono::microseconds
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+#include <mpi.h> // MPI_Request
+
+namespace NiceMPI {
+
+/** \brief Progresses the requests handed over with SendRequest::then() and ReceiveRequest::then(), and calls their
+  continuations when they complete. The requests are progressed by poll(), called by the user, or by a background
+  thread started with startThread(). */
+class ProgressEngine {
+public:
+	/** \brief Called each time the request of an operation completes. Returns true if the operation is finished,
+  or false if it started another step in the request. */
+	using Advance = std::function<bool(MPI_Request&)>;
+
+	/** \brief Takes care of the \p request. \p advance is called each time it completes, or at the next poll if it
+  is MPI_REQUEST_NULL, and then \p finish is called once, by the thread that polls, when \p advance returns true.
+  The receive requests are \p cancellable, so that a receive that is never matched doesn't stop the
+  finalization. */
+	static void add(MPI_Request request, Advance advance, std::function<void()> finish, bool cancellable);
+	/** \brief Stops the background thread, finishes the operations that are not cancellable, and gives the other
+  ones to DetachedRequests without calling their continuation. Called before MPI is finalized, hence it doesn't
+  throw: an exception of the background thread not rethrown yet, and the exceptions thrown by the steps and the
+  continuations of the operations it finishes, are dropped. */
+	static void finishAll();
+	/** \brief Returns the number of operations not finished yet. */
+	static std::size_t pendingCount();
+	/** \brief Progresses the requests with MPI_Testsome, without blocking, and calls the continuations of the
+  operations finished. Returns the number of operations finished. The continuations are called without lock,
+  hence they can hand over other requests. If some continuations throw, the other ones are still called, and the
+  first exception is rethrown. An exception thrown by a step of an operation finishes it, and is rethrown the
+  same way instead of calling its continuation. Rethrows first the exception that stopped the background thread,
+  if any. */
+	static std::size_t poll();
+	/** \brief Starts a background thread that polls every \p interval. Requires MPI_THREAD_MULTIPLE, see
+  Initializer. The continuations are then called by this thread. The thread stops at the first exception thrown
+  by poll() or by a continuation, which is then rethrown by the next call to poll() or stopThread(). */
+	static void startThread(std::chrono::microseconds interval = std::chrono::microseconds{50});
+	/** \brief Stops the background thread, if one was started. Rethrows the exception that stopped it, if any. */
+	static void stopThread();
+};
+
+} // NiceMPi
+
+#endif  /* PROGRESSENGINE_H */
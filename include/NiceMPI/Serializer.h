@@ -0,0 +1,260 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <cstring> // std::memcpy
+#include <map>
+#include <string>
+#include <type_traits> // std::enable_if, std::is_trivially_copyable
+#include <utility> // std::pair
+#include <vector>
+
+namespace NiceMPI {
+
+/** \brief Type traits that packs a \p Type in bytes, so that types that are not trivially copyable, like strings,
+  nested vectors or maps, can be communicated. A specialization defines isDefined as true, and the static
+  functions size(const Type&), which returns the number of bytes packed, write(const Type&, unsigned char*&) and
+  read(Type&, const unsigned char*&), which advance the pointer past the bytes they use. Users can specialize it
+  for their types. By default, no serialization is defined. */
+template<class Type, class Enable = void>
+struct Serializer {
+	/** \brief True if the serialization of \p Type is defined. */
+	static constexpr bool isDefined = false;
+};
+
+/** \brief Trivially copyable types are packed as their bytes. *Specialization*. */
+template<class Type>
+struct Serializer<Type, typename std::enable_if<std::is_trivially_copyable<Type>::value>::type> {
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Type&) {
+		return sizeof(Type);
+	}
+	static void write(const Type& data, unsigned char*& out) {
+		std::memcpy(out,&data,sizeof(Type));
+		out += sizeof(Type);
+	}
+	static void read(Type& data, const unsigned char*& in) {
+		std::memcpy(&data,in,sizeof(Type));
+		in += sizeof(Type);
+	}
+};
+
+/** \brief Packs the \p count elements at \p data, as a single block of bytes if they are trivially
+  copyable. */
+template<class Type>
+struct SerializerOfElements {
+	/** \brief Returns the number of bytes of the \p count elements at \p data. */
+	template<class Iterator>
+	static std::size_t size(Iterator data, std::size_t count) {
+		return sizeOf(data,count,std::is_trivially_copyable<Type>{});
+	}
+	/** \brief Packs the \p count elements at \p data in \p out. */
+	template<class Iterator>
+	static void write(Iterator data, std::size_t count, unsigned char*& out) {
+		writeOf(data,count,out,std::is_trivially_copyable<Type>{});
+	}
+	/** \brief Unpacks \p count elements from \p in to \p data. */
+	template<class Iterator>
+	static void read(Iterator data, std::size_t count, const unsigned char*& in) {
+		readOf(data,count,in,std::is_trivially_copyable<Type>{});
+	}
+
+private:
+	/** \brief Returns the number of bytes of \p count trivially copyable elements. */
+	template<class Iterator>
+	static std::size_t sizeOf(Iterator, std::size_t count, std::true_type) {
+		return count*sizeof(Type);
+	}
+	/** \brief Returns the sum of the number of bytes of the \p count elements at \p data. */
+	template<class Iterator>
+	static std::size_t sizeOf(Iterator data, std::size_t count, std::false_type) {
+		std::size_t result = 0;
+		for(std::size_t i = 0; i < count; ++i, ++data) result += Serializer<Type>::size(*data);
+		return result;
+	}
+	/** \brief Copies the bytes of \p count trivially copyable elements at \p data in \p out. */
+	static void writeOf(const Type* data, std::size_t count, unsigned char*& out, std::true_type) {
+		std::memcpy(out,data,count*sizeof(Type));
+		out += count*sizeof(Type);
+	}
+	/** \brief Packs the \p count elements at \p data in \p out, one by one. */
+	template<class Iterator>
+	static void writeOf(Iterator data, std::size_t count, unsigned char*& out, std::false_type) {
+		for(std::size_t i = 0; i < count; ++i, ++data) Serializer<Type>::write(*data,out);
+	}
+	/** \brief Copies the bytes of \p count trivially copyable elements from \p in to \p data. */
+	static void readOf(Type* data, std::size_t count, const unsigned char*& in, std::true_type) {
+		std::memcpy(data,in,count*sizeof(Type));
+		in += count*sizeof(Type);
+	}
+	/** \brief Unpacks \p count elements from \p in to \p data, one by one. */
+	template<class Iterator>
+	static void readOf(Iterator data, std::size_t count, const unsigned char*& in, std::false_type) {
+		for(std::size_t i = 0; i < count; ++i, ++data) Serializer<Type>::read(*data,in);
+	}
+};
+
+/** \brief Strings are packed as their size followed by their characters. *Specialization*. */
+template<class Char, class Traits, class Allocator>
+struct Serializer<std::basic_string<Char,Traits,Allocator>,
+	typename std::enable_if<Serializer<Char>::isDefined>::type>
+{
+	using Type = std::basic_string<Char,Traits,Allocator>;
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Type& data) {
+		return sizeof(std::uint64_t) + SerializerOfElements<Char>::size(data.data(),data.size());
+	}
+	static void write(const Type& data, unsigned char*& out) {
+		Serializer<std::uint64_t>::write(data.size(),out);
+		SerializerOfElements<Char>::write(data.data(),data.size(),out);
+	}
+	static void read(Type& data, const unsigned char*& in) {
+		std::uint64_t count = 0;
+		Serializer<std::uint64_t>::read(count,in);
+		data.resize(count);
+		SerializerOfElements<Char>::read(&data[0],count,in);
+	}
+};
+
+/** \brief Vectors are packed as their size followed by their elements, in a single copy if the elements are
+  trivially copyable. *Specialization*. */
+template<class Element, class Allocator>
+struct Serializer<std::vector<Element,Allocator>,
+	typename std::enable_if<Serializer<Element>::isDefined and !std::is_same<Element,bool>::value>::type>
+{
+	using Type = std::vector<Element,Allocator>;
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Type& data) {
+		return sizeof(std::uint64_t) + SerializerOfElements<Element>::size(data.data(),data.size());
+	}
+	static void write(const Type& data, unsigned char*& out) {
+		Serializer<std::uint64_t>::write(data.size(),out);
+		SerializerOfElements<Element>::write(data.data(),data.size(),out);
+	}
+	static void read(Type& data, const unsigned char*& in) {
+		std::uint64_t count = 0;
+		Serializer<std::uint64_t>::read(count,in);
+		data.resize(count);
+		SerializerOfElements<Element>::read(data.data(),count,in);
+	}
+};
+
+/** \brief Pairs are packed as their first then their second member. *Specialization*. */
+template<class First, class Second>
+struct Serializer<std::pair<First,Second>,
+	typename std::enable_if<Serializer<First>::isDefined and Serializer<Second>::isDefined and
+		!std::is_trivially_copyable<std::pair<First,Second>>::value>::type>
+{
+	using Type = std::pair<First,Second>;
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Type& data) {
+		return Serializer<First>::size(data.first) + Serializer<Second>::size(data.second);
+	}
+	static void write(const Type& data, unsigned char*& out) {
+		Serializer<First>::write(data.first,out);
+		Serializer<Second>::write(data.second,out);
+	}
+	static void read(Type& data, const unsigned char*& in) {
+		Serializer<First>::read(data.first,in);
+		Serializer<Second>::read(data.second,in);
+	}
+};
+
+/** \brief Maps are packed as their size followed by their keys and values, in order. *Specialization*. */
+template<class Key, class Value, class Compare, class Allocator>
+struct Serializer<std::map<Key,Value,Compare,Allocator>,
+	typename std::enable_if<Serializer<Key>::isDefined and Serializer<Value>::isDefined>::type>
+{
+	using Type = std::map<Key,Value,Compare,Allocator>;
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Type& data) {
+		std::size_t result = sizeof(std::uint64_t);
+		for(auto&& x: data) result += Serializer<Key>::size(x.first) + Serializer<Value>::size(x.second);
+		return result;
+	}
+	static void write(const Type& data, unsigned char*& out) {
+		Serializer<std::uint64_t>::write(data.size(),out);
+		for(auto&& x: data) {
+			Serializer<Key>::write(x.first,out);
+			Serializer<Value>::write(x.second,out);
+		}
+	}
+	static void read(Type& data, const unsigned char*& in) {
+		std::uint64_t count = 0;
+		Serializer<std::uint64_t>::read(count,in);
+		data.clear();
+		for(std::uint64_t i = 0; i < count; ++i) {
+			Key key;
+			Serializer<Key>::read(key,in);
+			Serializer<Value>::read(data.emplace_hint(data.end(),std::move(key),Value{})->second,in);
+		}
+	}
+};
+
+
+
+/** \brief True if \p Type is communicated through its Serializer: the other types are trivially copyable, or
+  collections of trivially copyable elements, which are communicated directly. */
+template<class Type, class Enable = void>
+struct is_serialized {
+	static constexpr bool value = Serializer<Type>::isDefined and !std::is_trivially_copyable<Type>::value;
+};
+/** \brief True if \p Type is communicated through its Serializer. Collections of trivially copyable and copy
+  assignable elements are communicated directly. *Specialization*.*/
+template<class Type>
+struct is_serialized<Type, typename std::enable_if<std::is_trivially_copyable<typename Type::value_type>::value and
+	std::is_copy_assignable<typename Type::value_type>::value>::type>
+{
+	static constexpr bool value = false;
+};
+
+
+
+/** \brief Returns the buffer of the calling thread, reused by the blocking communications of serialized data so
+  that they do not allocate once it is large enough. */
+inline std::vector<unsigned char>& serializationBuffer() {
+	thread_local std::vector<unsigned char> buffer;
+	return buffer;
+}
+
+/** \brief Packs \p data in \p buffer, resized to the packed size. */
+template<class Type>
+void serialize(const Type& data, std::vector<unsigned char>& buffer) {
+	buffer.resize(Serializer<Type>::size(data));
+	unsigned char* out = buffer.data();
+	Serializer<Type>::write(data,out);
+}
+/** \brief Unpacks the data of type \p Type in the \p buffer. */
+template<class Type>
+Type deserialize(const std::vector<unsigned char>& buffer) {
+	Type result{};
+	const unsigned char* in = buffer.data();
+	Serializer<Type>::read(result,in);
+	return result;
+}
+
+} // NiceMPi
+
+#endif  /* SERIALIZER_H */
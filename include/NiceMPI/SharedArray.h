@@ -0,0 +1,109 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef SHAREDARRAY_H
+#define SHAREDARRAY_H
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <mpi.h> // MPI_Barrier
+#include <NiceMPI/NiceMPI.h> // Communicator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Window.h> // Window
+
+namespace NiceMPI {
+
+/** \brief Array of \p Type elements allocated once for the processes of a node, which all load and store them
+  directly. Typically, the \p owner fills the array, and after synchronize() every process reads the one copy of
+  the node, instead of holding its own copy. The array is a shared memory window, kept in a passive target epoch
+  for its whole life. */
+template<class Type>
+class SharedArray {
+public:
+	/** \brief Allocates \p count elements on the process \p owner of \p node, which must be made of processes that
+  can share memory, like the ones given by Communicator::splitShared(). Collective on \p node. The elements are not
+  initialized. */
+	SharedArray(const Communicator& node, std::size_t count, int owner = 0)
+	: communicator(node.shared()), window(Window<Type>::allocateShared(node,node.rank() == owner ? count : 0)),
+		elements(window.sharedMemory(owner))
+	{
+		window.lockAll();
+	}
+	/** \brief Ends the passive target epoch. The memory is freed with the window, collectively. */
+	~SharedArray() {
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+		if(window.get() == MPI_WIN_NULL or finalized) return;
+		int error = MPI_Win_unlock_all(window.get());
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Called from destructors, can't throw
+	}
+	/** \brief This object can only be moved, since it owns a window. **/
+	SharedArray(const SharedArray&) = delete;
+	/** \brief This object can only be moved, since it owns a window. **/
+	SharedArray(SharedArray&&) = default;
+	/** \brief This object can only be moved, since it owns a window. **/
+	SharedArray& operator=(const SharedArray&) = delete;
+	/** \brief Can't be assigned, since freeing the window is collective. **/
+	SharedArray& operator=(SharedArray&&) = delete;
+
+	/** \brief Returns the element \p i. */
+	Type& operator[](std::size_t i) const {
+		assert(i < size());
+		return elements[i];
+	}
+	/** \brief Returns an iterator on the first element. */
+	Type* begin() const {
+		return elements.begin();
+	}
+	/** \brief Returns the address of the first element. */
+	Type* data() const {
+		return elements.data();
+	}
+	/** \brief Returns an iterator past the last element. */
+	Type* end() const {
+		return elements.end();
+	}
+	/** \brief Returns the number of elements. */
+	std::size_t size() const {
+		return elements.size();
+	}
+	/** \brief Makes the stores of every process of the node visible to the others: the loads that follow see the
+  stores that precede. Collective. */
+	void synchronize() {
+		window.sync();
+		handleError(MPI_Barrier(communicator.get()));
+		window.sync();
+	}
+
+private:
+	/** \brief Processes of the node. */
+	Communicator communicator;
+	/** \brief Shared memory window that owns the elements. */
+	Window<Type> window;
+	/** \brief Elements, in the memory of the owner. */
+	Span<Type> elements;
+};
+
+} // NiceMPi
+
+#endif  /* SHAREDARRAY_H */
@@ -0,0 +1,129 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <array>
+#include <cstddef> // std::size_t
+#include <type_traits> // std::remove_const
+#include <vector>
+
+namespace NiceMPI {
+
+/** \brief Non-owning view of \p size contiguous elements of type \p Type. Used to communicate data in place, in
+  memory provided by the caller, without allocation. */
+template<class Type>
+class Span {
+public:
+	/** \brief Type of the elements, without const qualification. */
+	using value_type = typename std::remove_const<Type>::type;
+
+	/** \brief Creates a view of the \p size elements that start at \p data. */
+	Span(Type* data, std::size_t size): first(data), count(size)
+	{}
+	/** \brief A view of non-const elements can be used as a view of const elements. */
+	template<class OtherType>
+	Span(const Span<OtherType>& rhs): first(rhs.data()), count(rhs.size())
+	{}
+
+	/** \brief Returns the address of the first element. */
+	Type* data() const {
+		return first;
+	}
+	/** \brief Returns the number of elements. */
+	std::size_t size() const {
+		return count;
+	}
+	/** \brief Returns true if the view contains no element. */
+	bool empty() const {
+		return count == 0;
+	}
+	/** \brief Returns the element \p i. */
+	Type& operator[](std::size_t i) const {
+		return first[i];
+	}
+	/** \brief Returns an iterator on the first element. */
+	Type* begin() const {
+		return first;
+	}
+	/** \brief Returns an iterator past the last element. */
+	Type* end() const {
+		return first + count;
+	}
+	/** \brief Returns a view of the \p size elements that start at element \p offset. */
+	Span subspan(std::size_t offset, std::size_t size) const {
+		return Span(first + offset, size);
+	}
+
+private:
+	/** \brief Address of the first element. */
+	Type* first;
+	/** \brief Number of elements. */
+	std::size_t count;
+};
+
+
+
+/** \brief Spans are collections, but they are communicated in place, so we need to distinguish them. */
+template<class T>
+struct is_span {
+	static constexpr bool value = false;
+};
+/** \brief Spans are collections, but they are communicated in place, so we need to distinguish them.
+  *Specialization*.*/
+template<class T>
+struct is_span<Span<T>> {
+	static constexpr bool value = true;
+};
+
+
+
+/** \brief Returns a view of the \p size elements that start at \p data. */
+template<class Type>
+Span<Type> makeSpan(Type* data, std::size_t size) {
+	return Span<Type>(data,size);
+}
+/** \brief Returns a view of the elements of \p data. */
+template<class Type, class Allocator>
+Span<Type> makeSpan(std::vector<Type,Allocator>& data) {
+	return Span<Type>(data.data(),data.size());
+}
+/** \brief Returns a view of the elements of \p data. */
+template<class Type, class Allocator>
+Span<const Type> makeSpan(const std::vector<Type,Allocator>& data) {
+	return Span<const Type>(data.data(),data.size());
+}
+/** \brief Returns a view of the elements of \p data. */
+template<class Type, std::size_t N>
+Span<Type> makeSpan(std::array<Type,N>& data) {
+	return Span<Type>(data.data(),N);
+}
+/** \brief Returns a view of the elements of \p data. */
+template<class Type, std::size_t N>
+Span<const Type> makeSpan(const std::array<Type,N>& data) {
+	return Span<const Type>(data.data(),N);
+}
+
+} // NiceMPi
+
+#endif  /* SPAN_H */
@@ -0,0 +1,153 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef STRIDEDVIEW_H
+#define STRIDEDVIEW_H
+
+#include <cstddef> // std::size_t
+#include <map>
+#include <mpi.h> // MPI_Datatype
+#include <mutex>
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <type_traits> // std::remove_const
+#include <vector>
+
+namespace NiceMPI {
+
+/** \brief Non-owning view of elements of type \p Type that are not contiguous in memory, like a column of a matrix
+  or a block of a grid. It is communicated in place as one element of a committed derived datatype, so that MPI can
+  gather and scatter the elements directly in the memory of the caller, without packing. The datatypes are cached:
+  views of the same shape share a datatype, created once and never freed. */
+template<class Type>
+class StridedView {
+public:
+	/** \brief A view of non-const elements can be used as a view of const elements. */
+	template<class OtherType>
+	StridedView(const StridedView<OtherType>& rhs): first(rhs.data()), type(rhs.datatype()), count(rhs.size())
+	{}
+
+	/** \brief Returns \p count blocks of \p blockLength elements, whose first elements are separated by \p stride
+  elements, the first block starting at \p data. */
+	static StridedView vector(Type* data, int count, int blockLength, int stride) {
+		return StridedView(data,cached({0,count,blockLength,stride},[&](MPI_Datatype* result) {
+			return MPI_Type_vector(count,blockLength,stride,mpi_datatype<Element>::get(),result);
+		}),static_cast<std::size_t>(count)*blockLength);
+	}
+	/** \brief Returns the block of \p subshape elements, that starts at \p start, of the row-major array of
+  \p shape elements at \p data. The three vectors must have the same size. */
+	static StridedView subarray(Type* data, const std::vector<int>& shape, const std::vector<int>& subshape,
+		const std::vector<int>& start)
+	{
+		if(shape.empty() or subshape.size() != shape.size() or start.size() != shape.size()) {
+			handleError(MPI_ERR_DIMS);
+		}
+		std::vector<int> key{1};
+		key.insert(key.end(),shape.begin(),shape.end());
+		key.insert(key.end(),subshape.begin(),subshape.end());
+		key.insert(key.end(),start.begin(),start.end());
+		std::size_t size = 1;
+		for(int x: subshape) size *= x;
+		return StridedView(data,cached(key,[&](MPI_Datatype* result) {
+			return MPI_Type_create_subarray(static_cast<int>(shape.size()),shape.data(),subshape.data(),start.data(),
+				MPI_ORDER_C,mpi_datatype<Element>::get(),result);
+		}),size);
+	}
+
+	/** \brief Returns the address from which the datatype is applied: the first block of a vector, or the first
+  element of the whole array of a subarray. */
+	Type* data() const {
+		return first;
+	}
+	/** \brief Returns the committed datatype that describes the elements, relatively to data(). */
+	MPI_Datatype datatype() const {
+		return type;
+	}
+	/** \brief Returns the number of elements in the view. */
+	std::size_t size() const {
+		return count;
+	}
+
+private:
+	/** \brief Type of the elements, without const qualification. */
+	using Element = typename std::remove_const<Type>::type;
+
+	/** \brief Initializes this view with its members. */
+	StridedView(Type* data, MPI_Datatype type, std::size_t count): first(data), type(type), count(count)
+	{}
+
+	/** \brief Returns the committed datatype of the shape \p key, created by \p create the first time. */
+	template<class Create>
+	static MPI_Datatype cached(const std::vector<int>& key, Create create) {
+		static std::mutex mutex;
+		static std::map<std::vector<int>,MPI_Datatype> datatypes;
+		std::lock_guard<std::mutex> lock(mutex);
+		const auto found = datatypes.find(key);
+		if(found != datatypes.end()) return found->second;
+		MPI_Datatype datatype;
+		handleError(create(&datatype));
+		handleError(MPI_Type_commit(&datatype));
+		datatypes.emplace(key,datatype);
+		return datatype;
+	}
+
+	/** \brief Address from which the datatype is applied. */
+	Type* first;
+	/** \brief Committed datatype of the elements. */
+	MPI_Datatype type;
+	/** \brief Number of elements. */
+	std::size_t count;
+};
+
+
+
+/** \brief Strided views are communicated as the elements they refer to, so we need to distinguish them. */
+template<class T>
+struct is_strided_view {
+	static constexpr bool value = false;
+};
+/** \brief Strided views are communicated as the elements they refer to, so we need to distinguish them.
+  *Specialization*.*/
+template<class T>
+struct is_strided_view<StridedView<T>> {
+	static constexpr bool value = true;
+};
+
+
+
+/** \brief Returns a view of \p count blocks of \p blockLength elements, whose first elements are separated by
+  \p stride elements, the first block starting at \p data. */
+template<class Type>
+StridedView<Type> stridedView(Type* data, int count, int blockLength, int stride) {
+	return StridedView<Type>::vector(data,count,blockLength,stride);
+}
+/** \brief Returns a view of the block of \p subshape elements, that starts at \p start, of the row-major array of
+  \p shape elements at \p data. */
+template<class Type>
+StridedView<Type> subarrayView(Type* data, const std::vector<int>& shape, const std::vector<int>& subshape,
+	const std::vector<int>& start)
+{
+	return StridedView<Type>::subarray(data,shape,subshape,start);
+}
+
+} // NiceMPi
+
+#endif  /* STRIDEDVIEW_H */
@@ -0,0 +1,279 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef WINDOW_H
+#define WINDOW_H
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <functional> // std::plus
+#include <list>
+#include <type_traits> // std::is_trivially_copyable, std::is_integral
+#include <utility> // std::pair
+#include <mpi.h> // MPI_Win
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/MPIoperator.h> // mpi_operator
+#include <NiceMPI/NiceMPI.h> // Communicator
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/Span.h> // Span
+#include "private/LargeCount.h"
+
+namespace NiceMPI {
+
+/** \brief Memory of \p Type elements exposed by every process of a communicator to one-sided operations: the
+  processes put, get and accumulate elements in the memory of a target process, which doesn't have to post any
+  receive. The operations complete at the end of an epoch: between two calls to fence(), for all the processes,
+  or in a passive target epoch, between lockAll() and unlockAll(), in which flush() completes the operations on a
+  target. The displacements are in elements for the windows allocated by the constructor, and they are addresses
+  returned by attach() for dynamic windows. */
+template<class Type>
+class Window {
+	static_assert(std::is_trivially_copyable<Type>::value,
+		"Only trivially copyable types can be accessed through a window.");
+public:
+	/** \brief Allocates \p count elements on this process, with MPI_Win_allocate. Collective on \p communicator,
+  but each process can give a different \p count. The elements are not initialized. */
+	Window(const Communicator& communicator, std::size_t count)
+	: value(MPI_WIN_NULL), base(nullptr), count(count), displacementUnit(sizeof(Type))
+	{
+		handleError(MPI_Win_allocate(static_cast<MPI_Aint>(count*sizeof(Type)),static_cast<int>(sizeof(Type)),
+			MPI_INFO_NULL,communicator.get(),&base,&value));
+	}
+	/** \brief Allocates \p count elements on this process, with MPI_Win_allocate_shared, in memory that the other
+  processes of \p communicator can load and store directly, see sharedMemory(). The \p communicator must be made of
+  processes that can share memory, like the ones given by Communicator::splitShared(). Collective. */
+	static Window allocateShared(const Communicator& communicator, std::size_t count) {
+		Window x;
+		x.count = count;
+		x.displacementUnit = sizeof(Type);
+		handleError(MPI_Win_allocate_shared(static_cast<MPI_Aint>(count*sizeof(Type)),static_cast<int>(sizeof(Type)),
+			MPI_INFO_NULL,communicator.get(),&x.base,&x.value));
+		return x;
+	}
+	/** \brief Creates a window without memory, with MPI_Win_create_dynamic. The memory is given later with
+  attach(). Collective on \p communicator. */
+	static Window createDynamic(const Communicator& communicator) {
+		Window x;
+		handleError(MPI_Win_create_dynamic(MPI_INFO_NULL,communicator.get(),&x.value));
+		return x;
+	}
+	/** \brief Frees the window with the collective MPI_Win_free, if MPI is not finalized yet. */
+	~Window() {
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+		if(value == MPI_WIN_NULL or finalized) return;
+		int error = MPI_Win_free(&value);
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Ignore MPI_Win_free error in release
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	Window(const Window&) = delete;
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	Window(Window&& rhs)
+	: value(rhs.value), base(rhs.base), count(rhs.count), displacementUnit(rhs.displacementUnit)
+	{
+		rhs.value = MPI_WIN_NULL;
+		rhs.base = nullptr;
+		rhs.count = 0;
+		pending.swap(rhs.pending);
+	}
+	/** \brief This object can only be moved, since it owns a MPI implementation. **/
+	Window& operator=(const Window&) = delete;
+	/** \brief Can't be assigned, since freeing the window is collective. **/
+	Window& operator=(Window&&) = delete;
+
+	/** \brief Returns the elements allocated on this process. Empty for a dynamic window. */
+	Span<Type> local() const {
+		return Span<Type>(static_cast<Type*>(base),count);
+	}
+	/** \brief Returns the elements allocated by the process \p rank in a window created by allocateShared(), which
+  this process can load and store directly. The accesses must be synchronized, for instance with sync() and a
+  barrier in a passive target epoch. */
+	Span<Type> sharedMemory(int rank) const {
+		MPI_Aint size = 0;
+		int unit = 0;
+		void* memory = nullptr;
+		handleError(MPI_Win_shared_query(value,rank,&size,&unit,&memory));
+		return Span<Type>(static_cast<Type*>(memory),static_cast<std::size_t>(size)/sizeof(Type));
+	}
+	/** \brief Returns the MPI implementation. Minimize its use. */
+	MPI_Win get() const {
+		return value;
+	}
+
+	/** \brief Exposes the \p memory of this process in a dynamic window. It must stay alive until it is detached.
+  Returns the address of the memory, to be given to the other processes as the displacement of their operations.*/
+	MPI_Aint attach(Span<Type> memory) {
+		handleError(MPI_Win_attach(value,memory.data(),static_cast<MPI_Aint>(memory.size()*sizeof(Type))));
+		MPI_Aint address;
+		handleError(MPI_Get_address(memory.data(),&address));
+		return address;
+	}
+	/** \brief Stops exposing the \p memory previously attached to a dynamic window. */
+	void detach(Span<Type> memory) {
+		handleError(MPI_Win_detach(value,memory.data()));
+	}
+	/** \brief Returns the displacement of the element \p index of the memory whose displacement is \p first. */
+	MPI_Aint displace(MPI_Aint first, std::size_t index) const {
+		return displacementUnit == 1 ? MPI_Aint_add(first,static_cast<MPI_Aint>(index*sizeof(Type))) :
+			first + static_cast<MPI_Aint>(index);
+	}
+
+	/** \brief Completes the operations of every process on this window, and starts a new epoch. Collective. */
+	void fence() {
+		handleError(MPI_Win_fence(0,value));
+		pending.clear();
+	}
+	/** \brief Completes the operations of this process that target \p rank, in a passive target epoch. */
+	void flush(int rank) {
+		handleError(MPI_Win_flush(rank,value));
+		release(rank);
+	}
+	/** \brief Completes the operations of this process, in a passive target epoch. */
+	void flushAll() {
+		handleError(MPI_Win_flush_all(value));
+		pending.clear();
+	}
+	/** \brief Completes the operations of this process that target \p rank locally: the buffers given to them can
+  be reused, but the operations may not be visible at the target yet. */
+	void flushLocal(int rank) {
+		handleError(MPI_Win_flush_local(rank,value));
+		release(rank);
+	}
+	/** \brief Starts a passive target epoch on the process \p rank. An \p exclusive lock excludes the operations of
+  the other processes. */
+	void lock(int rank, bool exclusive = false) {
+		handleError(MPI_Win_lock(exclusive ? MPI_LOCK_EXCLUSIVE : MPI_LOCK_SHARED,rank,0,value));
+	}
+	/** \brief Starts a passive target epoch on every process, with a shared lock. */
+	void lockAll() {
+		handleError(MPI_Win_lock_all(0,value));
+	}
+	/** \brief Synchronizes the local memory with the operations of the other processes, in a passive target epoch.*/
+	void sync() {
+		handleError(MPI_Win_sync(value));
+	}
+	/** \brief Ends the passive target epoch on the process \p rank, completing the operations that target it. */
+	void unlock(int rank) {
+		handleError(MPI_Win_unlock(rank,value));
+		release(rank);
+	}
+	/** \brief Ends the passive target epoch started by lockAll(), completing the operations of this process. */
+	void unlockAll() {
+		handleError(MPI_Win_unlock_all(value));
+		pending.clear();
+	}
+
+	/** \brief Adds \p data to the element at \p displacement in the memory of \p rank, atomically, with \p op.
+  Completes at the end of the epoch. Only for the native types and the predefined MPI_Op, like MPI_SUM or
+  MPI_REPLACE. */
+	template<class Operator = std::plus<Type>>
+	void accumulate(Type data, int rank, MPI_Aint displacement, Operator op = Operator{}) {
+		static_assert(mpi_datatype<Type>::isNative, "Only the native types can be accumulated.");
+		accumulate(Span<const Type>(hold(data,rank),1),rank,displacement,op);
+	}
+	/** \brief Same as accumulate(), for the \p data added to the elements that start at \p displacement. The \p
+  data must stay alive until the operation completes. */
+	template<class Operator = std::plus<Type>>
+	void accumulate(Span<const Type> data, int rank, MPI_Aint displacement, Operator op = Operator{}) {
+		static_assert(mpi_datatype<Type>::isNative, "Only the native types can be accumulated.");
+		handleError(LargeCount::accumulate(data.data(),data.size(),mpi_datatype<Type>::get(),rank,displacement,
+			mpi_operator<Operator,Type>::get(op),value));
+	}
+	/** \brief Replaces the element at \p displacement in the memory of \p rank by \p data if it is equal to \p
+  compare, atomically, and returns its previous value. Flushes the operations that target \p rank, in a passive
+  target epoch. Only for the integral types. */
+	Type compareAndSwap(Type data, Type compare, int rank, MPI_Aint displacement) {
+		static_assert(std::is_integral<Type>::value, "Only the integral types can be compared and swapped.");
+		Type result;
+		handleError(MPI_Compare_and_swap(&data,&compare,&result,mpi_datatype<Type>::get(),rank,displacement,value));
+		flush(rank);
+		return result;
+	}
+	/** \brief Applies \p op to \p data and the element at \p displacement in the memory of \p rank, atomically, and
+  returns its previous value. Flushes the operations that target \p rank, in a passive target epoch. Only for the
+  native types and the predefined MPI_Op: MPI_NO_OP reads atomically. */
+	template<class Operator = std::plus<Type>>
+	Type fetchAndOp(Type data, int rank, MPI_Aint displacement, Operator op = Operator{}) {
+		static_assert(mpi_datatype<Type>::isNative, "Only the native types can be accumulated.");
+		Type result;
+		handleError(MPI_Fetch_and_op(&data,&result,mpi_datatype<Type>::get(),rank,displacement,
+			mpi_operator<Operator,Type>::get(op),value));
+		flush(rank);
+		return result;
+	}
+	/** \brief Returns the element at \p displacement in the memory of \p rank. Flushes the operations that target
+  \p rank, in a passive target epoch. */
+	Type get(int rank, MPI_Aint displacement) {
+		Type result;
+		get(Span<Type>(&result,1),rank,displacement);
+		flush(rank);
+		return result;
+	}
+	/** \brief Gets the elements that start at \p displacement in the memory of \p rank in \p result. Completes at
+  the end of the epoch, or when \p rank is flushed. */
+	void get(Span<Type> result, int rank, MPI_Aint displacement) {
+		handleError(LargeCount::get(result.data(),result.size(),mpi_datatype<Type>::get(),rank,displacement,value));
+	}
+	/** \brief Puts \p data in the element at \p displacement in the memory of \p rank. Completes at the end of the
+  epoch, or when \p rank is flushed. */
+	void put(Type data, int rank, MPI_Aint displacement) {
+		put(Span<const Type>(hold(data,rank),1),rank,displacement);
+	}
+	/** \brief Puts \p data in the elements that start at \p displacement in the memory of \p rank. The \p data must
+  stay alive until the operation completes. */
+	void put(Span<const Type> data, int rank, MPI_Aint displacement) {
+		handleError(LargeCount::put(data.data(),data.size(),mpi_datatype<Type>::get(),rank,displacement,value));
+	}
+
+private:
+	/** \brief Creates an empty dynamic window. */
+	Window(): value(MPI_WIN_NULL), base(nullptr), count(0), displacementUnit(1)
+	{}
+
+	/** \brief Keeps a copy of the \p data given by value to an operation that targets \p rank, until the operation
+  completes. Returns the address of the copy. */
+	const Type* hold(Type data, int rank) {
+		pending.emplace_back(rank,data);
+		return &pending.back().second;
+	}
+	/** \brief Frees the copies held for the operations that target \p rank. */
+	void release(int rank) {
+		pending.remove_if([rank](const std::pair<int,Type>& x) { return x.first == rank; });
+	}
+
+	/** \brief MPI implementation. */
+	MPI_Win value;
+	/** \brief Memory allocated on this process, if any. */
+	void* base;
+	/** \brief Number of elements allocated on this process. */
+	std::size_t count;
+	/** \brief Size of the unit of the displacements, in bytes: the size of Type, or 1 for a dynamic window. */
+	std::size_t displacementUnit;
+	/** \brief Copies of the data given by value to the operations not completed yet, with their target. A list,
+  so that the copies don't move. */
+	std::list<std::pair<int,Type>> pending;
+};
+
+} // NiceMPi
+
+#endif  /* WINDOW_H */
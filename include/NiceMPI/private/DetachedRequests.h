@@ -0,0 +1,50 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef DETACHEDREQUESTS_H
+#define DETACHEDREQUESTS_H
+
+#include <cstddef> // std::size_t
+#include <memory> // std::shared_ptr
+#include <mpi.h> // MPI_Request
+
+namespace NiceMPI {
+
+/** \brief Keeps alive the requests that are destroyed before their completion, together with the data they
+  depend on, until MPI completes them. Hence, a send can be started and forgotten without dangling buffer. */
+class DetachedRequests {
+public:
+	/** \brief Takes care of the \p request, and keeps the \p payload alive until the \p request completes. The
+  receive requests are \p cancellable, so that a receive that is never matched doesn't stop the finalization. */
+	static void add(MPI_Request request, std::shared_ptr<void> payload, bool cancellable);
+	/** \brief Cancels the cancellable requests, waits for the others, and frees every payloads. Called before
+  MPI is finalized. */
+	static void completeAll();
+	/** \brief Returns the number of requests not completed yet. */
+	static std::size_t pendingCount();
+	/** \brief Frees the payloads of the requests that are completed, without blocking. */
+	static void reap();
+};
+
+} // NiceMPi
+
+#endif  /* DETACHEDREQUESTS_H */
@@ -0,0 +1,1037 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#ifndef LARGECOUNT_H
+#define LARGECOUNT_H
+
+#include <array>
+#include <cstddef> // std::size_t
+#include <limits> // std::numeric_limits
+#include <memory> // std::shared_ptr
+#include <vector>
+#include <mpi.h>
+#include <NiceMPI/NiceMPIexception.h> // handleError
+
+namespace NiceMPI {
+
+/** \brief Largest count that can be given to the MPI functions that take an int count. */
+constexpr std::size_t maxIntCount = static_cast<std::size_t>(std::numeric_limits<int>::max());
+
+
+
+/** \brief Describes \p count elements of a datatype with an int count. If \p count is larger than \p maxCount, a
+  derived datatype that contains the \p count elements is created and the count becomes 1. */
+class LargeCountDatatype {
+public:
+	/** \brief Describes \p count elements of \p datatype. */
+	LargeCountDatatype(std::size_t count, MPI_Datatype datatype, std::size_t maxCount = maxIntCount)
+	: theCount(static_cast<int>(count)), datatype(datatype), owned(false)
+	{
+		if(count <= maxCount) return;
+		theCount = 1;
+		owned = true;
+		this->datatype = create(count,datatype,maxCount);
+	}
+	/** \brief Frees the derived datatype, if any. Pending communications that use it complete normally. */
+	~LargeCountDatatype() {
+		if(owned) MPI_Type_free(&datatype);
+	}
+	/** \brief Can't copy, or the derived datatype would be freed twice. */
+	LargeCountDatatype(const LargeCountDatatype&) = delete;
+	/** \brief Moves the derived datatype of \p rhs. */
+	LargeCountDatatype(LargeCountDatatype&& rhs): theCount(rhs.theCount), datatype(rhs.datatype), owned(rhs.owned) {
+		rhs.owned = false;
+	}
+	/** \brief Can't copy, or the derived datatype would be freed twice. */
+	LargeCountDatatype& operator=(const LargeCountDatatype&) = delete;
+	/** \brief [Rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
+	LargeCountDatatype& operator=(LargeCountDatatype&&) = delete;
+
+	/** \brief Returns the count to give to MPI. */
+	int count() const {
+		return theCount;
+	}
+	/** \brief Returns the datatype to give to MPI. */
+	MPI_Datatype get() const {
+		return datatype;
+	}
+
+private:
+	/** \brief Creates a datatype made of \p count elements of \p datatype, in blocks of \p maxCount elements. Its
+  extent is the extent of \p count elements of \p datatype, so that it can be used as a receive type in
+  collectives.*/
+	static MPI_Datatype create(std::size_t count, MPI_Datatype datatype, std::size_t maxCount) {
+		MPI_Aint lowerBound, extent;
+		handleError(MPI_Type_get_extent(datatype,&lowerBound,&extent));
+		const std::size_t blockCount = count/maxCount;
+		const std::size_t remainder = count % maxCount;
+
+		MPI_Datatype block, blocks, remainderBlock, structure, result;
+		handleError(MPI_Type_contiguous(static_cast<int>(maxCount),datatype,&block));
+		handleError(MPI_Type_contiguous(static_cast<int>(blockCount),block,&blocks));
+		handleError(MPI_Type_contiguous(static_cast<int>(remainder),datatype,&remainderBlock));
+		int blockLengths[2] = {1, 1};
+		MPI_Aint displacements[2] = {0, static_cast<MPI_Aint>(blockCount*maxCount)*extent};
+		MPI_Datatype types[2] = {blocks, remainderBlock};
+		handleError(MPI_Type_create_struct(2,blockLengths,displacements,types,&structure));
+		handleError(MPI_Type_create_resized(structure,lowerBound,static_cast<MPI_Aint>(count)*extent,&result));
+		handleError(MPI_Type_commit(&result));
+		for(auto&& x: {&block, &blocks, &remainderBlock, &structure}) MPI_Type_free(x);
+		return result;
+	}
+
+	/** \brief Count to give to MPI. */
+	int theCount;
+	/** \brief Datatype to give to MPI. */
+	MPI_Datatype datatype;
+	/** \brief True if \p datatype was created by this object. */
+	bool owned;
+};
+
+
+
+/** \brief Wraps the MPI functions so that counts and displacements larger than an int are supported. On MPI-4, the
+  large count functions (MPI_*_c) are used. Otherwise, counts larger than \p maxCount are handled with derived
+  datatypes made of big elements, or, for reductions, by reducing chunks of \p maxCount elements. */
+struct LargeCount {
+	/** \brief Wraps MPI_Send. */
+	static int send(const void* buffer, std::size_t count, MPI_Datatype datatype, int destination, int tag,
+		MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Send_c(buffer,count,datatype,destination,tag,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Send(buffer,x.count(),x.get(),destination,tag,communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Recv. */
+	static int receive(void* buffer, std::size_t count, MPI_Datatype datatype, int source, int tag,
+		MPI_Comm communicator, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Recv_c(buffer,count,datatype,source,tag,communicator,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Recv(buffer,x.count(),x.get(),source,tag,communicator,status);
+#endif
+	}
+	/** \brief Wraps MPI_Isend. */
+	static int asyncSend(const void* buffer, std::size_t count, MPI_Datatype datatype, int destination, int tag,
+		MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Isend_c(buffer,count,datatype,destination,tag,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Isend(buffer,x.count(),x.get(),destination,tag,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Irecv. */
+	static int asyncReceive(void* buffer, std::size_t count, MPI_Datatype datatype, int source, int tag,
+		MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Irecv_c(buffer,count,datatype,source,tag,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Irecv(buffer,x.count(),x.get(),source,tag,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Get_count. Without MPI-4, MPI_ERR_COUNT is returned if the count is larger than INT_MAX. */
+	static int getCount(const MPI_Status& status, MPI_Datatype datatype, std::size_t* count) {
+#if MPI_VERSION >= 4
+		MPI_Count x = 0;
+		const int error = MPI_Get_count_c(&status,datatype,&x);
+#else
+		int x = 0;
+		const int error = MPI_Get_count(&status,datatype,&x);
+#endif
+		if(error != MPI_SUCCESS) return error;
+		if(x == MPI_UNDEFINED) return MPI_ERR_COUNT;
+		*count = static_cast<std::size_t>(x);
+		return MPI_SUCCESS;
+	}
+	/** \brief Wraps MPI_Mrecv. */
+	static int matchedReceive(void* buffer, std::size_t count, MPI_Datatype datatype, MPI_Message* message,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Mrecv_c(buffer,count,datatype,message,MPI_STATUS_IGNORE);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Mrecv(buffer,x.count(),x.get(),message,MPI_STATUS_IGNORE);
+#endif
+	}
+	/** \brief Wraps MPI_Imrecv. */
+	static int asyncMatchedReceive(void* buffer, std::size_t count, MPI_Datatype datatype, MPI_Message* message,
+		MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Imrecv_c(buffer,count,datatype,message,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Imrecv(buffer,x.count(),x.get(),message,request);
+#endif
+	}
+	/** \brief Wraps MPI_Recv_init. The datatype used by the \p request is kept alive by \p datatypeOwner, which must
+  not be destroyed before the \p request is freed. */
+	static int receiveInit(void* buffer, std::size_t count, MPI_Datatype datatype, int source, int tag,
+		MPI_Comm communicator, MPI_Request* request, std::shared_ptr<void>& datatypeOwner,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		datatypeOwner.reset();
+		return MPI_Recv_init_c(buffer,count,datatype,source,tag,communicator,request);
+#else
+		const auto x = std::make_shared<LargeCountDatatype>(count,datatype,maxCount);
+		datatypeOwner = x;
+		return MPI_Recv_init(buffer,x->count(),x->get(),source,tag,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Send_init. The datatype used by the \p request is kept alive by \p datatypeOwner, which must
+  not be destroyed before the \p request is freed. */
+	static int sendInit(const void* buffer, std::size_t count, MPI_Datatype datatype, int destination, int tag,
+		MPI_Comm communicator, MPI_Request* request, std::shared_ptr<void>& datatypeOwner,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		datatypeOwner.reset();
+		return MPI_Send_init_c(buffer,count,datatype,destination,tag,communicator,request);
+#else
+		const auto x = std::make_shared<LargeCountDatatype>(count,datatype,maxCount);
+		datatypeOwner = x;
+		return MPI_Send_init(buffer,x->count(),x->get(),destination,tag,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Bcast. */
+	static int broadcast(void* buffer, std::size_t count, MPI_Datatype datatype, int source, MPI_Comm communicator,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Bcast_c(buffer,count,datatype,source,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Bcast(buffer,x.count(),x.get(),source,communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Gather. \p count elements are sent by every processes. */
+	static int gather(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Gather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,source,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Gather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),source,communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Allgather. \p count elements are sent by every processes. */
+	static int allGather(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Allgather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Allgather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Scatter. \p count elements are received by every processes. */
+	static int scatter(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Scatter_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,source,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Scatter(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),source,communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Allreduce. */
+	static int allReduce(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Op op, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Allreduce_c(sendBuffer,receiveBuffer,count,datatype,op,communicator);
+#else
+		return inChunks(sendBuffer,receiveBuffer,count,datatype,maxCount,[&](const void* in, void* out, int n) {
+			return MPI_Allreduce(in,out,n,datatype,op,communicator);
+		});
+#endif
+	}
+	/** \brief Wraps MPI_Reduce. */
+	static int reduce(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Op op, int source, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Reduce_c(sendBuffer,receiveBuffer,count,datatype,op,source,communicator);
+#else
+		return inChunks(sendBuffer,receiveBuffer,count,datatype,maxCount,[&](const void* in, void* out, int n) {
+			return MPI_Reduce(in,out,n,datatype,op,source,communicator);
+		});
+#endif
+	}
+	/** \brief Wraps MPI_Scan. */
+	static int scan(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Op op, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Scan_c(sendBuffer,receiveBuffer,count,datatype,op,communicator);
+#else
+		return inChunks(sendBuffer,receiveBuffer,count,datatype,maxCount,[&](const void* in, void* out, int n) {
+			return MPI_Scan(in,out,n,datatype,op,communicator);
+		});
+#endif
+	}
+	/** \brief Wraps MPI_Exscan. */
+	static int exScan(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Op op, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Exscan_c(sendBuffer,receiveBuffer,count,datatype,op,communicator);
+#else
+		return inChunks(sendBuffer,receiveBuffer,count,datatype,maxCount,[&](const void* in, void* out, int n) {
+			return MPI_Exscan(in,out,n,datatype,op,communicator);
+		});
+#endif
+	}
+	/** \brief Wraps MPI_Gatherv. Without MPI-4, the processes first agree on whether a large count is needed,
+  since only the \p source knows the \p displacements.*/
+	static int varyingGather(const void* sendBuffer, std::size_t sendCount, void* receiveBuffer,
+		const std::vector<int>& receiveCounts, const std::vector<std::size_t>& displacements, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const std::vector<MPI_Count> largeCounts(receiveCounts.begin(),receiveCounts.end());
+		const std::vector<MPI_Aint> largeDisplacements(displacements.begin(),displacements.end());
+		return MPI_Gatherv_c(sendBuffer,sendCount,datatype,receiveBuffer,largeCounts.data(),
+			largeDisplacements.data(),datatype,source,communicator);
+#else
+		int rank;
+		handleError(MPI_Comm_rank(communicator,&rank));
+		const bool needsLargeCount = anyNeedsLargeCount(sendCount > maxCount or
+			(rank == source and !fitsInt(displacements,maxCount)), communicator);
+		return varyingGather(needsLargeCount,sendBuffer,sendCount,receiveBuffer,receiveCounts,displacements,
+			datatype,source,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Gatherv, with the data of every processes placed sequentially. Every process gives the
+  \p receiveCounts, so that each one finds out alone whether a large count is needed. */
+	static int varyingGather(const void* sendBuffer, std::size_t sendCount, void* receiveBuffer,
+		const std::vector<int>& receiveCounts, MPI_Datatype datatype, int source, MPI_Comm communicator,
+		std::size_t maxCount = maxIntCount)
+	{
+		const std::vector<std::size_t> displacements = sequentialDisplacements(receiveCounts);
+#if MPI_VERSION >= 4
+		return varyingGather(sendBuffer,sendCount,receiveBuffer,receiveCounts,displacements,datatype,source,
+			communicator,maxCount);
+#else
+		return varyingGather(!fitsIntSequentially(receiveCounts,displacements,maxCount),sendBuffer,sendCount,
+			receiveBuffer,receiveCounts,displacements,datatype,source,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Allgatherv. */
+	static int varyingAllGather(const void* sendBuffer, std::size_t sendCount, void* receiveBuffer,
+		const std::vector<int>& receiveCounts, const std::vector<std::size_t>& displacements, MPI_Datatype datatype,
+		MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+		if(sendCount <= maxCount and fitsInt(displacements,maxCount)) {
+			const std::vector<int> intDisplacements(displacements.begin(),displacements.end());
+			return MPI_Allgatherv(sendBuffer,static_cast<int>(sendCount),datatype,receiveBuffer,receiveCounts.data(),
+				intDisplacements.data(),datatype,communicator);
+		}
+#if MPI_VERSION >= 4
+		const std::vector<MPI_Count> largeCounts(receiveCounts.begin(),receiveCounts.end());
+		const std::vector<MPI_Aint> largeDisplacements(displacements.begin(),displacements.end());
+		return MPI_Allgatherv_c(sendBuffer,sendCount,datatype,receiveBuffer,largeCounts.data(),
+			largeDisplacements.data(),datatype,communicator);
+#else
+		const std::vector<std::size_t> sendCounts(receiveCounts.size(),sendCount);
+		const std::vector<std::size_t> sendDisplacements(receiveCounts.size());
+		const std::vector<std::size_t> largeReceiveCounts(receiveCounts.begin(),receiveCounts.end());
+		return allToAllw(sendBuffer,sendCounts,sendDisplacements,receiveBuffer,largeReceiveCounts,displacements,
+			datatype,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Scatterv. Without MPI-4, the processes first agree on whether a large count is needed,
+  since only the \p source knows the \p displacements.*/
+	static int varyingScatter(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& displacements, void* receiveBuffer, std::size_t receiveCount,
+		MPI_Datatype datatype, int source, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const std::vector<MPI_Count> largeCounts(sendCounts.begin(),sendCounts.end());
+		const std::vector<MPI_Aint> largeDisplacements(displacements.begin(),displacements.end());
+		return MPI_Scatterv_c(sendBuffer,largeCounts.data(),largeDisplacements.data(),datatype,receiveBuffer,
+			receiveCount,datatype,source,communicator);
+#else
+		int rank;
+		handleError(MPI_Comm_rank(communicator,&rank));
+		const bool needsLargeCount = anyNeedsLargeCount(receiveCount > maxCount or
+			(rank == source and !fitsInt(displacements,maxCount)), communicator);
+		return varyingScatter(needsLargeCount,sendBuffer,sendCounts,displacements,receiveBuffer,receiveCount,
+			datatype,source,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Scatterv, with the data of every processes placed sequentially. Every process gives the
+  \p sendCounts, so that each one finds out alone whether a large count is needed. */
+	static int varyingScatter(const void* sendBuffer, const std::vector<int>& sendCounts, void* receiveBuffer,
+		std::size_t receiveCount, MPI_Datatype datatype, int source, MPI_Comm communicator,
+		std::size_t maxCount = maxIntCount)
+	{
+		const std::vector<std::size_t> displacements = sequentialDisplacements(sendCounts);
+#if MPI_VERSION >= 4
+		return varyingScatter(sendBuffer,sendCounts,displacements,receiveBuffer,receiveCount,datatype,source,
+			communicator,maxCount);
+#else
+		return varyingScatter(!fitsIntSequentially(sendCounts,displacements,maxCount),sendBuffer,sendCounts,
+			displacements,receiveBuffer,receiveCount,datatype,source,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Ibcast. */
+	static int asyncBroadcast(void* buffer, std::size_t count, MPI_Datatype datatype, int source,
+		MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Ibcast_c(buffer,count,datatype,source,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Ibcast(buffer,x.count(),x.get(),source,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Igather. \p count elements are sent by every processes. */
+	static int asyncGather(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Igather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,source,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Igather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),source,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Iallgather. \p count elements are sent by every processes. */
+	static int asyncAllGather(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Iallgather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Iallgather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Iscatter. \p count elements are received by every processes. */
+	static int asyncScatter(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Iscatter_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,source,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Iscatter(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),source,communicator,
+			request);
+#endif
+	}
+	/** \brief Wraps MPI_Iallreduce. Without MPI-4, a single request can't reduce in chunks, so MPI_ERR_COUNT is
+  returned if \p count is larger than \p maxCount. */
+	static int asyncAllReduce(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Op op, MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Iallreduce_c(sendBuffer,receiveBuffer,count,datatype,op,communicator,request);
+#else
+		if(count > maxCount) return MPI_ERR_COUNT;
+		return MPI_Iallreduce(sendBuffer,receiveBuffer,static_cast<int>(count),datatype,op,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Igatherv. The counts and displacements given to MPI are kept alive by \p arguments, which
+  must not be destroyed before the \p request completes. Without MPI-4, the processes can't agree on a large count
+  without blocking, so MPI_ERR_COUNT is returned if a count or a displacement is larger than \p maxCount. */
+	static int asyncVaryingGather(const void* sendBuffer, std::size_t sendCount, void* receiveBuffer,
+		const std::vector<int>& receiveCounts, const std::vector<std::size_t>& displacements, MPI_Datatype datatype,
+		int source, MPI_Comm communicator, MPI_Request* request, std::shared_ptr<void>& arguments,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const auto x = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,displacements);
+		arguments = x;
+		return MPI_Igatherv_c(sendBuffer,sendCount,datatype,receiveBuffer,x->counts.data(),x->displacements.data(),
+			datatype,source,communicator,request);
+#else
+		if(sendCount > maxCount or !fitsInt(displacements,maxCount)) return MPI_ERR_COUNT;
+		const auto x = makeArguments<int,int>(receiveCounts,displacements);
+		arguments = x;
+		return MPI_Igatherv(sendBuffer,static_cast<int>(sendCount),datatype,receiveBuffer,x->counts.data(),
+			x->displacements.data(),datatype,source,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Iallgatherv. The counts and displacements given to MPI are kept alive by \p arguments,
+  which must not be destroyed before the \p request completes. Without MPI-4, MPI_ERR_COUNT is returned if a count
+  or a displacement is larger than \p maxCount. */
+	static int asyncVaryingAllGather(const void* sendBuffer, std::size_t sendCount, void* receiveBuffer,
+		const std::vector<int>& receiveCounts, const std::vector<std::size_t>& displacements, MPI_Datatype datatype,
+		MPI_Comm communicator, MPI_Request* request, std::shared_ptr<void>& arguments,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const auto x = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,displacements);
+		arguments = x;
+		return MPI_Iallgatherv_c(sendBuffer,sendCount,datatype,receiveBuffer,x->counts.data(),
+			x->displacements.data(),datatype,communicator,request);
+#else
+		if(sendCount > maxCount or !fitsInt(displacements,maxCount)) return MPI_ERR_COUNT;
+		const auto x = makeArguments<int,int>(receiveCounts,displacements);
+		arguments = x;
+		return MPI_Iallgatherv(sendBuffer,static_cast<int>(sendCount),datatype,receiveBuffer,x->counts.data(),
+			x->displacements.data(),datatype,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Iscatterv. The counts and displacements given to MPI are kept alive by \p arguments, which
+  must not be destroyed before the \p request completes. Without MPI-4, MPI_ERR_COUNT is returned if a count or a
+  displacement is larger than \p maxCount. */
+	static int asyncVaryingScatter(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& displacements, void* receiveBuffer, std::size_t receiveCount,
+		MPI_Datatype datatype, int source, MPI_Comm communicator, MPI_Request* request,
+		std::shared_ptr<void>& arguments, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const auto x = makeArguments<MPI_Count,MPI_Aint>(sendCounts,displacements);
+		arguments = x;
+		return MPI_Iscatterv_c(sendBuffer,x->counts.data(),x->displacements.data(),datatype,receiveBuffer,
+			receiveCount,datatype,source,communicator,request);
+#else
+		if(receiveCount > maxCount or !fitsInt(displacements,maxCount)) return MPI_ERR_COUNT;
+		const auto x = makeArguments<int,int>(sendCounts,displacements);
+		arguments = x;
+		return MPI_Iscatterv(sendBuffer,x->counts.data(),x->displacements.data(),datatype,receiveBuffer,
+			static_cast<int>(receiveCount),datatype,source,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Alltoall. \p count elements are sent by every processes to every processes. */
+	static int allToAll(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Alltoall_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Alltoall(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Ialltoall. \p count elements are sent by every processes to every processes. */
+	static int asyncAllToAll(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Ialltoall_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Ialltoall(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Alltoallv. Without MPI-4, the processes first agree on whether a large count is needed,
+  since each process only knows its own counts and displacements, even when they are placed sequentially.*/
+	static int varyingAllToAll(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& sendDisplacements, void* receiveBuffer, const std::vector<int>& receiveCounts,
+		const std::vector<std::size_t>& receiveDisplacements, MPI_Datatype datatype, MPI_Comm communicator,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const auto send = makeArguments<MPI_Count,MPI_Aint>(sendCounts,sendDisplacements);
+		const auto receive = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,receiveDisplacements);
+		return MPI_Alltoallv_c(sendBuffer,send->counts.data(),send->displacements.data(),datatype,receiveBuffer,
+			receive->counts.data(),receive->displacements.data(),datatype,communicator);
+#else
+		if(!anyNeedsLargeCount(!fitsInt(sendDisplacements,maxCount) or !fitsInt(receiveDisplacements,maxCount),
+			communicator))
+		{
+			const std::vector<int> intSendDisplacements(sendDisplacements.begin(),sendDisplacements.end());
+			const std::vector<int> intReceiveDisplacements(receiveDisplacements.begin(),receiveDisplacements.end());
+			return MPI_Alltoallv(sendBuffer,sendCounts.data(),intSendDisplacements.data(),datatype,receiveBuffer,
+				receiveCounts.data(),intReceiveDisplacements.data(),datatype,communicator);
+		}
+		const std::vector<std::size_t> largeSendCounts(sendCounts.begin(),sendCounts.end());
+		const std::vector<std::size_t> largeReceiveCounts(receiveCounts.begin(),receiveCounts.end());
+		return allToAllw(sendBuffer,largeSendCounts,sendDisplacements,receiveBuffer,largeReceiveCounts,
+			receiveDisplacements,datatype,communicator,maxCount);
+#endif
+	}
+	/** \brief Wraps MPI_Ialltoallv. The counts and displacements given to MPI are kept alive by \p arguments,
+  which must not be destroyed before the \p request completes. Without MPI-4, MPI_ERR_COUNT is returned if a
+  displacement is larger than \p maxCount. */
+	static int asyncVaryingAllToAll(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& sendDisplacements, void* receiveBuffer, const std::vector<int>& receiveCounts,
+		const std::vector<std::size_t>& receiveDisplacements, MPI_Datatype datatype, MPI_Comm communicator,
+		MPI_Request* request, std::shared_ptr<void>& arguments, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		using Arguments = VaryingArguments<MPI_Count,MPI_Aint>;
+		const auto x = std::make_shared<std::array<std::shared_ptr<Arguments>,2>>();
+		(*x)[0] = makeArguments<MPI_Count,MPI_Aint>(sendCounts,sendDisplacements);
+		(*x)[1] = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,receiveDisplacements);
+		arguments = x;
+		return MPI_Ialltoallv_c(sendBuffer,(*x)[0]->counts.data(),(*x)[0]->displacements.data(),datatype,
+			receiveBuffer,(*x)[1]->counts.data(),(*x)[1]->displacements.data(),datatype,communicator,request);
+#else
+		if(!fitsInt(sendDisplacements,maxCount) or !fitsInt(receiveDisplacements,maxCount)) return MPI_ERR_COUNT;
+		using Arguments = VaryingArguments<int,int>;
+		const auto x = std::make_shared<std::array<std::shared_ptr<Arguments>,2>>();
+		(*x)[0] = makeArguments<int,int>(sendCounts,sendDisplacements);
+		(*x)[1] = makeArguments<int,int>(receiveCounts,receiveDisplacements);
+		arguments = x;
+		return MPI_Ialltoallv(sendBuffer,(*x)[0]->counts.data(),(*x)[0]->displacements.data(),datatype,
+			receiveBuffer,(*x)[1]->counts.data(),(*x)[1]->displacements.data(),datatype,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Neighbor_allgather. \p count elements are sent to every neighbors. */
+	static int neighborAllGather(const void* sendBuffer, void* receiveBuffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Neighbor_allgather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Neighbor_allgather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Ineighbor_allgather. \p count elements are sent to every neighbors. */
+	static int asyncNeighborAllGather(const void* sendBuffer, void* receiveBuffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Ineighbor_allgather_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator,
+			request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Ineighbor_allgather(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator,
+			request);
+#endif
+	}
+	/** \brief Wraps MPI_Neighbor_alltoall. \p count elements are sent to each neighbor. */
+	static int neighborAllToAll(const void* sendBuffer, void* receiveBuffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Neighbor_alltoall_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Neighbor_alltoall(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Ineighbor_alltoall. \p count elements are sent to each neighbor. */
+	static int asyncNeighborAllToAll(const void* sendBuffer, void* receiveBuffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Comm communicator, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Ineighbor_alltoall_c(sendBuffer,count,datatype,receiveBuffer,count,datatype,communicator,
+			request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Ineighbor_alltoall(sendBuffer,x.count(),x.get(),receiveBuffer,x.count(),x.get(),communicator,
+			request);
+#endif
+	}
+	/** \brief Wraps MPI_Neighbor_alltoallv. Without MPI-4, MPI_ERR_COUNT is returned if a displacement is larger
+  than \p maxCount. */
+	static int neighborVaryingAllToAll(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& sendDisplacements, void* receiveBuffer, const std::vector<int>& receiveCounts,
+		const std::vector<std::size_t>& receiveDisplacements, MPI_Datatype datatype, MPI_Comm communicator,
+		std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		const auto send = makeArguments<MPI_Count,MPI_Aint>(sendCounts,sendDisplacements);
+		const auto receive = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,receiveDisplacements);
+		return MPI_Neighbor_alltoallv_c(sendBuffer,send->counts.data(),send->displacements.data(),datatype,
+			receiveBuffer,receive->counts.data(),receive->displacements.data(),datatype,communicator);
+#else
+		if(!fitsInt(sendDisplacements,maxCount) or !fitsInt(receiveDisplacements,maxCount)) return MPI_ERR_COUNT;
+		const auto send = makeArguments<int,int>(sendCounts,sendDisplacements);
+		const auto receive = makeArguments<int,int>(receiveCounts,receiveDisplacements);
+		return MPI_Neighbor_alltoallv(sendBuffer,send->counts.data(),send->displacements.data(),datatype,
+			receiveBuffer,receive->counts.data(),receive->displacements.data(),datatype,communicator);
+#endif
+	}
+	/** \brief Wraps MPI_Ineighbor_alltoallv. The counts and displacements given to MPI are kept alive by \p
+  arguments, which must not be destroyed before the \p request completes. Without MPI-4, MPI_ERR_COUNT is returned
+  if a displacement is larger than \p maxCount. */
+	static int asyncNeighborVaryingAllToAll(const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& sendDisplacements, void* receiveBuffer, const std::vector<int>& receiveCounts,
+		const std::vector<std::size_t>& receiveDisplacements, MPI_Datatype datatype, MPI_Comm communicator,
+		MPI_Request* request, std::shared_ptr<void>& arguments, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		using Arguments = VaryingArguments<MPI_Count,MPI_Aint>;
+		const auto x = std::make_shared<std::array<std::shared_ptr<Arguments>,2>>();
+		(*x)[0] = makeArguments<MPI_Count,MPI_Aint>(sendCounts,sendDisplacements);
+		(*x)[1] = makeArguments<MPI_Count,MPI_Aint>(receiveCounts,receiveDisplacements);
+		arguments = x;
+		return MPI_Ineighbor_alltoallv_c(sendBuffer,(*x)[0]->counts.data(),(*x)[0]->displacements.data(),datatype,
+			receiveBuffer,(*x)[1]->counts.data(),(*x)[1]->displacements.data(),datatype,communicator,request);
+#else
+		if(!fitsInt(sendDisplacements,maxCount) or !fitsInt(receiveDisplacements,maxCount)) return MPI_ERR_COUNT;
+		using Arguments = VaryingArguments<int,int>;
+		const auto x = std::make_shared<std::array<std::shared_ptr<Arguments>,2>>();
+		(*x)[0] = makeArguments<int,int>(sendCounts,sendDisplacements);
+		(*x)[1] = makeArguments<int,int>(receiveCounts,receiveDisplacements);
+		arguments = x;
+		return MPI_Ineighbor_alltoallv(sendBuffer,(*x)[0]->counts.data(),(*x)[0]->displacements.data(),datatype,
+			receiveBuffer,(*x)[1]->counts.data(),(*x)[1]->displacements.data(),datatype,communicator,request);
+#endif
+	}
+	/** \brief Wraps MPI_Put. The same datatype describes the origin and the target buffers. */
+	static int put(const void* buffer, std::size_t count, MPI_Datatype datatype, int target, MPI_Aint displacement,
+		MPI_Win window, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Put_c(buffer,count,datatype,target,displacement,count,datatype,window);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Put(buffer,x.count(),x.get(),target,displacement,x.count(),x.get(),window);
+#endif
+	}
+	/** \brief Wraps MPI_Get. The same datatype describes the origin and the target buffers. */
+	static int get(void* buffer, std::size_t count, MPI_Datatype datatype, int target, MPI_Aint displacement,
+		MPI_Win window, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Get_c(buffer,count,datatype,target,displacement,count,datatype,window);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Get(buffer,x.count(),x.get(),target,displacement,x.count(),x.get(),window);
+#endif
+	}
+	/** \brief Wraps MPI_Accumulate. The derived datatype made for large counts is made of \p datatype only, as
+  required by the accumulate functions. */
+	static int accumulate(const void* buffer, std::size_t count, MPI_Datatype datatype, int target,
+		MPI_Aint displacement, MPI_Op op, MPI_Win window, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_Accumulate_c(buffer,count,datatype,target,displacement,count,datatype,op,window);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_Accumulate(buffer,x.count(),x.get(),target,displacement,x.count(),x.get(),op,window);
+#endif
+	}
+	/** \brief Exchanges \p sendCounts[i] elements starting at \p sendDisplacements[i] with the process of rank \p i,
+  which are received in \p receiveBuffer at \p receiveDisplacements[i]. Counts and displacements are in elements of
+  \p datatype. Every block is described by its own datatype with an MPI_Aint displacement, so that neither counts or
+  displacements are limited to an int.*/
+	static int allToAllw(const void* sendBuffer, const std::vector<std::size_t>& sendCounts,
+		const std::vector<std::size_t>& sendDisplacements, void* receiveBuffer,
+		const std::vector<std::size_t>& receiveCounts, const std::vector<std::size_t>& receiveDisplacements,
+		MPI_Datatype datatype, MPI_Comm communicator, std::size_t maxCount = maxIntCount)
+	{
+		DatatypeBlocks sendBlocks(sendCounts,sendDisplacements,datatype,maxCount);
+		DatatypeBlocks receiveBlocks(receiveCounts,receiveDisplacements,datatype,maxCount);
+		return MPI_Alltoallw(sendBuffer,sendBlocks.counts.data(),sendBlocks.displacements.data(),
+			sendBlocks.datatypes.data(),receiveBuffer,receiveBlocks.counts.data(),receiveBlocks.displacements.data(),
+			receiveBlocks.datatypes.data(),communicator);
+	}
+	/** \brief Wraps MPI_File_read_at. */
+	static int readAt(MPI_File file, MPI_Offset offset, void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_read_at_c(file,offset,buffer,count,datatype,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_read_at(file,offset,buffer,x.count(),x.get(),status);
+#endif
+	}
+	/** \brief Wraps MPI_File_read_at_all. */
+	static int readAtAll(MPI_File file, MPI_Offset offset, void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_read_at_all_c(file,offset,buffer,count,datatype,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_read_at_all(file,offset,buffer,x.count(),x.get(),status);
+#endif
+	}
+	/** \brief Wraps MPI_File_write_at. */
+	static int writeAt(MPI_File file, MPI_Offset offset, const void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_write_at_c(file,offset,buffer,count,datatype,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_write_at(file,offset,buffer,x.count(),x.get(),status);
+#endif
+	}
+	/** \brief Wraps MPI_File_write_at_all. */
+	static int writeAtAll(MPI_File file, MPI_Offset offset, const void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_write_at_all_c(file,offset,buffer,count,datatype,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_write_at_all(file,offset,buffer,x.count(),x.get(),status);
+#endif
+	}
+	/** \brief Wraps MPI_File_write_ordered. */
+	static int writeOrdered(MPI_File file, const void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Status* status, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_write_ordered_c(file,buffer,count,datatype,status);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_write_ordered(file,buffer,x.count(),x.get(),status);
+#endif
+	}
+	/** \brief Wraps MPI_File_iread_at_all. */
+	static int asyncReadAtAll(MPI_File file, MPI_Offset offset, void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_iread_at_all_c(file,offset,buffer,count,datatype,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_iread_at_all(file,offset,buffer,x.count(),x.get(),request);
+#endif
+	}
+	/** \brief Wraps MPI_File_iwrite_at_all. */
+	static int asyncWriteAtAll(MPI_File file, MPI_Offset offset, const void* buffer, std::size_t count,
+		MPI_Datatype datatype, MPI_Request* request, std::size_t maxCount = maxIntCount)
+	{
+#if MPI_VERSION >= 4
+		((void)maxCount);
+		return MPI_File_iwrite_at_all_c(file,offset,buffer,count,datatype,request);
+#else
+		const LargeCountDatatype x(count,datatype,maxCount);
+		return MPI_File_iwrite_at_all(file,offset,buffer,x.count(),x.get(),request);
+#endif
+	}
+
+private:
+	/** \brief Describes, for every processes, a block of elements with a single derived datatype that is
+  displaced in bytes. This is the representation of the blocks required by MPI_Alltoallw.*/
+	struct DatatypeBlocks {
+		/** \brief Creates the datatypes of \p counts[i] elements at \p elementDisplacements[i]. */
+		DatatypeBlocks(const std::vector<std::size_t>& elementCounts,
+			const std::vector<std::size_t>& elementDisplacements, MPI_Datatype datatype, std::size_t maxCount)
+		: counts(elementCounts.size()), displacements(elementCounts.size()), datatypes(elementCounts.size(),datatype)
+		{
+			MPI_Aint lowerBound, extent;
+			handleError(MPI_Type_get_extent(datatype,&lowerBound,&extent));
+			for(std::size_t i = 0; i < elementCounts.size(); ++i) {
+				if(elementCounts[i] == 0) continue;
+				const LargeCountDatatype block(elementCounts[i],datatype,maxCount);
+				int blockLength = block.count();
+				MPI_Aint byteDisplacement = static_cast<MPI_Aint>(elementDisplacements[i])*extent;
+				MPI_Datatype blockType = block.get();
+				handleError(MPI_Type_create_struct(1,&blockLength,&byteDisplacement,&blockType,&datatypes[i]));
+				handleError(MPI_Type_commit(&datatypes[i]));
+				counts[i] = 1;
+				owned.push_back(datatypes[i]);
+			}
+		}
+		/** \brief Frees the created datatypes. */
+		~DatatypeBlocks() {
+			for(auto&& x: owned) MPI_Type_free(&x);
+		}
+		/** \brief [Rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
+		DatatypeBlocks(const DatatypeBlocks&) = delete;
+		/** \brief [Rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
+		DatatypeBlocks& operator=(const DatatypeBlocks&) = delete;
+
+		/** \brief Counts given to MPI_Alltoallw. */
+		std::vector<int> counts;
+		/** \brief Byte displacements given to MPI_Alltoallw. Always 0, since the datatypes are displaced. */
+		std::vector<int> displacements;
+		/** \brief Datatypes given to MPI_Alltoallw. */
+		std::vector<MPI_Datatype> datatypes;
+		/** \brief Datatypes created by this object. */
+		std::vector<MPI_Datatype> owned;
+	};
+
+	/** \brief Counts and displacements given to a nonblocking varying collective, which must stay valid until it
+  completes. */
+	template<class Count, class Displacement>
+	struct VaryingArguments {
+		/** \brief Counts given to MPI. */
+		std::vector<Count> counts;
+		/** \brief Displacements given to MPI. */
+		std::vector<Displacement> displacements;
+	};
+
+	/** \brief Returns the \p counts and the \p displacements converted to the types expected by MPI. */
+	template<class Count, class Displacement>
+	static std::shared_ptr<VaryingArguments<Count,Displacement>> makeArguments(const std::vector<int>& counts,
+		const std::vector<std::size_t>& displacements)
+	{
+		const auto x = std::make_shared<VaryingArguments<Count,Displacement>>();
+		x->counts.assign(counts.begin(),counts.end());
+		x->displacements.assign(displacements.begin(),displacements.end());
+		return x;
+	}
+	/** \brief Returns the displacements of the data of every processes placed sequentially. */
+	static std::vector<std::size_t> sequentialDisplacements(const std::vector<int>& counts) {
+		std::vector<std::size_t> x(counts.size());
+		for(std::size_t i = 1; i < x.size(); ++i) x[i] = x[i-1] + static_cast<std::size_t>(counts[i-1]);
+		return x;
+	}
+#if MPI_VERSION < 4
+	/** \brief Returns true if every \p counts and \p displacements, computed by sequentialDisplacements, can be
+  given to MPI as int. */
+	static bool fitsIntSequentially(const std::vector<int>& counts, const std::vector<std::size_t>& displacements,
+		std::size_t maxCount)
+	{
+		for(auto&& x: counts) if(static_cast<std::size_t>(x) > maxCount) return false;
+		return fitsInt(displacements,maxCount);
+	}
+	/** \brief Wraps MPI_Gatherv, or MPI_Alltoallw if \p needsLargeCount, which must be the same on every
+  processes. */
+	static int varyingGather(bool needsLargeCount, const void* sendBuffer, std::size_t sendCount,
+		void* receiveBuffer, const std::vector<int>& receiveCounts, const std::vector<std::size_t>& displacements,
+		MPI_Datatype datatype, int source, MPI_Comm communicator, std::size_t maxCount)
+	{
+		if(!needsLargeCount) {
+			const std::vector<int> intDisplacements(displacements.begin(),displacements.end());
+			return MPI_Gatherv(sendBuffer,static_cast<int>(sendCount),datatype,receiveBuffer,receiveCounts.data(),
+				intDisplacements.data(),datatype,source,communicator);
+		}
+		int rank, size;
+		handleError(MPI_Comm_rank(communicator,&rank));
+		handleError(MPI_Comm_size(communicator,&size));
+		std::vector<std::size_t> sendCounts(size), sendDisplacements(size), largeReceiveCounts(size),
+			receiveDisplacements(size);
+		sendCounts[source] = sendCount;
+		if(rank == source) {
+			largeReceiveCounts.assign(receiveCounts.begin(),receiveCounts.end());
+			receiveDisplacements = displacements;
+		}
+		return allToAllw(sendBuffer,sendCounts,sendDisplacements,receiveBuffer,largeReceiveCounts,
+			receiveDisplacements,datatype,communicator,maxCount);
+	}
+	/** \brief Wraps MPI_Scatterv, or MPI_Alltoallw if \p needsLargeCount, which must be the same on every
+  processes. */
+	static int varyingScatter(bool needsLargeCount, const void* sendBuffer, const std::vector<int>& sendCounts,
+		const std::vector<std::size_t>& displacements, void* receiveBuffer, std::size_t receiveCount,
+		MPI_Datatype datatype, int source, MPI_Comm communicator, std::size_t maxCount)
+	{
+		if(!needsLargeCount) {
+			const std::vector<int> intDisplacements(displacements.begin(),displacements.end());
+			return MPI_Scatterv(sendBuffer,sendCounts.data(),intDisplacements.data(),datatype,receiveBuffer,
+				static_cast<int>(receiveCount),datatype,source,communicator);
+		}
+		int rank, size;
+		handleError(MPI_Comm_rank(communicator,&rank));
+		handleError(MPI_Comm_size(communicator,&size));
+		std::vector<std::size_t> largeSendCounts(size), sendDisplacements(size), receiveCounts(size),
+			receiveDisplacements(size);
+		if(rank == source) {
+			largeSendCounts.assign(sendCounts.begin(),sendCounts.end());
+			sendDisplacements = displacements;
+		}
+		receiveCounts[source] = receiveCount;
+		return allToAllw(sendBuffer,largeSendCounts,sendDisplacements,receiveBuffer,receiveCounts,
+			receiveDisplacements,datatype,communicator,maxCount);
+	}
+#endif
+	/** \brief Returns true if \p needsLargeCount on any processes of the \p communicator. */
+	static bool anyNeedsLargeCount(bool needsLargeCount, MPI_Comm communicator) {
+		int local = needsLargeCount;
+		int any = 0;
+		handleError(MPI_Allreduce(&local,&any,1,MPI_INT,MPI_LOR,communicator));
+		return any != 0;
+	}
+	/** \brief Returns true if every \p values can be given to MPI as int. */
+	static bool fitsInt(const std::vector<std::size_t>& values, std::size_t maxCount) {
+		for(auto&& x: values) if(x > maxCount) return false;
+		return true;
+	}
+	/** \brief Calls \p reduction on consecutive chunks of at most \p maxCount elements. MPI_IN_PLACE is
+  forwarded as is.*/
+	template<class Reduction>
+	static int inChunks(const void* sendBuffer, void* receiveBuffer, std::size_t count, MPI_Datatype datatype,
+		std::size_t maxCount, Reduction reduction)
+	{
+		if(count <= maxCount) return reduction(sendBuffer,receiveBuffer,static_cast<int>(count));
+		MPI_Aint lowerBound, extent;
+		handleError(MPI_Type_get_extent(datatype,&lowerBound,&extent));
+		for(std::size_t offset = 0; offset < count; offset += maxCount) {
+			const std::size_t n = count - offset < maxCount ? count - offset : maxCount;
+			const MPI_Aint byteOffset = static_cast<MPI_Aint>(offset)*extent;
+			const void* in = sendBuffer == MPI_IN_PLACE ? sendBuffer :
+				static_cast<const char*>(sendBuffer) + byteOffset;
+			void* out = receiveBuffer ? static_cast<char*>(receiveBuffer) + byteOffset : receiveBuffer;
+			const int error = reduction(in,out,static_cast<int>(n));
+			if(error != MPI_SUCCESS) return error;
+		}
+		return MPI_SUCCESS;
+	}
+};
+
+} // NiceMPi
+
+#endif  /* LARGECOUNT_H */
@@ -23,7 +23,7 @@ SOFTWARE. */
 #ifndef MPICOMMUNICATORHANDLE_H
 #define MPICOMMUNICATORHANDLE_H
 
-#include <memory> // std::unique_ptr
+#include <memory> // std::shared_ptr
 #include <mpi.h> // MPI_Comm
 
 namespace NiceMPI {
@@ -38,25 +38,66 @@ public:
 	explicit MPIcommunicatorHandle(MPI_Comm mpiCommunicator);
 	/** \brief Creates a handle that contains a proxy communicator identical to \p mpiCommunicator.*/
 	explicit MPIcommunicatorHandle(MPI_Comm* mpiCommunicator);
-	/** \brief Copies the handle \p rhs. */
+	/** \brief Returns a handle that owns \p mpiCommunicator, without duplicating it. It is freed with the last handle
+  that shares it. MPI_COMM_NULL gives a proxy, since it can't be freed. */
+	static MPIcommunicatorHandle adopt(MPI_Comm mpiCommunicator);
+	/** \brief Copies the handle \p rhs. The communicator is duplicated. */
 	MPIcommunicatorHandle(const MPIcommunicatorHandle& rhs);
 	/** \brief Moves the handle \p rhs. */
 	MPIcommunicatorHandle(MPIcommunicatorHandle&& rhs);
 	/** \brief Destroys the handle \p rhs. Only there because of the
 		[rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
 	~MPIcommunicatorHandle();
-	/** \brief Assigns \p this handle the handle \p rhs. */
+	/** \brief Assigns \p this handle the handle \p rhs. The communicator is duplicated. */
 	MPIcommunicatorHandle& operator=(const MPIcommunicatorHandle& rhs);
 	/** \brief Moves the handle \p rhs and assigns it to \p this handle.  */
 	MPIcommunicatorHandle& operator=(MPIcommunicatorHandle&& rhs);
 	/** \brief Returns the underlying MPI_Comm implementation. */
-	MPI_Comm get() const;
+	MPI_Comm get() const {
+		return mpiCommunicator;
+	}
 	/** \brief Returns the underlying MPI_Comm implementation. */
-	MPI_Comm get();
+	MPI_Comm get() {
+		return mpiCommunicator;
+	}
+	/** \brief Returns the rank of the process in the communicator, or MPI_UNDEFINED for MPI_COMM_NULL. */
+	int rank() const {
+		return cachedRank;
+	}
+	/** \brief Returns the size of the communicator, or 0 for MPI_COMM_NULL. */
+	int size() const {
+		return cachedSize;
+	}
+	/** \brief Returns a handle that shares the communicator of \p this handle, without duplicating it. The
+  communicator is freed with the last owning handle that shares it. */
+	MPIcommunicatorHandle shared() const;
+	/** \brief Returns a handle that shares the private duplicate of the communicator, on which NiceMPI exchanges
+  its own messages without matching those of the user. The duplicate is created by the first call for the
+  communicator, which is then collective, and cached as an attribute of the latter, so that every handle of the
+  communicator shares it. */
+	MPIcommunicatorHandle privateDuplicate() const;
+	/** \brief Returns the topology of the communicator, as given by MPI_Topo_test: MPI_CART, MPI_GRAPH,
+  MPI_DIST_GRAPH or MPI_UNDEFINED. */
+	int topology() const {
+		return cachedTopology;
+	}
 
 private:
+	/** \brief Creates a handle with the implementation \p rhs. */
+	explicit MPIcommunicatorHandle(std::shared_ptr<MPIcommunicatorHandleImpl> rhs);
+	/** \brief Queries once the properties of the communicator of \p impl, which can't change. */
+	void cache();
+
 	/** \brief Implementation of this handle. */
-	std::unique_ptr<MPIcommunicatorHandleImpl> impl;
+	std::shared_ptr<MPIcommunicatorHandleImpl> impl;
+	/** \brief Communicator of \p impl, stored here to avoid a virtual call for each MPI call. */
+	MPI_Comm mpiCommunicator;
+	/** \brief Rank of the process in the communicator. */
+	int cachedRank;
+	/** \brief Size of the communicator. */
+	int cachedSize;
+	/** \brief Topology of the communicator. */
+	int cachedTopology;
 };
 
 } // NiceMPi
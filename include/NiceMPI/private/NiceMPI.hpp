@@ -25,205 +25,1406 @@ SOFTWARE. */
 
 #include <cassert>
 #include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/private/LargeCount.h> // LargeCount
 
 namespace NiceMPI {
 
 inline Communicator::Communicator(MPI_Comm mpiCommunicator): handle(mpiCommunicator)
 {}
 
+inline CommunicatorRequest Communicator::asyncDuplicate() const {
+	NICEMPI_PROFILE_CALL();
+	CommunicatorRequest r;
+	handleError(MPI_Comm_idup(handle.get() ,&r.mpiCommunicator,&r.value));
+	return r;
+}
+
+inline Communicator Communicator::cartesian(const std::vector<int>& dimensions, const std::vector<bool>& periods,
+	bool reorder) const
+{
+	NICEMPI_PROFILE_CALL();
+	assert(dimensions.size() == periods.size());
+	const std::vector<int> mpiPeriods(periods.begin(),periods.end());
+	MPI_Comm created;
+	handleError(MPI_Cart_create(handle.get(),static_cast<int>(dimensions.size()),dimensions.data(),
+		mpiPeriods.data(),reorder,&created));
+	return Communicator{MPIcommunicatorHandle::adopt(created)};
+}
+
+inline std::vector<int> Communicator::coordinates() const {
+	int dimensionCount = 0;
+	handleError(MPI_Cartdim_get(handle.get(),&dimensionCount));
+	std::vector<int> result(dimensionCount);
+	handleError(MPI_Cart_coords(handle.get(),rank(),dimensionCount,result.data()));
+	return result;
+}
+
+inline Communicator Communicator::distGraph(const std::vector<int>& sources, const std::vector<int>& destinations,
+	bool reorder) const
+{
+	NICEMPI_PROFILE_CALL();
+	MPI_Comm created;
+	handleError(MPI_Dist_graph_create_adjacent(handle.get(),static_cast<int>(sources.size()),sources.data(),
+		MPI_UNWEIGHTED,static_cast<int>(destinations.size()),destinations.data(),MPI_UNWEIGHTED,MPI_INFO_NULL,reorder,
+		&created));
+	return Communicator{MPIcommunicatorHandle::adopt(created)};
+}
+
+inline Communicator Communicator::duplicate() const {
+	NICEMPI_PROFILE_CALL();
+	return *this;
+}
+
 inline MPI_Comm Communicator::get() const {
 	return handle.get() ;
 }
 
+inline std::vector<int> Communicator::neighborDestinations() const {
+	if(topology() == MPI_CART) return neighborSources();
+	const std::array<int,2> counts = countNeighbors();
+	std::vector<int> sources(counts[0]), destinations(counts[1]);
+	handleError(MPI_Dist_graph_neighbors(handle.get(),counts[0],sources.data(),MPI_UNWEIGHTED,counts[1],
+		destinations.data(),MPI_UNWEIGHTED));
+	return destinations;
+}
+
+inline std::vector<int> Communicator::neighborSources() const {
+	std::vector<int> sources;
+	if(topology() == MPI_CART) {
+		const int dimensionCount = countNeighbors()[0]/2;
+		for(int i = 0; i < dimensionCount; ++i) {
+			const Shift neighbors = shift(i);
+			sources.push_back(neighbors.source);
+			sources.push_back(neighbors.destination);
+		}
+		return sources;
+	}
+	const std::array<int,2> counts = countNeighbors();
+	sources.resize(counts[0]);
+	std::vector<int> destinations(counts[1]);
+	handleError(MPI_Dist_graph_neighbors(handle.get(),counts[0],sources.data(),MPI_UNWEIGHTED,counts[1],
+		destinations.data(),MPI_UNWEIGHTED));
+	return sources;
+}
+
 inline int Communicator::rank() const {
-	int rank;
-	handleError(MPI_Comm_rank(handle.get() , &rank));
-	return rank;
+	return handle.rank();
+}
+
+inline int Communicator::rankOf(const std::vector<int>& coordinates) const {
+	int result = MPI_PROC_NULL;
+	handleError(MPI_Cart_rank(handle.get(),coordinates.data(),&result));
+	return result;
+}
+
+inline Communicator Communicator::shared() const {
+	return Communicator{handle.shared()};
+}
+
+inline Shift Communicator::shift(int dimension, int displacement) const {
+	Shift result;
+	handleError(MPI_Cart_shift(handle.get(),dimension,displacement,&result.source,&result.destination));
+	return result;
 }
 
 inline int Communicator::size() const {
-	int size;
-	handleError(MPI_Comm_size(handle.get() , &size));
-	return size;
+	return handle.size();
 }
 
 inline Communicator Communicator::split(int color, int key) const {
+	NICEMPI_PROFILE_CALL();
 	MPI_Comm splitted;
 	handleError(MPI_Comm_split(handle.get() ,color,key,&splitted));
-	return Communicator{&splitted};
+	return Communicator{MPIcommunicatorHandle::adopt(splitted)};
 }
 
+inline Communicator Communicator::splitNodeLeaders() const {
+	NICEMPI_PROFILE_CALL();
+	const bool isLeader = splitShared().rank() == 0;
+	return split(isLeader ? 0 : MPI_UNDEFINED,rank());
+}
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+inline Communicator Communicator::splitShared() const {
+	NICEMPI_PROFILE_CALL();
+	MPI_Comm splitted;
+	handleError(MPI_Comm_split_type(handle.get(),MPI_COMM_TYPE_SHARED,rank(),MPI_INFO_NULL,&splitted));
+	return Communicator{MPIcommunicatorHandle::adopt(splitted)};
+}
+
+inline int Communicator::topology() const {
+	return handle.topology();
+}
+
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline std::vector<Type> Communicator::allGather(Type data) {
+	NICEMPI_PROFILE(data);
 	std::vector<Type> result(size());
-	handleError(MPI_Allgather(&data,sizeof(Type),MPI_UNSIGNED_CHAR,result.data(),sizeof(Type),MPI_UNSIGNED_CHAR,
-		handle.get() ));
+	allGather(data,makeSpan(result));
 	return result;
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
 inline std::vector<typename Collection::value_type> Communicator::allGather(const Collection& data) {
+	NICEMPI_PROFILE(data);
 	using Type = typename Collection::value_type;
 	std::vector<Type> result(size()*data.size());
-	handleError(MPI_Allgather(data.data(),sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR,result.data(),
-		sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR, handle.get() ));
+	allGather(data,makeSpan(result));
+	return result;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline void Communicator::allGather(Type data, Span<Type> result) {
+	NICEMPI_PROFILE(data);
+	assert(result.size() >= static_cast<std::size_t>(size()));
+	handleError(MPI_Allgather(&data,1,mpi_datatype<Type>::get(),result.data(),1,mpi_datatype<Type>::get(),
+		handle.get() ));
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline void Communicator::allGather(const Collection& data, Span<typename Collection::value_type> result) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	assert(result.size() >= size()*data.size());
+	handleError(LargeCount::allGather(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),handle.get()));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::allGatherInPlace(Span<Type> data) {
+	NICEMPI_PROFILE(data);
+	assert(data.size() % size() == 0);
+	handleError(LargeCount::allGather(MPI_IN_PLACE,data.data(),data.size()/size(),mpi_datatype<Type>::get(),
+		handle.get() ));
+}
+
+template<typename Type, class Operator,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline Type Communicator::allReduce(Type data, Operator op) {
+	NICEMPI_PROFILE(data);
+	Type result;
+	handleError(MPI_Allreduce(&data,&result,1,mpi_datatype<Type>::get(),mpi_operator<Operator,Type>::get(op),
+		handle.get() ));
 	return result;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+template<class Collection, class Operator,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline Collection Communicator::allReduce(const Collection& data, Operator op) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	Collection result = initializeWithCount(Collection{},data.size());
+	handleError(LargeCount::allReduce(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),handle.get() ));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::allToAll(const std::vector<Type>& toSend, std::size_t sendCount) {
+	NICEMPI_PROFILE(toSend);
+	std::vector<Type> result(sendCount*size());
+	allToAll(toSend,makeSpan(result));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::allToAll(const std::vector<Type>& toSend, Span<Type> result) {
+	NICEMPI_PROFILE(toSend);
+	assert(toSend.size() >= result.size());
+	handleError(LargeCount::allToAll(toSend.data(),result.data(),result.size()/size(),mpi_datatype<Type>::get(),
+		handle.get() ));
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncAllGather(Type data) {
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<std::vector<Type>> r(size());
+	const auto toSend = std::make_shared<Type>(data);
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(MPI_Iallgather(toSend.get(),1,mpi_datatype<Type>::get(),r.data->data(),1,mpi_datatype<Type>::get(),
+		handle.get(),&r.value));
+	return r;
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+		bool>::type
+>
+inline ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+Communicator::asyncAllGather(Collection&& data) {
+	NICEMPI_PROFILE(data);
+	using Type = typename std::decay<Collection>::type::value_type;
+	ReceiveRequest<std::vector<Type>> r(size()*data.size());
+	const auto toSend = ownedData(std::forward<Collection>(data));
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(LargeCount::asyncAllGather(toSend->data(),r.data->data(),toSend->size(),mpi_datatype<Type>::get(),
+		handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type, class Operator,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline ReceiveRequest<Type> Communicator::asyncAllReduce(Type data, Operator op) {
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<Type> r(1);
+	const auto toSend = std::make_shared<Type>(data);
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(MPI_Iallreduce(toSend.get(),r.data->data(),1,mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),handle.get(),&r.value));
+	return r;
+}
+
+template<class Collection, class Operator,
+	typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+		bool>::type
+>
+inline ReceiveRequest<typename std::decay<Collection>::type> Communicator::asyncAllReduce(Collection&& data,
+	Operator op)
+{
+	NICEMPI_PROFILE(data);
+	using Type = typename std::decay<Collection>::type::value_type;
+	ReceiveRequest<typename std::decay<Collection>::type> r(data.size());
+	const auto toSend = ownedData(std::forward<Collection>(data));
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(LargeCount::asyncAllReduce(toSend->data(),r.data->data(),toSend->size(),mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncAllToAll(std::vector<Type> toSend,
+	std::size_t sendCount)
+{
+	NICEMPI_PROFILE(toSend);
+	assert(toSend.size() >= sendCount*size());
+	ReceiveRequest<std::vector<Type>> r(sendCount*size());
+	const auto copy = ownedData(std::move(toSend));
+	r.payload = copy;
+	r.cancellable = false;
+	handleError(LargeCount::asyncAllToAll(copy->data(),r.data->data(),sendCount,mpi_datatype<Type>::get(),
+		handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline ReceiveRequest<Type> Communicator::asyncBroadcast(int source, Type data) {
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<Type> r(1);
+	(*r.data)[0] = data;
+	r.cancellable = false;
+	handleError(MPI_Ibcast(r.data->data(),1,mpi_datatype<Type>::get(),source,handle.get(),&r.value));
+	return r;
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+		!is_span<Collection>::value,bool>::type
+>
+inline ReceiveRequest<Collection> Communicator::asyncBroadcast(int source, Collection data) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	ReceiveRequest<Collection> r(0);
+	r.cancellable = false;
+	if(rank() == source or is_std_array<Collection>::value) r.data->assign(data.begin(),data.end());
+	if(is_std_array<Collection>::value) {
+		handleError(LargeCount::asyncBroadcast(r.data->data(),r.data->size(),mpi_datatype<Type>::get(),source,
+			handle.get(),&r.value));
+		return r;
+	}
+
+	const auto received = r.data;
+	const auto broadcast = OrderedBroadcasts::add(handle,data.size(),source,
+		[received,source](std::size_t count, MPI_Comm communicator, MPI_Request& request) {
+			received->resize(count);
+			handleError(LargeCount::asyncBroadcast(received->data(),count,mpi_datatype<Type>::get(),source,
+				communicator,&request));
+		});
+	r.nextStep = [broadcast](MPI_Request& request) {
+		return OrderedBroadcasts::start(broadcast,request);
+	};
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncGather(int source, Type data) {
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<std::vector<Type>> r(rank() == source ? size() : 0);
+	const auto toSend = std::make_shared<Type>(data);
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(MPI_Igather(toSend.get(),1,mpi_datatype<Type>::get(),r.data->data(),1,mpi_datatype<Type>::get(),
+		source,handle.get(),&r.value));
+	return r;
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+		bool>::type
+>
+inline ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+Communicator::asyncGather(int source, Collection&& data) {
+	NICEMPI_PROFILE(data);
+	using Type = typename std::decay<Collection>::type::value_type;
+	ReceiveRequest<std::vector<Type>> r(rank() == source ? size()*data.size() : 0);
+	const auto toSend = ownedData(std::forward<Collection>(data));
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(LargeCount::asyncGather(toSend->data(),r.data->data(),toSend->size(),mpi_datatype<Type>::get(),
+		source,handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncNeighborAllGather(Type data) {
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<std::vector<Type>> r(countNeighbors()[0]);
+	const auto toSend = std::make_shared<Type>(data);
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(MPI_Ineighbor_allgather(toSend.get(),1,mpi_datatype<Type>::get(),r.data->data(),1,
+		mpi_datatype<Type>::get(),handle.get(),&r.value));
+	return r;
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value,
+		bool>::type
+>
+inline ReceiveRequest<std::vector<typename std::decay<Collection>::type::value_type>>
+Communicator::asyncNeighborAllGather(Collection&& data) {
+	NICEMPI_PROFILE(data);
+	using Type = typename std::decay<Collection>::type::value_type;
+	ReceiveRequest<std::vector<Type>> r(countNeighbors()[0]*data.size());
+	const auto toSend = ownedData(std::forward<Collection>(data));
+	r.payload = toSend;
+	r.cancellable = false;
+	handleError(LargeCount::asyncNeighborAllGather(toSend->data(),r.data->data(),toSend->size(),
+		mpi_datatype<Type>::get(),handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncNeighborAllToAll(std::vector<Type> toSend) {
+	NICEMPI_PROFILE(toSend);
+	const std::array<int,2> counts = countNeighbors();
+	assert(counts[1] > 0 or toSend.empty());
+	const std::size_t sendCount = counts[1] > 0 ? toSend.size()/counts[1] : 0;
+	ReceiveRequest<std::vector<Type>> r(sendCount*counts[0]);
+	const auto copy = ownedData(std::move(toSend));
+	r.payload = copy;
+	r.cancellable = false;
+	handleError(LargeCount::asyncNeighborAllToAll(copy->data(),r.data->data(),sendCount,mpi_datatype<Type>::get(),
+		handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncNeighborVaryingAllToAll(std::vector<Type> toSend,
+	const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts)
+{
+	NICEMPI_PROFILE(toSend);
+	ReceiveRequest<std::vector<Type>> r(sum(receiveCounts));
+	r.cancellable = false;
+	const auto copy = ownedData(std::move(toSend));
+	std::shared_ptr<void> arguments;
+	handleError(LargeCount::asyncNeighborVaryingAllToAll(copy->data(),sendCounts,
+		createDefaultDisplacements(sendCounts),r.data->data(),receiveCounts,createDefaultDisplacements(receiveCounts),
+		mpi_datatype<Type>::get(),handle.get(),&r.value,arguments));
+	r.payload = keepAlive(copy,arguments);
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline ReceiveRequest<Type> Communicator::asyncReceive(int source, int tag) {
+	NICEMPI_PROFILE_CALL();
 	ReceiveRequest<Type> r(1);
-	handleError(MPI_Irecv(r.data.data(),sizeof(Type),MPI_UNSIGNED_CHAR,source,tag,handle.get(),&r.value));
+	handleError(MPI_Irecv(r.data->data(),1,mpi_datatype<Type>::get(),source,tag,handle.get(),&r.value));
 	return r;
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
-inline ReceiveRequest<Collection> Communicator::asyncReceive(int count, int source, int tag) {
+inline ReceiveRequest<Collection> Communicator::asyncReceive(std::size_t count, int source, int tag) {
+	NICEMPI_PROFILE_CALL();
 	using Type = typename Collection::value_type;
 	ReceiveRequest<Collection> r(count);
-	handleError(MPI_Irecv(r.data.data(),sizeof(Type)*count,MPI_UNSIGNED_CHAR,source,tag,handle.get(),&r.value));
+	handleError(LargeCount::asyncReceive(r.data->data(),count,mpi_datatype<Type>::get(),source,tag,handle.get(),
+		&r.value));
 	return r;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
-inline SendRequest Communicator::asyncSend(Type data, int destination, int tag) {
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline SendRequest Communicator::asyncReceive(StridedView<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
 	MPI_Request x;
-	handleError(MPI_Isend(&data,sizeof(Type),MPI_UNSIGNED_CHAR,destination,tag,handle.get(),&x));
-	return SendRequest(x);
+	handleError(MPI_Irecv(data.data(),1,data.datatype(),source,tag,handle.get(),&x));
+	return SendRequest(x,nullptr,true);
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline DeviceRequest Communicator::asyncReceive(DeviceSpan<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	const std::shared_ptr<DeviceBackend> backend = DeviceBackend::current();
+	backend->synchronize(data.stream());
+	MPI_Request x;
+	if(backend->isMPIaware()) {
+		handleError(LargeCount::asyncReceive(data.data(),data.size(),mpi_datatype<Type>::get(),source,tag,
+			handle.get(),&x));
+		return DeviceRequest(x,true);
+	}
+	// The same chunks as receive(DeviceSpan), each one copied to the device when its receive is found completed
+	const std::size_t chunk = std::max<std::size_t>(1,backend->chunkBytes()/sizeof(Type));
+	const std::size_t chunks = std::max<std::size_t>(1,(data.size() + chunk - 1)/chunk);
+	const auto countOf = [chunk,data](std::size_t i) { return std::min(chunk,data.size() - i*chunk); };
+	const auto staging = std::make_shared<StagingBuffer<Type>>(data.size());
+	const auto requests = std::make_shared<std::vector<MPI_Request>>(chunks,MPI_REQUEST_NULL);
+	const MPI_Comm communicator = handle.get();
+	const auto post = [chunk,countOf,staging,requests,communicator](std::size_t first, std::size_t last, int from,
+		int withTag)
+	{
+		for(std::size_t i = first; i < last; ++i) {
+			handleError(MPI_Irecv(staging->data() + i*chunk,static_cast<int>(countOf(i)),mpi_datatype<Type>::get(),
+				from,withTag,communicator,&(*requests)[i]));
+		}
+	};
+	// With MPI_ANY_SOURCE or MPI_ANY_TAG, the first chunk fixes the source and the tag of the others
+	const bool wildcard = source == MPI_ANY_SOURCE or tag == MPI_ANY_TAG;
+	post(0,wildcard ? 1 : chunks,source,tag);
+	x = (*requests)[0];
+	std::size_t current = 0;
+	return DeviceRequest(x,wildcard or chunks == 1,staging,[backend,data,chunk,chunks,countOf,staging,requests,post,
+		wildcard,current](MPI_Request& request, const MPI_Status& status) mutable
+	{
+		if(current == 0 and wildcard) post(1,chunks,status.MPI_SOURCE,status.MPI_TAG);
+		backend->copyToDevice(data.data() + current*chunk,staging->data() + current*chunk,
+			countOf(current)*sizeof(Type),data.stream());
+		if(++current < chunks) {
+			request = (*requests)[current];
+			return false;
+		}
+		backend->synchronize(data.stream());
+		return true;
+	});
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
-inline SendRequest Communicator::asyncSend(const Collection& data, int destination, int tag) {
+inline ReceiveRequest<Collection> Communicator::asyncReceiveMessage(int source, int tag) {
+	NICEMPI_PROFILE_CALL();
 	using Type = typename Collection::value_type;
+	ReceiveRequest<Collection> r(0);
+	const auto received = r.data;
+	const MPI_Comm communicator = handle.get();
+	r.nextStep = [received,source,tag,communicator](MPI_Request& request) {
+		int flag = 0;
+		MPI_Message message;
+		MPI_Status status;
+		handleError(MPI_Improbe(source,tag,communicator,&flag,&message,&status));
+		if(flag == 0) return false;
+		std::size_t count = 0;
+		handleError(LargeCount::getCount(status,mpi_datatype<Type>::get(),&count));
+		received->resize(count);
+		handleError(LargeCount::asyncMatchedReceive(received->data(),count,mpi_datatype<Type>::get(),&message,
+			&request));
+		return true;
+	};
+	r.startNextStep();
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncScatter(int source, std::vector<Type> toSend,
+	std::size_t sendCount)
+{
+	NICEMPI_PROFILE(toSend);
+	const bool enoughDataToSend = toSend.size() >= sendCount*size();
+	assert(rank() != source or enoughDataToSend); UNUSED(enoughDataToSend);
+	ReceiveRequest<std::vector<Type>> r(sendCount);
+	const auto copy = rank() == source ? ownedData(std::move(toSend)) : std::make_shared<std::vector<Type>>();
+	r.payload = copy;
+	r.cancellable = false;
+	handleError(LargeCount::asyncScatter(copy->data(),r.data->data(),sendCount,mpi_datatype<Type>::get(),source,
+		handle.get(),&r.value));
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline SendRequest Communicator::asyncSend(Type data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	const auto owned = std::make_shared<Type>(data);
+	MPI_Request x;
+	handleError(MPI_Isend(owned.get(),1,mpi_datatype<Type>::get(),destination,tag,handle.get(),&x));
+	return SendRequest(x,owned);
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename std::decay<Collection>::type::value_type>::value and
+		!is_span<typename std::decay<Collection>::type>::value,bool>::type
+>
+inline SendRequest Communicator::asyncSend(Collection&& data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	using Owned = typename std::decay<Collection>::type;
+	using Type = typename Owned::value_type;
+	const auto owned = std::make_shared<Owned>(std::forward<Collection>(data));
 	MPI_Request x;
-	handleError(MPI_Isend(data.data(),sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR,destination,tag,handle.get(),&x));
+	handleError(LargeCount::asyncSend(owned->data(),owned->size(),mpi_datatype<Type>::get(),destination,tag,
+		handle.get(),&x));
+	return SendRequest(x,owned);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline SendRequest Communicator::asyncSend(Span<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	using Value = typename Span<Type>::value_type;
+	MPI_Request x;
+	handleError(LargeCount::asyncSend(data.data(),data.size(),mpi_datatype<Value>::get(),destination,tag,
+		handle.get(),&x));
 	return SendRequest(x);
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline SendRequest Communicator::asyncSend(StridedView<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	MPI_Request x;
+	handleError(MPI_Isend(data.data(),1,data.datatype(),destination,tag,handle.get(),&x));
+	return SendRequest(x);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline DeviceRequest Communicator::asyncSend(DeviceSpan<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	using Value = typename std::remove_const<Type>::type;
+	const std::shared_ptr<DeviceBackend> backend = DeviceBackend::current();
+	backend->synchronize(data.stream());
+	MPI_Request x;
+	if(backend->isMPIaware()) {
+		handleError(LargeCount::asyncSend(data.data(),data.size(),mpi_datatype<Value>::get(),destination,tag,
+			handle.get(),&x));
+		return DeviceRequest(x,false);
+	}
+	// The same chunks as send(DeviceSpan), all started here: the copy of a chunk overlaps the send of the previous
+	// ones, which are detached, so that the request completes with the last one
+	const std::size_t chunk = std::max<std::size_t>(1,backend->chunkBytes()/sizeof(Value));
+	const std::size_t chunks = std::max<std::size_t>(1,(data.size() + chunk - 1)/chunk);
+	const auto countOf = [chunk,&data](std::size_t i) { return std::min(chunk,data.size() - i*chunk); };
+	const auto staging = std::make_shared<StagingBuffer<Value>>(data.size());
+	const auto copy = [&](std::size_t i) {
+		backend->copyToHost(staging->data() + i*chunk,data.data() + i*chunk,countOf(i)*sizeof(Value),data.stream());
+	};
+	copy(0);
+	for(std::size_t i = 0; i < chunks; ++i) {
+		backend->synchronize(data.stream());
+		if(i > 0) DetachedRequests::add(x,staging,false);
+		handleError(MPI_Isend(staging->data() + i*chunk,static_cast<int>(countOf(i)),mpi_datatype<Value>::get(),
+			destination,tag,handle.get(),&x));
+		if(i + 1 < chunks) copy(i + 1);
+	}
+	return DeviceRequest(x,false,staging);
+}
+
+template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type>
+inline SendRequest Communicator::asyncSend(const Type& data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	const auto owned = std::make_shared<std::vector<unsigned char>>();
+	serialize(data,*owned);
+	MPI_Request x;
+	handleError(LargeCount::asyncSend(owned->data(),owned->size(),MPI_BYTE,destination,tag,handle.get(),&x));
+	return SendRequest(x,owned);
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncVaryingAllGather(std::vector<Type> data,
+	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<std::vector<Type>> r(sum(receiveCounts));
+	r.cancellable = false;
+	const std::vector<std::size_t> actualDisplacements = displacements.empty() ?
+		createDefaultDisplacements(receiveCounts) : toLargeDisplacements(displacements);
+	const auto toSend = ownedData(std::move(data));
+	std::shared_ptr<void> arguments;
+	handleError(LargeCount::asyncVaryingAllGather(toSend->data(), toSend->size(), r.data->data(), receiveCounts,
+		actualDisplacements, mpi_datatype<Type>::get(), handle.get(), &r.value, arguments));
+	r.payload = keepAlive(toSend,arguments);
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncVaryingAllToAll(std::vector<Type> toSend,
+	const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts,
+	const std::vector<int>& sendDisplacements, const std::vector<int>& receiveDisplacements)
+{
+	NICEMPI_PROFILE(toSend);
+	ReceiveRequest<std::vector<Type>> r(sum(receiveCounts));
+	r.cancellable = false;
+	const std::vector<std::size_t> actualSendDisplacements = sendDisplacements.empty() ?
+		createDefaultDisplacements(sendCounts) : toLargeDisplacements(sendDisplacements);
+	const std::vector<std::size_t> actualReceiveDisplacements = receiveDisplacements.empty() ?
+		createDefaultDisplacements(receiveCounts) : toLargeDisplacements(receiveDisplacements);
+	const auto copy = ownedData(std::move(toSend));
+	std::shared_ptr<void> arguments;
+	handleError(LargeCount::asyncVaryingAllToAll(copy->data(), sendCounts, actualSendDisplacements, r.data->data(),
+		receiveCounts, actualReceiveDisplacements, mpi_datatype<Type>::get(), handle.get(), &r.value, arguments));
+	r.payload = keepAlive(copy,arguments);
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncVaryingGather(int source, std::vector<Type> data,
+	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(data);
+	ReceiveRequest<std::vector<Type>> r(rank() == source ? sum(receiveCounts) : 0);
+	r.cancellable = false;
+	std::vector<std::size_t> actualDisplacements;
+	if(rank() == source) {
+		if(displacements.empty()) actualDisplacements = createDefaultDisplacements(receiveCounts);
+		else actualDisplacements = toLargeDisplacements(displacements);
+	}
+	const auto toSend = ownedData(std::move(data));
+	std::shared_ptr<void> arguments;
+	handleError(LargeCount::asyncVaryingGather(toSend->data(), toSend->size(), r.data->data(), receiveCounts,
+		actualDisplacements, mpi_datatype<Type>::get(), source, handle.get(), &r.value, arguments));
+	r.payload = keepAlive(toSend,arguments);
+	return r;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline ReceiveRequest<std::vector<Type>> Communicator::asyncVaryingScatter(int source,
+	std::vector<Type> toSend, const std::vector<int>& sendCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(toSend);
+	assert(static_cast<int>(sendCounts.size()) >= size());
+	ReceiveRequest<std::vector<Type>> r(sendCounts[rank()]);
+	r.cancellable = false;
+	const std::vector<std::size_t> actualDisplacements = displacements.empty() ?
+		createDefaultDisplacements(sendCounts) : toLargeDisplacements(displacements);
+	const auto copy = rank() == source ? ownedData(std::move(toSend)) : std::make_shared<std::vector<Type>>();
+	std::shared_ptr<void> arguments;
+	handleError(LargeCount::asyncVaryingScatter(copy->data(), sendCounts, actualDisplacements, r.data->data(),
+		r.data->size(), mpi_datatype<Type>::get(), source, handle.get(), &r.value, arguments));
+	r.payload = keepAlive(copy,arguments);
+	return r;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline Type Communicator::broadcast(int source, Type data) {
-	handleError(MPI_Bcast(&data,sizeof(Type),MPI_UNSIGNED_CHAR,source,handle.get() ));
+	NICEMPI_PROFILE(data);
+	handleError(MPI_Bcast(&data,1,mpi_datatype<Type>::get(),source,handle.get() ));
 	return data;
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+		!is_span<Collection>::value,bool>::type
 >
 inline Collection Communicator::broadcast(int source, Collection data) {
-	using Type = typename Collection::value_type;
+	NICEMPI_PROFILE(data);
 	auto sizeToBroadcast = broadcast(source,data.size());
 	if(rank() != source) data = initializeWithCount(Collection{},sizeToBroadcast);
-	handleError(MPI_Bcast(data.data(),sizeof(Type)*sizeToBroadcast,MPI_UNSIGNED_CHAR,source,handle.get() ));
+	broadcast(source,makeSpan(data));
 	return data;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type>
+inline Type Communicator::broadcast(int source, const Type& data) {
+	NICEMPI_PROFILE(data);
+	std::vector<unsigned char>& buffer = serializationBuffer();
+	if(rank() == source) serialize(data,buffer);
+	buffer.resize(broadcast(source,buffer.size()));
+	broadcast(source,makeSpan(buffer));
+	if(rank() == source) return data;
+	return deserialize<Type>(buffer);
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::broadcast(int source, Span<Type> data) {
+	NICEMPI_PROFILE(data);
+	handleError(LargeCount::broadcast(data.data(),data.size(),mpi_datatype<Type>::get(),source,handle.get()));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::broadcast(int source, DeviceSpan<Type> data) {
+	NICEMPI_PROFILE(data);
+	const std::shared_ptr<DeviceBackend> backend = DeviceBackend::current();
+	backend->synchronize(data.stream());
+	if(backend->isMPIaware()) {
+		handleError(LargeCount::broadcast(data.data(),data.size(),mpi_datatype<Type>::get(),source,handle.get()));
+		return;
+	}
+	StagingBuffer<Type> staging(data.size());
+	if(rank() == source) {
+		backend->copyToHost(staging.data(),data.data(),data.size()*sizeof(Type),data.stream());
+		backend->synchronize(data.stream());
+	}
+	handleError(LargeCount::broadcast(staging.data(),staging.size(),mpi_datatype<Type>::get(),source,handle.get()));
+	if(rank() == source) return;
+	backend->copyToDevice(data.data(),staging.data(),data.size()*sizeof(Type),data.stream());
+	backend->synchronize(data.stream());
+}
+
+inline std::vector<int> Communicator::exchangeCounts(const std::vector<int>& sendCounts) {
+	NICEMPI_PROFILE_CALL();
+	assert(static_cast<int>(sendCounts.size()) >= size());
+	std::vector<int> receiveCounts(size());
+	handleError(MPI_Alltoall(sendCounts.data(),1,MPI_INT,receiveCounts.data(),1,MPI_INT,handle.get() ));
+	return receiveCounts;
+}
+
+template<typename Type, class Operator,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline Type Communicator::exScan(Type data, Operator op) {
+	NICEMPI_PROFILE(data);
+	Type result = data;
+	handleError(MPI_Exscan(&data,&result,1,mpi_datatype<Type>::get(),mpi_operator<Operator,Type>::get(op),
+		handle.get() ));
+	return result;
+}
+
+template<class Collection, class Operator,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline Collection Communicator::exScan(const Collection& data, Operator op) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	Collection result = data;
+	handleError(LargeCount::exScan(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),handle.get() ));
+	return result;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline std::vector<Type> Communicator::gather(int source, Type data) {
+	NICEMPI_PROFILE(data);
 	std::vector<Type> result;
 	if(rank() == source) result.resize(size());
-	handleError(MPI_Gather(&data,sizeof(Type),MPI_UNSIGNED_CHAR,result.data(),sizeof(Type),MPI_UNSIGNED_CHAR,source,
-		handle.get() ));
+	gather(source,data,makeSpan(result));
 	return result;
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
 std::vector<typename Collection::value_type> Communicator::gather(int source, const Collection& data) {
+	NICEMPI_PROFILE(data);
 	using Type = typename Collection::value_type;
 	std::vector<Type> result;
 	if(rank() == source) result.resize(size()*data.size());
-	handleError(MPI_Gather(data.data(),sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR,result.data(),
-		sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR,source,handle.get() ));
+	gather(source,data,makeSpan(result));
+	return result;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline void Communicator::gather(int source, Type data, Span<Type> result) {
+	NICEMPI_PROFILE(data);
+	assert(rank() != source or result.size() >= static_cast<std::size_t>(size()));
+	handleError(MPI_Gather(&data,1,mpi_datatype<Type>::get(),result.data(),1,mpi_datatype<Type>::get(),source,
+		handle.get() ));
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline void Communicator::gather(int source, const Collection& data, Span<typename Collection::value_type> result) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	assert(rank() != source or result.size() >= size()*data.size());
+	handleError(LargeCount::gather(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),source,
+		handle.get() ));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::gatherInPlace(int source, Span<Type> data) {
+	NICEMPI_PROFILE(data);
+	if(rank() == source) {
+		assert(data.size() % size() == 0);
+		handleError(LargeCount::gather(MPI_IN_PLACE,data.data(),data.size()/size(),mpi_datatype<Type>::get(),source,
+			handle.get() ));
+	}
+	else {
+		handleError(LargeCount::gather(data.data(),nullptr,data.size(),mpi_datatype<Type>::get(),source,
+			handle.get() ));
+	}
+}
+
+#if MPI_VERSION >= 4
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline PersistentRequest Communicator::makePartitionedReceive(Span<Type> data, int partitions, int source, int tag)
+{
+	NICEMPI_PROFILE(data);
+	assert(partitions > 0 and data.size() % partitions == 0);
+	MPI_Request x;
+	handleError(MPI_Precv_init(data.data(),partitions,data.size()/partitions,mpi_datatype<Type>::get(),source,tag,
+		handle.get(),MPI_INFO_NULL,&x));
+	return PersistentRequest(x);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline PersistentRequest Communicator::makePartitionedSend(Span<Type> data, int partitions, int destination,
+	int tag)
+{
+	NICEMPI_PROFILE(data);
+	using Value = typename Span<Type>::value_type;
+	assert(partitions > 0 and data.size() % partitions == 0);
+	MPI_Request x;
+	handleError(MPI_Psend_init(data.data(),partitions,data.size()/partitions,mpi_datatype<Value>::get(),
+		destination,tag,handle.get(),MPI_INFO_NULL,&x));
+	return PersistentRequest(x);
+}
+#endif
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline PersistentRequest Communicator::makePersistentReceive(Span<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	MPI_Request x;
+	std::shared_ptr<void> datatypeOwner;
+	handleError(LargeCount::receiveInit(data.data(),data.size(),mpi_datatype<Type>::get(),source,tag,handle.get(),
+		&x,datatypeOwner));
+	return PersistentRequest(x,datatypeOwner);
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline PersistentRequest Communicator::makePersistentReceive(StridedView<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	MPI_Request x;
+	handleError(MPI_Recv_init(data.data(),1,data.datatype(),source,tag,handle.get(),&x));
+	return PersistentRequest(x);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline PersistentRequest Communicator::makePersistentSend(Span<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	using Value = typename Span<Type>::value_type;
+	MPI_Request x;
+	std::shared_ptr<void> datatypeOwner;
+	handleError(LargeCount::sendInit(data.data(),data.size(),mpi_datatype<Value>::get(),destination,tag,
+		handle.get(),&x,datatypeOwner));
+	return PersistentRequest(x,datatypeOwner);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline PersistentRequest Communicator::makePersistentSend(StridedView<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	MPI_Request x;
+	handleError(MPI_Send_init(data.data(),1,data.datatype(),destination,tag,handle.get(),&x));
+	return PersistentRequest(x);
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline std::vector<Type> Communicator::neighborAllGather(Type data) {
+	NICEMPI_PROFILE(data);
+	std::vector<Type> result(countNeighbors()[0]);
+	handleError(MPI_Neighbor_allgather(&data,1,mpi_datatype<Type>::get(),result.data(),1,mpi_datatype<Type>::get(),
+		handle.get()));
 	return result;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline std::vector<typename Collection::value_type> Communicator::neighborAllGather(const Collection& data) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	std::vector<Type> result(countNeighbors()[0]*data.size());
+	handleError(LargeCount::neighborAllGather(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),
+		handle.get()));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::neighborAllToAll(const std::vector<Type>& toSend) {
+	NICEMPI_PROFILE(toSend);
+	const std::array<int,2> counts = countNeighbors();
+	assert(counts[1] > 0 or toSend.empty());
+	const std::size_t sendCount = counts[1] > 0 ? toSend.size()/counts[1] : 0;
+	std::vector<Type> result(sendCount*counts[0]);
+	handleError(LargeCount::neighborAllToAll(toSend.data(),result.data(),sendCount,mpi_datatype<Type>::get(),
+		handle.get()));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::neighborVaryingAllToAll(const std::vector<Type>& toSend,
+	const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts)
+{
+	NICEMPI_PROFILE(toSend);
+	std::vector<Type> result(sum(receiveCounts));
+	handleError(LargeCount::neighborVaryingAllToAll(toSend.data(),sendCounts,createDefaultDisplacements(sendCounts),
+		result.data(),receiveCounts,createDefaultDisplacements(receiveCounts),mpi_datatype<Type>::get(),
+		handle.get()));
+	return result;
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline Type Communicator::receive(int source, int tag) {
+	NICEMPI_PROFILE_CALL();
 	Type data;
-	handleError(MPI_Recv(&data,sizeof(Type),MPI_UNSIGNED_CHAR,source,tag,handle.get() ,MPI_STATUS_IGNORE));
+	handleError(MPI_Recv(&data,1,mpi_datatype<Type>::get(),source,tag,handle.get() ,MPI_STATUS_IGNORE));
 	return data;
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
-Collection Communicator::receive(int count, int source, int tag) {
+Collection Communicator::receive(std::size_t count, int source, int tag) {
+	NICEMPI_PROFILE_CALL();
 	Collection data = initializeWithCount(Collection{},count);
-	using Type = typename Collection::value_type;
-	handleError(MPI_Recv(data.data(),sizeof(Type)*count,MPI_UNSIGNED_CHAR,source,tag,handle.get() ,MPI_STATUS_IGNORE));
+	receive(makeSpan(data),source,tag);
 	return data;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type>
-inline std::vector<Type> Communicator::scatter(int source, const std::vector<Type>& toSend, int sendCount) {
-	const bool enoughDataToSend = (static_cast<int>(toSend.size()) - sendCount*size()) >= 0;
-	assert(rank() != source or enoughDataToSend); UNUSED(enoughDataToSend);
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::receive(Span<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	handleError(LargeCount::receive(data.data(),data.size(),mpi_datatype<Type>::get(),source,tag,handle.get(),
+		MPI_STATUS_IGNORE));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::receive(StridedView<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	handleError(MPI_Recv(data.data(),1,data.datatype(),source,tag,handle.get(),MPI_STATUS_IGNORE));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::receive(DeviceSpan<Type> data, int source, int tag) {
+	NICEMPI_PROFILE(data);
+	const std::shared_ptr<DeviceBackend> backend = DeviceBackend::current();
+	backend->synchronize(data.stream());
+	if(backend->isMPIaware()) {
+		handleError(LargeCount::receive(data.data(),data.size(),mpi_datatype<Type>::get(),source,tag,handle.get(),
+			MPI_STATUS_IGNORE));
+		return;
+	}
+	const std::size_t chunk = std::max<std::size_t>(1,backend->chunkBytes()/sizeof(Type));
+	const std::size_t chunks = std::max<std::size_t>(1,(data.size() + chunk - 1)/chunk);
+	const auto countOf = [&](std::size_t i) { return std::min(chunk,data.size() - i*chunk); };
+	const std::size_t capacity = std::min(chunk,data.size());
+	std::array<StagingBuffer<Type>,2> staging{{ StagingBuffer<Type>(capacity), StagingBuffer<Type>(capacity) }};
+	std::array<MPI_Request,2> requests{{ MPI_REQUEST_NULL, MPI_REQUEST_NULL }};
+	const auto post = [&](std::size_t i) {
+		handleError(MPI_Irecv(staging[i%2].data(),static_cast<int>(countOf(i)),mpi_datatype<Type>::get(),source,tag,
+			handle.get(),&requests[i%2]));
+	};
+	// The first chunk fixes the source and the tag of the others, in case of MPI_ANY_SOURCE or MPI_ANY_TAG
+	MPI_Status status;
+	post(0);
+	handleError(MPI_Wait(&requests[0],&status));
+	source = status.MPI_SOURCE;
+	tag = status.MPI_TAG;
+	if(chunks > 1) post(1);
+	for(std::size_t i = 0; i < chunks; ++i) {
+		handleError(MPI_Wait(&requests[i%2],MPI_STATUS_IGNORE));
+		backend->copyToDevice(data.data() + i*chunk,staging[i%2].data(),countOf(i)*sizeof(Type),data.stream());
+		if(i + 2 >= chunks) continue;
+		backend->synchronize(data.stream());
+		post(i + 2);
+	}
+	backend->synchronize(data.stream());
+}
+
+template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type>
+inline Type Communicator::receive(int source, int tag) {
+	NICEMPI_PROFILE_CALL();
+	MPI_Message message;
+	MPI_Status status;
+	handleError(MPI_Mprobe(source,tag,handle.get(),&message,&status));
+	std::size_t count = 0;
+	handleError(LargeCount::getCount(status,MPI_BYTE,&count));
+	std::vector<unsigned char>& buffer = serializationBuffer();
+	buffer.resize(count);
+	handleError(LargeCount::matchedReceive(buffer.data(),count,MPI_BYTE,&message));
+	return deserialize<Type>(buffer);
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline Message<Collection> Communicator::receiveMessage(int source, int tag) {
+	NICEMPI_PROFILE_CALL();
+	using Type = typename Collection::value_type;
+	MPI_Message message;
+	MPI_Status status;
+	handleError(MPI_Mprobe(source,tag,handle.get(),&message,&status));
+	std::size_t count = 0;
+	handleError(LargeCount::getCount(status,mpi_datatype<Type>::get(),&count));
+	Message<Collection> result{ initializeWithCount(Collection{},count), status.MPI_SOURCE, status.MPI_TAG };
+	handleError(LargeCount::matchedReceive(result.data.data(),result.data.size(),mpi_datatype<Type>::get(),
+		&message));
+	return result;
+}
+
+template<typename Type, class Operator,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline Type Communicator::reduce(int source, Type data, Operator op) {
+	NICEMPI_PROFILE(data);
+	Type result = data;
+	handleError(MPI_Reduce(&data,&result,1,mpi_datatype<Type>::get(),mpi_operator<Operator,Type>::get(op),source,
+		handle.get() ));
+	return result;
+}
+
+template<class Collection, class Operator,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline Collection Communicator::reduce(int source, const Collection& data, Operator op) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	Collection result = initializeWithCount(Collection{},rank() == source ? data.size() : 0);
+	handleError(LargeCount::reduce(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),source,handle.get() ));
+	return result;
+}
+
+template<typename Type, class Operator,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
+inline Type Communicator::scan(Type data, Operator op) {
+	NICEMPI_PROFILE(data);
+	Type result;
+	handleError(MPI_Scan(&data,&result,1,mpi_datatype<Type>::get(),mpi_operator<Operator,Type>::get(op),
+		handle.get() ));
+	return result;
+}
+
+template<class Collection, class Operator,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
+>
+inline Collection Communicator::scan(const Collection& data, Operator op) {
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	Collection result = initializeWithCount(Collection{},data.size());
+	handleError(LargeCount::scan(data.data(),result.data(),data.size(),mpi_datatype<Type>::get(),
+		mpi_operator<Operator,Type>::get(op),handle.get() ));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::scatter(int source, const std::vector<Type>& toSend, std::size_t sendCount) {
+	NICEMPI_PROFILE(toSend);
 	std::vector<Type> result(sendCount);
-	handleError(MPI_Scatter(toSend.data(), sendCount*sizeof(Type), MPI_UNSIGNED_CHAR, 
-		result.data(), sendCount*sizeof(Type), MPI_UNSIGNED_CHAR, source, handle.get() ));
+	scatter(source,toSend,makeSpan(result));
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::scatter(int source, const std::vector<Type>& toSend, Span<Type> result) {
+	NICEMPI_PROFILE(toSend);
+	const bool enoughDataToSend = toSend.size() >= result.size()*size();
+	assert(rank() != source or enoughDataToSend); UNUSED(enoughDataToSend);
+	handleError(LargeCount::scatter(toSend.data(),result.data(),result.size(),mpi_datatype<Type>::get(),source,
+		handle.get() ));
+}
+
+template<class Collection,
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value and
+		!is_span<Collection>::value and !is_std_array<Collection>::value,bool>::type
+>
+inline Collection Communicator::segmentedBroadcast(int source, Collection data, std::size_t segmentBytes,
+	const std::function<void(std::size_t,Span<const typename Collection::value_type>)>& consumer)
+{
+	NICEMPI_PROFILE(data);
+	using Type = typename Collection::value_type;
+	const std::size_t segment = std::max<std::size_t>(1,segmentBytes/sizeof(Type));
+	const std::size_t inFlight = 4;
+	std::vector<unsigned char> first(sizeof(std::uint64_t) + segment*sizeof(Type));
+	if(rank() == source) {
+		const std::uint64_t count = data.size();
+		std::memcpy(first.data(),&count,sizeof(count));
+		std::memcpy(first.data()+sizeof(count),data.data(),std::min(segment,data.size())*sizeof(Type));
+	}
+	handleError(LargeCount::broadcast(first.data(),first.size(),MPI_BYTE,source,handle.get()));
+
+	std::uint64_t count = 0;
+	std::memcpy(&count,first.data(),sizeof(count));
+	const std::size_t firstCount = std::min<std::size_t>(segment,count);
+	if(rank() != source) {
+		data = initializeWithCount(Collection{},count);
+		std::memcpy(data.data(),first.data()+sizeof(count),firstCount*sizeof(Type));
+	}
+
+	std::deque<std::pair<MPI_Request,std::size_t>> requests;
+	std::size_t next = firstCount;
+	const auto post = [&]() {
+		while(next < count and requests.size() < inFlight) {
+			requests.emplace_back(MPI_REQUEST_NULL,next);
+			handleError(LargeCount::asyncBroadcast(data.data()+next,std::min<std::size_t>(segment,count-next),
+				mpi_datatype<Type>::get(),source,handle.get(),&requests.back().first));
+			next += segment;
+		}
+	};
+	try {
+		post(); // The following segments are broadcast while the consumer processes the first one
+		if(consumer) consumer(0,Span<const Type>(data.data(),firstCount));
+		while(!requests.empty()) {
+			handleError(MPI_Wait(&requests.front().first,MPI_STATUS_IGNORE));
+			const std::size_t offset = requests.front().second;
+			requests.pop_front();
+			post();
+			const std::size_t length = std::min<std::size_t>(segment,count-offset);
+			if(consumer) consumer(offset,Span<const Type>(data.data()+offset,length));
+		}
+	} catch(...) {
+		// MPI must not write in data once destroyed, and the other processes wait for the segments left
+		while(!requests.empty()) {
+			MPI_Wait(&requests.front().first,MPI_STATUS_IGNORE);
+			requests.pop_front();
+			try {
+				post();
+			} catch(...) {
+				next = count; // The first exception is reported
+			}
+		}
+		throw;
+	}
+	return data;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::sparseAllToAll(const std::vector<Type>& toSend,
+	const std::vector<int>& sendCounts, int tag)
+{
+	NICEMPI_PROFILE(toSend);
+	const std::vector<int> receiveCounts = exchangeCounts(sendCounts);
+	const std::vector<std::size_t> sendDisplacements = createDefaultDisplacements(sendCounts);
+	const std::vector<std::size_t> receiveDisplacements = createDefaultDisplacements(receiveCounts);
+	std::vector<Type> result(sum(receiveCounts));
+	assert(toSend.size() >= sum(sendCounts));
+
+	const MPIcommunicatorHandle exchange = handle.privateDuplicate();
+	std::vector<MPI_Request> requests;
+	requests.reserve(2*size());
+	for(int i = 0; i < size(); ++i) {
+		if(receiveCounts[i] == 0) continue;
+		requests.push_back(MPI_REQUEST_NULL);
+		handleError(LargeCount::asyncReceive(result.data()+receiveDisplacements[i],receiveCounts[i],
+			mpi_datatype<Type>::get(),i,tag,exchange.get(),&requests.back()));
+	}
+	for(int i = 0; i < size(); ++i) {
+		if(sendCounts[i] == 0) continue;
+		requests.push_back(MPI_REQUEST_NULL);
+		handleError(LargeCount::asyncSend(toSend.data()+sendDisplacements[i],sendCounts[i],
+			mpi_datatype<Type>::get(),i,tag,exchange.get(),&requests.back()));
+	}
+	handleError(MPI_Waitall(static_cast<int>(requests.size()),requests.data(),MPI_STATUSES_IGNORE));
 	return result;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value and !is_std_array<Type>::value,bool>::type>
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<Type>::value and !is_std_array<Type>::value,bool>::type
+>
 inline void Communicator::send(Type data, int destination, int tag) {
-	handleError(MPI_Send(&data,sizeof(Type),MPI_UNSIGNED_CHAR,destination,tag,handle.get() ));
+	NICEMPI_PROFILE(data);
+	handleError(MPI_Send(&data,1,mpi_datatype<Type>::get(),destination,tag,handle.get() ));
 }
 
 template<class Collection,
-	typename std::enable_if<std::is_pod<typename Collection::value_type>::value,bool>::type
+	typename std::enable_if<is_trivially_communicable<typename Collection::value_type>::value,bool>::type
 >
 inline void Communicator::send(const Collection& data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
 	using Type = typename Collection::value_type;
-	handleError(MPI_Send(data.data(),sizeof(Type)*data.size(),MPI_UNSIGNED_CHAR,destination,tag,handle.get() ));
+	handleError(LargeCount::send(data.data(),data.size(),mpi_datatype<Type>::get(),destination,tag,handle.get()));
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline void Communicator::send(StridedView<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	handleError(MPI_Send(data.data(),1,data.datatype(),destination,tag,handle.get()));
+}
+
+template<typename Type,
+	typename std::enable_if<is_trivially_communicable<typename std::remove_const<Type>::type>::value,bool>::type
+>
+inline void Communicator::send(DeviceSpan<Type> data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	using Value = typename std::remove_const<Type>::type;
+	const std::shared_ptr<DeviceBackend> backend = DeviceBackend::current();
+	backend->synchronize(data.stream());
+	if(backend->isMPIaware()) {
+		handleError(LargeCount::send(data.data(),data.size(),mpi_datatype<Value>::get(),destination,tag,
+			handle.get()));
+		return;
+	}
+	const std::size_t chunk = std::max<std::size_t>(1,backend->chunkBytes()/sizeof(Value));
+	const std::size_t chunks = std::max<std::size_t>(1,(data.size() + chunk - 1)/chunk);
+	const std::size_t capacity = std::min(chunk,data.size());
+	std::array<StagingBuffer<Value>,2> staging{{ StagingBuffer<Value>(capacity), StagingBuffer<Value>(capacity) }};
+	std::array<MPI_Request,2> requests{{ MPI_REQUEST_NULL, MPI_REQUEST_NULL }};
+	for(std::size_t i = 0; i < chunks; ++i) {
+		const std::size_t count = std::min(chunk,data.size() - i*chunk);
+		handleError(MPI_Wait(&requests[i%2],MPI_STATUS_IGNORE));
+		backend->copyToHost(staging[i%2].data(),data.data() + i*chunk,count*sizeof(Value),data.stream());
+		backend->synchronize(data.stream());
+		handleError(MPI_Isend(staging[i%2].data(),static_cast<int>(count),mpi_datatype<Value>::get(),destination,tag,
+			handle.get(),&requests[i%2]));
+	}
+	handleError(MPI_Waitall(2,requests.data(),MPI_STATUSES_IGNORE));
+}
+
+template<typename Type, typename std::enable_if<is_serialized<Type>::value,bool>::type>
+inline void Communicator::send(const Type& data, int destination, int tag) {
+	NICEMPI_PROFILE(data);
+	std::vector<unsigned char>& buffer = serializationBuffer();
+	serialize(data,buffer);
+	handleError(LargeCount::send(buffer.data(),buffer.size(),MPI_BYTE,destination,tag,handle.get()));
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type>
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
 inline std::vector<Type> Communicator::varyingAllGather(const std::vector<Type>& data,
 	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
 {
+	NICEMPI_PROFILE(data);
 	std::vector<Type> result(sum(receiveCounts));
-	std::vector<int> scaledReceiveCounts(receiveCounts);
-	for(auto&& x: scaledReceiveCounts) x *= sizeof(Type);
-	const std::vector<int> scaledDisplacements = displacements.empty() ?
-		createDefaultDisplacements(scaledReceiveCounts) :
-		createScaledDisplacements<Type>(displacements);
-
-	handleError(MPI_Allgatherv(data.data(), data.size()*sizeof(Type), MPI_UNSIGNED_CHAR, result.data(),
-		scaledReceiveCounts.data(), scaledDisplacements.data(), MPI_UNSIGNED_CHAR, handle.get() ));
+	varyingAllGather(data,makeSpan(result),receiveCounts,displacements);
 	return result;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type>
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::varyingAllGather(const std::vector<Type>& data, Span<Type> result,
+	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(data);
+	const std::vector<std::size_t> actualDisplacements = displacements.empty() ?
+		createDefaultDisplacements(receiveCounts) : toLargeDisplacements(displacements);
+
+	handleError(LargeCount::varyingAllGather(data.data(), data.size(), result.data(), receiveCounts,
+		actualDisplacements, mpi_datatype<Type>::get(), handle.get() ));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::varyingAllToAll(const std::vector<Type>& toSend,
+	const std::vector<int>& sendCounts)
+{
+	NICEMPI_PROFILE(toSend);
+	const std::vector<int> receiveCounts = exchangeCounts(sendCounts);
+	return varyingAllToAll(toSend,sendCounts,receiveCounts);
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline std::vector<Type> Communicator::varyingAllToAll(const std::vector<Type>& toSend,
+	const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts,
+	const std::vector<int>& sendDisplacements, const std::vector<int>& receiveDisplacements)
+{
+	NICEMPI_PROFILE(toSend);
+	std::vector<Type> result(sum(receiveCounts));
+	varyingAllToAll(toSend,makeSpan(result),sendCounts,receiveCounts,sendDisplacements,receiveDisplacements);
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::varyingAllToAll(const std::vector<Type>& toSend, Span<Type> result,
+	const std::vector<int>& sendCounts, const std::vector<int>& receiveCounts,
+	const std::vector<int>& sendDisplacements, const std::vector<int>& receiveDisplacements)
+{
+	NICEMPI_PROFILE(toSend);
+	assert(static_cast<int>(sendCounts.size()) >= size());
+	assert(static_cast<int>(receiveCounts.size()) >= size());
+	const std::vector<std::size_t> actualSendDisplacements = sendDisplacements.empty() ?
+		createDefaultDisplacements(sendCounts) : toLargeDisplacements(sendDisplacements);
+	const std::vector<std::size_t> actualReceiveDisplacements = receiveDisplacements.empty() ?
+		createDefaultDisplacements(receiveCounts) : toLargeDisplacements(receiveDisplacements);
+	handleError(LargeCount::varyingAllToAll(toSend.data(), sendCounts, actualSendDisplacements, result.data(),
+		receiveCounts, actualReceiveDisplacements, mpi_datatype<Type>::get(), handle.get() ));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
 inline std::vector<Type> Communicator::varyingGather(int source, const std::vector<Type>& data,
 	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
 {
+	NICEMPI_PROFILE(data);
 	std::vector<Type> result;
-	std::vector<int> scaledReceiveCounts;
-	std::vector<int> scaledDisplacements;
-	if(rank() == source) {
-		result.resize(sum(receiveCounts));
-		scaledReceiveCounts = receiveCounts;
-		for(auto&& x: scaledReceiveCounts) x *= sizeof(Type);
-		if(displacements.empty()) scaledDisplacements = createDefaultDisplacements(scaledReceiveCounts);
-		else scaledDisplacements = createScaledDisplacements<Type>(displacements);
-	}
-	handleError(MPI_Gatherv(data.data(), data.size()*sizeof(Type), MPI_UNSIGNED_CHAR, result.data(),
-		scaledReceiveCounts.data(), scaledDisplacements.data(), MPI_UNSIGNED_CHAR, source, handle.get() ));
+	if(rank() == source) result.resize(sum(receiveCounts));
+	varyingGather(source,data,makeSpan(result),receiveCounts,displacements);
 	return result;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type>
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::varyingGather(int source, const std::vector<Type>& data, Span<Type> result,
+	const std::vector<int>& receiveCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(data);
+	if(displacements.empty()) {
+		handleError(LargeCount::varyingGather(data.data(), data.size(), result.data(), receiveCounts,
+			mpi_datatype<Type>::get(), source, handle.get() ));
+		return;
+	}
+	std::vector<std::size_t> actualDisplacements;
+	if(rank() == source) actualDisplacements = toLargeDisplacements(displacements);
+	handleError(LargeCount::varyingGather(data.data(), data.size(), result.data(), receiveCounts,
+		actualDisplacements, mpi_datatype<Type>::get(), source, handle.get() ));
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
 inline std::vector<Type> Communicator::varyingScatter(int source, const std::vector<Type>& toSend,
 	const std::vector<int>& sendCounts, const std::vector<int>& displacements)
 {
+	NICEMPI_PROFILE(toSend);
+	assert(static_cast<int>(sendCounts.size()) >= size());
+	std::vector<Type> result(sendCounts[rank()]);
+	varyingScatter(source,toSend,makeSpan(result),sendCounts,displacements);
+	return result;
+}
+
+template<typename Type, typename std::enable_if<is_trivially_communicable<Type>::value,bool>::type>
+inline void Communicator::varyingScatter(int source, const std::vector<Type>& toSend, Span<Type> result,
+	const std::vector<int>& sendCounts, const std::vector<int>& displacements)
+{
+	NICEMPI_PROFILE(toSend);
 	const auto enoughDataToSend = [&] () {
 		decltype(toSend.size()) sumOfSendCounts = 0;
 		for(auto&& x: sendCounts) {
@@ -235,58 +1436,84 @@ inline std::vector<Type> Communicator::varyingScatter(int source, const std::vec
 	assert(rank() != source or enoughDataToSend()); UNUSED(enoughDataToSend);
 	assert(static_cast<int>(sendCounts.size()) >= size());
 
-	std::vector<int> scaledSendCounts(sendCounts);
-	for(auto&& x: scaledSendCounts) x *= sizeof(Type);
-	const std::vector<int> scaledDisplacements = displacements.empty() ?
-		createDefaultDisplacements(scaledSendCounts) :
-		createScaledDisplacements<Type>(displacements);
-	return varyingScatterImpl(source,toSend,sendCounts,scaledSendCounts,scaledDisplacements);
+	if(displacements.empty()) {
+		handleError(LargeCount::varyingScatter(toSend.data(), sendCounts, result.data(), result.size(),
+			mpi_datatype<Type>::get(), source, handle.get() ));
+		return;
+	}
+	handleError(LargeCount::varyingScatter(toSend.data(), sendCounts, toLargeDisplacements(displacements),
+		result.data(), result.size(), mpi_datatype<Type>::get(), source, handle.get() ));
 }
 
 
 inline Communicator::Communicator(MPI_Comm* mpiCommunicatorRhs): handle(mpiCommunicatorRhs)
 {}
 
-inline std::vector<int> Communicator::createDefaultDisplacements(const std::vector<int>& sendCounts) {
-	std::vector<int> displacements(sendCounts.size());
-	for(unsigned i = 1; i<sendCounts.size(); ++i) displacements[i] = displacements[i-1] + sendCounts[i-1];
-	return displacements;
+inline Communicator::Communicator(MPIcommunicatorHandle&& handle): handle(std::move(handle))
+{}
+
+inline std::array<int,2> Communicator::countNeighbors() const {
+	if(topology() == MPI_CART) {
+		int dimensionCount = 0;
+		handleError(MPI_Cartdim_get(handle.get(),&dimensionCount));
+		return {{2*dimensionCount, 2*dimensionCount}};
+	}
+	int sourceCount = 0, destinationCount = 0, weighted = 0;
+	handleError(MPI_Dist_graph_neighbors_count(handle.get(),&sourceCount,&destinationCount,&weighted));
+	return {{sourceCount, destinationCount}};
 }
 
-template<typename Type>
-inline std::vector<int> Communicator::createScaledDisplacements(std::vector<int> displacements) {
-	for(auto&& x: displacements) x *= sizeof(Type);
+inline std::vector<std::size_t> Communicator::createDefaultDisplacements(const std::vector<int>& sendCounts) {
+	std::vector<std::size_t> displacements(sendCounts.size());
+	for(unsigned i = 1; i<sendCounts.size(); ++i) displacements[i] = displacements[i-1] + sendCounts[i-1];
 	return displacements;
 }
 
-template<typename Type>
-inline std::vector<Type> Communicator::initializeWithCount(std::vector<Type>, int count) {
-	return std::vector<Type>(count);
+template<typename Type, class Allocator>
+inline std::vector<Type,Allocator> Communicator::initializeWithCount(std::vector<Type,Allocator>, std::size_t count) {
+	return std::vector<Type,Allocator>(count);
 }
 template<typename Type, std::size_t N>
-inline std::array<Type,N> Communicator::initializeWithCount(std::array<Type,N> a, int /*count*/) {
+inline std::array<Type,N> Communicator::initializeWithCount(std::array<Type,N> a, std::size_t /*count*/) {
 	return a;
 }
 
-inline int Communicator::sum(const std::vector<int>& data) {
-	int theSum = 0;
+inline std::shared_ptr<void> Communicator::keepAlive(std::shared_ptr<void> a, std::shared_ptr<void> b) {
+	using Both = std::array<std::shared_ptr<void>,2>;
+	return std::make_shared<Both>(Both{{ std::move(a), std::move(b) }});
+}
+
+template<class Type>
+inline std::shared_ptr<std::vector<Type>> Communicator::ownedData(std::vector<Type>&& data) {
+	return std::make_shared<std::vector<Type>>(std::move(data));
+}
+template<class Collection>
+inline std::shared_ptr<std::vector<typename Collection::value_type>> Communicator::ownedData(
+	const Collection& data)
+{
+	return std::make_shared<std::vector<typename Collection::value_type>>(data.begin(),data.end());
+}
+
+inline std::size_t Communicator::sum(const std::vector<int>& data) {
+	std::size_t theSum = 0;
 	for(auto&& x: data) theSum += x;
 	return theSum;
 }
 
-template<typename Type, typename std::enable_if<std::is_pod<Type>::value,bool>::type>
-inline std::vector<Type> Communicator::varyingScatterImpl(int source, const std::vector<Type>& toSend,
-	const std::vector<int>& sendCounts, const std::vector<int>& scaledSendCounts,
-	const std::vector<int>& displacements)
-{
-	std::vector<Type> result(sendCounts[rank()]);
-	handleError(MPI_Scatterv(toSend.data(), scaledSendCounts.data(), displacements.data(), MPI_UNSIGNED_CHAR, 
-		result.data(), scaledSendCounts[rank()], MPI_UNSIGNED_CHAR, source, handle.get() ));
-	return result;
+inline std::vector<std::size_t> Communicator::toLargeDisplacements(const std::vector<int>& displacements) {
+	return std::vector<std::size_t>(displacements.begin(),displacements.end());
 }
 
 
 
+inline Communicator CommunicatorRequest::take() {
+	wait();
+	const MPI_Comm taken = mpiCommunicator;
+	mpiCommunicator = MPI_COMM_NULL;
+	assert(taken != MPI_COMM_NULL);
+	return Communicator{MPIcommunicatorHandle::adopt(taken)};
+}
+
 inline bool areCongruent(const Communicator& a, const Communicator& b) {
 	int result;
 	MPI_Comm_compare(a.get(), b.get(), &result);
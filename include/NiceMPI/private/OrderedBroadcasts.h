@@ -0,0 +1,59 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#ifndef ORDEREDBROADCASTS_H
+#define ORDEREDBROADCASTS_H
+
+#include <cstddef> // std::size_t
+#include <functional> // std::function
+#include <memory> // std::shared_ptr
+#include <mpi.h> // MPI_Comm, MPI_Request
+#include "MPIcommunicatorHandle.h"
+
+namespace NiceMPI {
+
+/** \brief Orders the data steps of the broadcasts of collections, whose size is only known when the first step
+  completes. The size is broadcast on the communicator when the broadcast is created, like any other collective,
+  and the data are broadcast on the private duplicate of the communicator, MPIcommunicatorHandle::privateDuplicate.
+  The data steps are started in the order of creation, whenever a process tests or waits for any of them, so that the
+  order of the collectives is the same on every process, and other collectives can be started on the communicator
+  in the meantime. Thread-safe. */
+class OrderedBroadcasts {
+public:
+	/** \brief Function that starts the broadcast of the \p count data on the private \p communicator, in
+  \p request. */
+	using DataStep = std::function<void(std::size_t count, MPI_Comm communicator, MPI_Request& request)>;
+	/** \brief Broadcast whose data step is not taken yet. */
+	struct Broadcast;
+
+	/** \brief Starts to broadcast the \p count of the \p source on the \p communicator, and queues the data step.
+  Collective. */
+	static std::shared_ptr<Broadcast> add(const MPIcommunicatorHandle& communicator, std::size_t count, int source,
+		DataStep step);
+	/** \brief Starts the data steps queued up to the \p broadcast, in order, as long as their count is received,
+  without blocking. Returns true if the data step of the \p broadcast is started, in which case it is moved in
+  \p request. */
+	static bool start(const std::shared_ptr<Broadcast>& broadcast, MPI_Request& request);
+};
+
+} // NiceMPi
+
+#endif  /* ORDEREDBROADCASTS_H */
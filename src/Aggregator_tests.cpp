@@ -0,0 +1,103 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <chrono>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/Aggregator.h>
+
+using namespace NiceMPI;
+
+class AggregatorTests : public ::testing::Test {
+public:
+	const int rank = mpiWorld().rank();
+	const int size = mpiWorld().size();
+	const std::chrono::microseconds never = std::chrono::hours{1};
+};
+
+
+TEST_F(AggregatorTests, everyMessageIsHandled) {
+	const int count = 1000;
+	std::vector<int> handled(static_cast<std::size_t>(size),0);
+	long long sum = 0;
+	Aggregator<int> aggregator(mpiWorld(),[&](int source, const int& data) {
+		++handled[static_cast<std::size_t>(source)];
+		sum += data;
+	},64);
+	for(int i = 0; i < count; ++i) {
+		for(int destination = 0; destination < size; ++destination) aggregator.send(i,destination);
+	}
+	aggregator.drain();
+	for(auto&& x: handled) EXPECT_EQ(count,x);
+	EXPECT_EQ(static_cast<long long>(size)*count*(count-1)/2,sum);
+	EXPECT_EQ(static_cast<unsigned long long>(count*size),aggregator.sentCount());
+	EXPECT_EQ(static_cast<unsigned long long>(count*size),aggregator.receivedCount());
+}
+TEST_F(AggregatorTests, messagesSentByHandlersAreDrained) {
+	const int hops = 50;
+	int last = -1;
+	Aggregator<int>* self = nullptr;
+	Aggregator<int> aggregator(mpiWorld(),[&](int, const int& data) {
+		if(data == 0) last = rank;
+		else self->send(data-1,(rank+1)%size);
+	},1024,never);
+	self = &aggregator;
+	if(rank == 0) aggregator.send(hops,0);
+	aggregator.drain();
+	Communicator world = mpiWorld();
+	EXPECT_EQ(hops%size,world.allReduce(last,Maximum<int>{}));
+}
+TEST_F(AggregatorTests, fullBufferIsSent) {
+	Aggregator<int> aggregator(mpiWorld(),[](int, const int&) {},4*sizeof(int),never);
+	for(int i = 0; i < 3; ++i) aggregator.send(i,rank);
+	EXPECT_EQ(0u,aggregator.sentCount());
+	aggregator.send(3,rank);
+	EXPECT_EQ(4u,aggregator.sentCount());
+	aggregator.drain();
+	EXPECT_EQ(4u,aggregator.receivedCount());
+}
+TEST_F(AggregatorTests, lateBufferIsSent) {
+	Aggregator<int> aggregator(mpiWorld(),[](int, const int&) {},1024,std::chrono::microseconds{0});
+	aggregator.send(0,rank);
+	aggregator.send(1,rank);
+	EXPECT_EQ(2u,aggregator.sentCount());
+	aggregator.drain();
+	EXPECT_EQ(2u,aggregator.receivedCount());
+}
+TEST_F(AggregatorTests, flushSendsEveryBuffer) {
+	Aggregator<int> aggregator(mpiWorld(),[](int, const int&) {},1024,never);
+	for(int destination = 0; destination < size; ++destination) aggregator.send(destination,destination);
+	EXPECT_EQ(0u,aggregator.sentCount());
+	aggregator.flush();
+	EXPECT_EQ(static_cast<unsigned long long>(size),aggregator.sentCount());
+	aggregator.drain();
+	EXPECT_EQ(static_cast<unsigned long long>(size),aggregator.receivedCount());
+}
+TEST_F(AggregatorTests, pollReturnsTheMessagesHandled) {
+	Aggregator<int> aggregator(mpiWorld(),[](int, const int&) {},1024,never);
+	aggregator.send(1,rank);
+	aggregator.send(2,rank);
+	aggregator.flush();
+	std::size_t handled = 0;
+	while(handled < 2) handled += aggregator.poll();
+	EXPECT_EQ(2u,handled);
+	aggregator.drain();
+}
@@ -0,0 +1,106 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <cstddef> // std::size_t
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/CollectivePlans.h>
+
+using namespace NiceMPI;
+
+class CollectivePlansTests : public ::testing::Test {
+public:
+	/** \brief Returns rank+1 as the count of every process. */
+	std::vector<int> rankCounts() const {
+		std::vector<int> counts(static_cast<std::size_t>(size));
+		for(int i = 0; i < size; ++i) counts[static_cast<std::size_t>(i)] = i+1;
+		return counts;
+	}
+
+	const int rank = mpiWorld().rank();
+	const int size = mpiWorld().size();
+	const int source = size-1;
+};
+
+
+TEST_F(CollectivePlansTests, allGatherPlanCanBeRunManyTimes) {
+	VaryingAllGatherPlan<int> plan(mpiWorld(),rankCounts());
+	ASSERT_EQ(static_cast<std::size_t>(rank+1),plan.toSend().size());
+	ASSERT_EQ(static_cast<std::size_t>(size*(size+1)/2),plan.result().size());
+	for(int step = 0; step < 3; ++step) {
+		for(auto&& x: plan.toSend()) x = 10*rank + step;
+		plan.run();
+		std::size_t index = 0;
+		for(int i = 0; i < size; ++i) {
+			for(int j = 0; j <= i; ++j) EXPECT_EQ(10*i + step,plan.result()[index++]);
+		}
+	}
+}
+TEST_F(CollectivePlansTests, allGatherPlanUsesTheDisplacements) {
+	std::vector<int> displacements(static_cast<std::size_t>(size));
+	for(int i = 0; i < size; ++i) displacements[static_cast<std::size_t>(i)] = 2*(size-1-i);
+	VaryingAllGatherPlan<double> plan(mpiWorld(),std::vector<int>(static_cast<std::size_t>(size),1),
+		displacements);
+	ASSERT_EQ(static_cast<std::size_t>(2*size-1),plan.result().size());
+	plan.toSend()[0] = rank + 0.5;
+	plan.run();
+	for(int i = 0; i < size; ++i) EXPECT_EQ(i + 0.5,plan.result()[static_cast<std::size_t>(2*(size-1-i))]);
+}
+TEST_F(CollectivePlansTests, gatherPlanReceivesOnTheSourceOnly) {
+	VaryingGatherPlan<int> plan(mpiWorld(),source,rankCounts());
+	for(int step = 0; step < 2; ++step) {
+		for(auto&& x: plan.toSend()) x = rank - step;
+		plan.run();
+		if(rank != source) {
+			EXPECT_EQ(0u,plan.result().size());
+			continue;
+		}
+		std::size_t index = 0;
+		for(int i = 0; i < size; ++i) {
+			for(int j = 0; j <= i; ++j) EXPECT_EQ(i - step,plan.result()[index++]);
+		}
+		EXPECT_EQ(plan.result().size(),index);
+	}
+}
+TEST_F(CollectivePlansTests, scatterPlanSendsFromTheSource) {
+	VaryingScatterPlan<int> plan(mpiWorld(),source,rankCounts());
+	EXPECT_EQ(rank == source ? static_cast<std::size_t>(size*(size+1)/2) : 0u,plan.toSend().size());
+	for(int step = 0; step < 2; ++step) {
+		std::size_t index = 0;
+		if(rank == source) {
+			for(int i = 0; i < size; ++i) {
+				for(int j = 0; j <= i; ++j) plan.toSend()[index++] = 100*i + j + step;
+			}
+		}
+		plan.run();
+		ASSERT_EQ(static_cast<std::size_t>(rank+1),plan.result().size());
+		for(int j = 0; j <= rank; ++j) EXPECT_EQ(100*rank + j + step,plan.result()[static_cast<std::size_t>(j)]);
+	}
+}
+TEST_F(CollectivePlansTests, planCanBeStartedAndWaited) {
+	VaryingAllGatherPlan<int> plan(mpiWorld(),rankCounts());
+	EXPECT_TRUE(plan.isCompleted());
+	for(auto&& x: plan.toSend()) x = rank;
+	plan.start();
+	while(!plan.isCompleted()) {}
+	plan.wait();
+	EXPECT_EQ(size-1,plan.result()[plan.result().size()-1]);
+}
@@ -0,0 +1,84 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/CommunicatorLanes.h>
+
+using namespace NiceMPI;
+
+class CommunicatorLanesTests : public ::testing::Test {
+public:
+	bool isThreadMultiple() const {
+		int provided;
+		MPI_Query_thread(&provided);
+		return provided == MPI_THREAD_MULTIPLE;
+	}
+
+	const int sourceIndex = 0;
+	const int destinationIndex = mpiWorld().size() - 1;
+};
+
+
+TEST_F(CommunicatorLanesTests, lanesAreCongruent) {
+	CommunicatorLanes lanes(mpiWorld(),3);
+	ASSERT_EQ(3,lanes.size());
+	for(int i = 0; i < lanes.size(); ++i) {
+		EXPECT_TRUE( areCongruent(mpiWorld(),lanes[i]) );
+		EXPECT_FALSE( areIdentical(mpiWorld(),lanes[i]) );
+	}
+}
+TEST_F(CommunicatorLanesTests, noLane) {
+	const CommunicatorLanes lanes(mpiWorld(),0);
+	EXPECT_EQ(0,lanes.size());
+}
+TEST_F(CommunicatorLanesTests, lanesAreIsolated) {
+	CommunicatorLanes lanes(mpiWorld(),2);
+	if(mpiWorld().rank() == sourceIndex) {
+		SendRequest first = lanes[0].asyncSend(0,destinationIndex);
+		SendRequest second = lanes[1].asyncSend(1,destinationIndex);
+		first.wait();
+		second.wait();
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(1,lanes[1].receive<int>(sourceIndex));
+		EXPECT_EQ(0,lanes[0].receive<int>(sourceIndex));
+	}
+}
+TEST_F(CommunicatorLanesTests, threadsCommunicateConcurrently) {
+	if(!isThreadMultiple()) return;
+	const int threadCount = 2;
+	const int iterations = 20;
+	CommunicatorLanes lanes(mpiWorld(),threadCount);
+	std::vector<int> sums(threadCount);
+	std::vector<std::thread> threads;
+	for(int t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&lanes,&sums,t,iterations] () {
+			for(int i = 0; i < iterations; ++i) sums[t] += lanes[t].allReduce(t + i);
+		});
+	}
+	for(auto&& x: threads) x.join();
+	for(int t = 0; t < threadCount; ++t) {
+		EXPECT_EQ(mpiWorld().size()*(iterations*t + iterations*(iterations-1)/2),sums[t]);
+	}
+}
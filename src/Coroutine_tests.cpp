@@ -0,0 +1,138 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <coroutine> // std::coroutine_handle, std::suspend_always, std::suspend_never
+#include <deque>
+#include <exception> // std::exception_ptr
+#include <functional> // std::function
+#include <utility> // std::move
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/Coroutine.h>
+
+using namespace NiceMPI;
+
+/** \brief Coroutine started eagerly, and destroyed with this object. */
+struct Task {
+	struct promise_type {
+		Task get_return_object() {
+			return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+		}
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { error = std::current_exception(); }
+
+		std::exception_ptr error;
+	};
+
+	explicit Task(std::coroutine_handle<promise_type> handle): handle(handle) {}
+	~Task() {
+		if(handle) handle.destroy();
+	}
+	Task(const Task&) = delete;
+	Task(Task&& rhs): handle(rhs.handle) {
+		rhs.handle = nullptr;
+	}
+	bool isDone() const {
+		return handle.done();
+	}
+	bool hasFailed() const {
+		return handle.promise().error != nullptr;
+	}
+
+	std::coroutine_handle<promise_type> handle;
+};
+
+class CoroutineTests : public ::testing::Test {
+public:
+	void TearDown() override {
+		EXPECT_EQ(0,ProgressEngine::pendingCount());
+	}
+
+	void pollUntilDone(const Task& task) {
+		while(!task.isDone()) ProgressEngine::poll();
+	}
+
+	Communicator isolated; // The requests of the other tests must not be matched
+	const int self = isolated.rank();
+};
+
+
+TEST_F(CoroutineTests, receiveIsAwaited) {
+	int received = 0;
+	Task task = [](Communicator& communicator, int source, int& result) -> Task {
+		result = (co_await communicator.asyncReceive<int>(source)).at(0);
+	}(isolated,self,received);
+	EXPECT_FALSE(task.isDone());
+	isolated.send(42,self);
+	pollUntilDone(task);
+	EXPECT_FALSE(task.hasFailed());
+	EXPECT_EQ(42,received);
+}
+TEST_F(CoroutineTests, sendIsAwaited) {
+	Task task = [](Communicator& communicator, std::vector<int> toSend, int destination) -> Task {
+		co_await communicator.asyncSend(std::move(toSend),destination);
+	}(isolated,std::vector<int>{1,2,3},self);
+	EXPECT_EQ((std::vector<int>{1,2,3}),isolated.receive<std::vector<int>>(3,self));
+	pollUntilDone(task);
+	EXPECT_FALSE(task.hasFailed());
+}
+TEST_F(CoroutineTests, allReduceIsAwaited) {
+	int sum = 0;
+	Task task = [](Communicator& communicator, int& result) -> Task {
+		result = (co_await communicator.asyncAllReduce(1)).at(0);
+	}(isolated,sum);
+	pollUntilDone(task);
+	EXPECT_FALSE(task.hasFailed());
+	EXPECT_EQ(isolated.size(),sum);
+}
+TEST_F(CoroutineTests, manyExchangesInFlight) {
+	const int count = 100;
+	std::vector<int> received(count);
+	std::vector<Task> tasks;
+	for(int i = 0; i < count; ++i) {
+		tasks.push_back([](Communicator& communicator, int source, int tag, int& result) -> Task {
+			result = (co_await communicator.asyncReceive<int>(source,tag)).at(0);
+		}(isolated,self,i,received[i]));
+	}
+	for(int i = 0; i < count; ++i) isolated.send(i,self,i);
+	for(const Task& task: tasks) pollUntilDone(task);
+	for(int i = 0; i < count; ++i) {
+		EXPECT_EQ(i,received[i]);
+	}
+}
+TEST_F(CoroutineTests, executorResumesCoroutine) {
+	std::deque<std::function<void()>> queue;
+	const Executor executor = [&queue](std::function<void()> resume) { queue.push_back(std::move(resume)); };
+	int received = 0;
+	Task task = [](Communicator& communicator, int source, Executor executor, int& result) -> Task {
+		result = (co_await resumeOn(communicator.asyncReceive<int>(source),executor)).at(0);
+	}(isolated,self,executor,received);
+	isolated.send(42,self);
+	while(queue.empty()) ProgressEngine::poll();
+	EXPECT_FALSE(task.isDone());
+	queue.front()();
+	queue.pop_front();
+	EXPECT_TRUE(task.isDone());
+	EXPECT_EQ(42,received);
+}
@@ -0,0 +1,53 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <algorithm> // std::equal
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/DefaultInitAllocator.h>
+
+using namespace NiceMPI;
+
+namespace {
+struct WithInitializer {
+	int value = 7;
+};
+}
+
+TEST(DefaultInitAllocatorTests, defaultConstructorsAreCalled) {
+	UninitializedVector<WithInitializer> data(3);
+	for(auto&& x: data) EXPECT_EQ(7,x.value);
+}
+TEST(DefaultInitAllocatorTests, constructsFromArguments) {
+	UninitializedVector<int> data(3,5);
+	data.push_back(6);
+	const std::vector<int> expected = { 5, 5, 5, 6 };
+	EXPECT_TRUE(std::equal(expected.begin(),expected.end(),data.begin()));
+	EXPECT_EQ(expected.size(),data.size());
+}
+TEST(DefaultInitAllocatorTests, copiesAndRebinds) {
+	const DefaultInitAllocator<int> a;
+	const DefaultInitAllocator<double> b(a);
+	std::vector<double,DefaultInitAllocator<double>> data(2,1.5,b);
+	UninitializedVector<double> copy = data;
+	EXPECT_EQ(1.5,copy.at(1));
+}
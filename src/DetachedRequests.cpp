@@ -0,0 +1,123 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <NiceMPI/private/DetachedRequests.h>
+#include <cassert>
+#include <mutex> // std::mutex, std::lock_guard
+#include <utility> // std::move
+#include <vector>
+
+namespace NiceMPI {
+
+namespace {
+
+/** \brief Requests detached and not completed yet, with the data they depend on. */
+struct Detached {
+	/** \brief MPI implementations of the requests. Contiguous, as required by MPI_Testsome and MPI_Waitall. */
+	std::vector<MPI_Request> requests;
+	/** \brief Data that must stay alive until the request of the same index completes. */
+	std::vector<std::shared_ptr<void>> payloads;
+	/** \brief True if the request of the same index can be cancelled. */
+	std::vector<bool> cancellable;
+	/** \brief Requests can be destroyed by many threads at the same time. */
+	std::mutex mutex;
+};
+
+/** \brief Returns the unique instance of Detached. */
+Detached& detached() {
+	static Detached instance;
+	return instance;
+}
+
+/** \brief Returns true if MPI can still be called. */
+bool isMPIactive() {
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	return finalized == 0;
+}
+
+/** \brief Removes the completed requests of \p x, and frees their payload. */
+void removeCompleted(Detached& x) {
+	std::size_t kept = 0;
+	for(std::size_t i = 0; i < x.requests.size(); ++i) {
+		if(x.requests[i] == MPI_REQUEST_NULL) continue;
+		x.requests[kept] = x.requests[i];
+		x.payloads[kept] = std::move(x.payloads[i]);
+		x.cancellable[kept] = x.cancellable[i];
+		++kept;
+	}
+	x.requests.resize(kept);
+	x.payloads.resize(kept);
+	x.cancellable.resize(kept);
+}
+
+/** \brief Frees the payloads of the completed requests of \p x, without blocking. \p x must be locked. */
+void reapLocked(Detached& x) {
+	if(x.requests.empty()) return;
+	int outcount = 0;
+	std::vector<int> indices(x.requests.size());
+	int error = MPI_Testsome(static_cast<int>(x.requests.size()),x.requests.data(),&outcount,indices.data(),
+		MPI_STATUSES_IGNORE);
+	((void)error); // Unused in release mode
+	assert(error == MPI_SUCCESS); // Called from destructors, can't throw
+	removeCompleted(x);
+}
+
+} // namespace
+
+void DetachedRequests::add(MPI_Request request, std::shared_ptr<void> payload, bool cancellable) {
+	if(request == MPI_REQUEST_NULL or !isMPIactive()) return;
+	Detached& x = detached();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	reapLocked(x);
+	x.requests.push_back(request);
+	x.payloads.push_back(std::move(payload));
+	x.cancellable.push_back(cancellable);
+}
+
+void DetachedRequests::completeAll() {
+	if(!isMPIactive()) return;
+	Detached& x = detached();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	for(std::size_t i = 0; i < x.requests.size(); ++i) {
+		if(x.cancellable[i]) MPI_Cancel(&x.requests[i]);
+	}
+	int error = MPI_Waitall(static_cast<int>(x.requests.size()),x.requests.data(),MPI_STATUSES_IGNORE);
+	((void)error); // Unused in release mode
+	assert(error == MPI_SUCCESS); // Called from destructors, can't throw
+	removeCompleted(x);
+}
+
+std::size_t DetachedRequests::pendingCount() {
+	Detached& x = detached();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	return x.requests.size();
+}
+
+void DetachedRequests::reap() {
+	if(!isMPIactive()) return;
+	Detached& x = detached();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	reapLocked(x);
+}
+
+} // NiceMPi
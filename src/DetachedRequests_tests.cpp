@@ -0,0 +1,69 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <memory> // std::make_shared
+#include <gtest/gtest.h>
+#include <NiceMPI/private/DetachedRequests.h>
+
+using namespace NiceMPI;
+
+class DetachedRequestsTests : public ::testing::Test {
+public:
+	void SetUp() override {
+		DetachedRequests::completeAll();
+	}
+	void TearDown() override {
+		DetachedRequests::completeAll();
+	}
+
+	const int tag = 11;
+};
+
+
+TEST_F(DetachedRequestsTests, nullRequestIsIgnored) {
+	DetachedRequests::add(MPI_REQUEST_NULL,nullptr,false);
+	EXPECT_EQ(0,DetachedRequests::pendingCount());
+}
+TEST_F(DetachedRequestsTests, payloadIsKeptAliveUntilCompletion) {
+	const auto payload = std::make_shared<int>(0);
+	std::weak_ptr<int> observer = payload;
+	MPI_Request request;
+	MPI_Irecv(payload.get(),1,MPI_INT,0,tag,MPI_COMM_SELF,&request);
+	DetachedRequests::add(request,payload,true);
+	EXPECT_EQ(1,DetachedRequests::pendingCount());
+	EXPECT_EQ(2,observer.use_count());
+
+	const int toSend = 42;
+	MPI_Send(&toSend,1,MPI_INT,0,tag,MPI_COMM_SELF);
+	EXPECT_EQ(42,*payload);
+	DetachedRequests::reap();
+	EXPECT_EQ(0,DetachedRequests::pendingCount());
+	EXPECT_EQ(1,observer.use_count());
+}
+TEST_F(DetachedRequestsTests, completeAllCancelsReceives) {
+	int buffer = 0;
+	MPI_Request request;
+	MPI_Irecv(&buffer,1,MPI_INT,0,tag,MPI_COMM_SELF,&request);
+	DetachedRequests::add(request,nullptr,true);
+	DetachedRequests::completeAll();
+	EXPECT_EQ(0,DetachedRequests::pendingCount());
+}
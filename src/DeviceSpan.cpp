@@ -0,0 +1,126 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <NiceMPI/DeviceSpan.h>
+#include <mutex> // std::mutex, std::lock_guard
+#include <utility> // std::move
+#if defined(NICEMPI_CUDA)
+	#include <cuda_runtime.h> // cudaMemcpyAsync, cudaStreamSynchronize
+	#include <mpi-ext.h> // MPIX_Query_cuda_support
+#elif defined(NICEMPI_HIP)
+	#include <hip/hip_runtime.h> // hipMemcpyAsync, hipStreamSynchronize
+	#include <mpi-ext.h> // MPIX_Query_rocm_support
+#endif
+
+namespace NiceMPI {
+
+namespace {
+
+#if defined(NICEMPI_CUDA)
+/** \brief Operations on the memory of a CUDA device. */
+class CudaBackend: public DeviceBackend {
+public:
+	bool isMPIaware() const override {
+	#if defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT
+		return MPIX_Query_cuda_support() == 1;
+	#else
+		return false;
+	#endif
+	}
+	void copyToHost(void* host, const void* device, std::size_t bytes, void* stream) override {
+		const auto error = cudaMemcpyAsync(host,device,bytes,cudaMemcpyDeviceToHost,static_cast<cudaStream_t>(stream));
+		if(error != cudaSuccess) handleError(MPI_ERR_OTHER);
+	}
+	void copyToDevice(void* device, const void* host, std::size_t bytes, void* stream) override {
+		const auto error = cudaMemcpyAsync(device,host,bytes,cudaMemcpyHostToDevice,static_cast<cudaStream_t>(stream));
+		if(error != cudaSuccess) handleError(MPI_ERR_OTHER);
+	}
+	void synchronize(void* stream) override {
+		if(cudaStreamSynchronize(static_cast<cudaStream_t>(stream)) != cudaSuccess) handleError(MPI_ERR_OTHER);
+	}
+};
+#elif defined(NICEMPI_HIP)
+/** \brief Operations on the memory of a HIP device. */
+class HipBackend: public DeviceBackend {
+public:
+	bool isMPIaware() const override {
+	#if defined(MPIX_ROCM_AWARE_SUPPORT) && MPIX_ROCM_AWARE_SUPPORT
+		return MPIX_Query_rocm_support() == 1;
+	#else
+		return false;
+	#endif
+	}
+	void copyToHost(void* host, const void* device, std::size_t bytes, void* stream) override {
+		const auto error = hipMemcpyAsync(host,device,bytes,hipMemcpyDeviceToHost,static_cast<hipStream_t>(stream));
+		if(error != hipSuccess) handleError(MPI_ERR_OTHER);
+	}
+	void copyToDevice(void* device, const void* host, std::size_t bytes, void* stream) override {
+		const auto error = hipMemcpyAsync(device,host,bytes,hipMemcpyHostToDevice,static_cast<hipStream_t>(stream));
+		if(error != hipSuccess) handleError(MPI_ERR_OTHER);
+	}
+	void synchronize(void* stream) override {
+		if(hipStreamSynchronize(static_cast<hipStream_t>(stream)) != hipSuccess) handleError(MPI_ERR_OTHER);
+	}
+};
+#endif
+
+/** \brief Returns the backend built in, if any. */
+std::shared_ptr<DeviceBackend> createDefault() {
+#if defined(NICEMPI_CUDA)
+	return std::make_shared<CudaBackend>();
+#elif defined(NICEMPI_HIP)
+	return std::make_shared<HipBackend>();
+#else
+	return nullptr;
+#endif
+}
+
+/** \brief Backend in use. */
+struct Selection {
+	/** \brief Backend used to communicate a DeviceSpan. */
+	std::shared_ptr<DeviceBackend> backend = createDefault();
+	/** \brief The backend can be set by many threads at the same time. */
+	std::mutex mutex;
+};
+
+/** \brief Returns the unique instance of Selection. */
+Selection& selection() {
+	static Selection instance;
+	return instance;
+}
+
+} // namespace
+
+std::shared_ptr<DeviceBackend> DeviceBackend::current() {
+	Selection& x = selection();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	if(!x.backend) handleError(MPI_ERR_OTHER);
+	return x.backend;
+}
+
+void DeviceBackend::set(std::shared_ptr<DeviceBackend> backend) {
+	Selection& x = selection();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	x.backend = std::move(backend);
+}
+
+} // NiceMPi
@@ -0,0 +1,171 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <cstring> // std::memcpy
+#include <memory> // std::make_shared
+#include <numeric> // std::iota
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/NiceMPI.h>
+
+using namespace NiceMPI;
+
+namespace {
+/** \brief Backend whose "device" is the host, to test the communications of DeviceSpan. */
+class HostBackend: public DeviceBackend {
+public:
+	HostBackend(bool aware, std::size_t chunk): aware(aware), chunk(chunk)
+	{}
+	bool isMPIaware() const override {
+		return aware;
+	}
+	void copyToHost(void* host, const void* device, std::size_t bytes, void*) override {
+		std::memcpy(host,device,bytes);
+		++copies;
+	}
+	void copyToDevice(void* device, const void* host, std::size_t bytes, void*) override {
+		std::memcpy(device,host,bytes);
+		++copies;
+	}
+	void synchronize(void*) override {
+	}
+	std::size_t chunkBytes() const override {
+		return chunk;
+	}
+
+	bool aware;
+	std::size_t chunk;
+	int copies = 0;
+};
+}
+
+class DeviceSpanCommunicationTests: public ::testing::TestWithParam<bool> {
+public:
+	DeviceSpanCommunicationTests()
+	: world(mpiWorld().duplicate()), backend(std::make_shared<HostBackend>(GetParam(),4*sizeof(int)))
+	{
+		DeviceBackend::set(backend);
+	}
+	~DeviceSpanCommunicationTests() {
+		DeviceBackend::set(nullptr);
+	}
+
+	int next() const {
+		return (world.rank() + 1) % world.size();
+	}
+	int previous() const {
+		return (world.rank() + world.size() - 1) % world.size();
+	}
+
+	/** \brief Isolates the messages of these tests. */
+	Communicator world;
+	std::shared_ptr<HostBackend> backend;
+};
+
+TEST(DeviceSpanTests, viewsTheDeviceMemory) {
+	std::vector<int> data(3);
+	int stream = 0;
+	const DeviceSpan<const int> view = makeDeviceSpan(data.data(),data.size(),&stream);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(3,view.size());
+	EXPECT_EQ(&stream,view.stream());
+}
+TEST(DeviceSpanTests, throwsWithoutBackend) {
+	std::vector<int> data(3);
+	EXPECT_THROW(mpiSelf().send(makeDeviceSpan(data.data(),data.size()),0),NiceMPIexception);
+}
+TEST_P(DeviceSpanCommunicationTests, sendAndReceiveInChunks) {
+	const int tag = 1;
+	std::vector<int> toSend(10), received(10);
+	std::iota(toSend.begin(),toSend.end(),world.rank());
+	if(world.rank() % 2 == 0) {
+		world.send(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+		world.receive(makeDeviceSpan(received.data(),received.size()),previous(),tag);
+	}
+	else {
+		world.receive(makeDeviceSpan(received.data(),received.size()),previous(),tag);
+		world.send(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+	}
+	std::vector<int> expected(10);
+	std::iota(expected.begin(),expected.end(),previous());
+	EXPECT_EQ(expected,received);
+	EXPECT_EQ(GetParam() ? 0 : 6,backend->copies);
+}
+TEST_P(DeviceSpanCommunicationTests, asyncSendAndReceive) {
+	const int tag = 3;
+	std::vector<double> toSend = { 1.5, 2.5, 3.5 }, received(3);
+	DeviceRequest receive = world.asyncReceive(makeDeviceSpan(received.data(),received.size()),previous(),tag);
+	DeviceRequest send = world.asyncSend(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+	send.wait();
+	receive.wait();
+	EXPECT_EQ(toSend,received);
+}
+TEST_P(DeviceSpanCommunicationTests, asyncSendToBlockingReceiveInChunks) {
+	const int tag = 5;
+	std::vector<int> toSend(10), received(10);
+	std::iota(toSend.begin(),toSend.end(),world.rank());
+	DeviceRequest send = world.asyncSend(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+	world.receive(makeDeviceSpan(received.data(),received.size()),previous(),tag);
+	send.wait();
+	std::vector<int> expected(10);
+	std::iota(expected.begin(),expected.end(),previous());
+	EXPECT_EQ(expected,received);
+	EXPECT_EQ(GetParam() ? 0 : 6,backend->copies);
+}
+TEST_P(DeviceSpanCommunicationTests, blockingSendToAsyncReceiveInChunks) {
+	const int tag = 6;
+	std::vector<int> toSend(10), received(10);
+	std::iota(toSend.begin(),toSend.end(),world.rank());
+	DeviceRequest receive = world.asyncReceive(makeDeviceSpan(received.data(),received.size()),previous(),tag);
+	world.send(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+	receive.wait();
+	std::vector<int> expected(10);
+	std::iota(expected.begin(),expected.end(),previous());
+	EXPECT_EQ(expected,received);
+	EXPECT_EQ(GetParam() ? 0 : 6,backend->copies);
+}
+TEST_P(DeviceSpanCommunicationTests, asyncReceiveFromAnySourceInChunks) {
+	const int tag = 7;
+	std::vector<int> toSend(10), received(10);
+	std::iota(toSend.begin(),toSend.end(),world.rank());
+	DeviceRequest receive = world.asyncReceive(makeDeviceSpan(received.data(),received.size()),MPI_ANY_SOURCE,tag);
+	world.send(makeDeviceSpan(toSend.data(),toSend.size()),next(),tag);
+	while(!receive.isCompleted()) {}
+	std::vector<int> expected(10);
+	std::iota(expected.begin(),expected.end(),previous());
+	EXPECT_EQ(expected,received);
+}
+TEST_P(DeviceSpanCommunicationTests, broadcast) {
+	std::vector<int> data(5);
+	if(world.rank() == 0) std::iota(data.begin(),data.end(),1);
+	world.broadcast(0,makeDeviceSpan(data.data(),data.size()));
+	const std::vector<int> expected = { 1, 2, 3, 4, 5 };
+	EXPECT_EQ(expected,data);
+}
+TEST_P(DeviceSpanCommunicationTests, emptySpan) {
+	const int tag = 4;
+	std::vector<int> toSend, received;
+	DeviceRequest send = world.asyncSend(makeDeviceSpan(toSend.data(),0),next(),tag);
+	world.receive(makeDeviceSpan(received.data(),0),previous(),tag);
+	send.wait();
+}
+INSTANTIATE_TEST_CASE_P(awareAndStaged, DeviceSpanCommunicationTests, ::testing::Values(true,false));
@@ -0,0 +1,133 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/File.h>
+
+using namespace NiceMPI;
+
+class FileTests : public ::testing::Test {
+public:
+	/** \brief Opens an empty file for the current test, deleted when it is closed. */
+	File open() {
+		const std::string name = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+		File file(world,"NiceMPI_FileTests_" + name + ".bin",
+			MPI_MODE_CREATE | MPI_MODE_RDWR | MPI_MODE_DELETE_ON_CLOSE);
+		file.resize(0);
+		return file;
+	}
+	/** \brief Makes the data written by every process visible to the others. */
+	void synchronize(File& file) {
+		file.sync();
+		handleError(MPI_Barrier(world.get()));
+		file.sync();
+	}
+
+	Communicator world = mpiWorld();
+	const int rank = world.rank();
+	const int size = world.size();
+};
+
+
+TEST_F(FileTests, writeAndReadAtAll) {
+	File file = open();
+	const std::vector<int> data = { rank, 10*rank, 100*rank };
+	file.writeAtAll(static_cast<MPI_Offset>(rank*data.size()*sizeof(int)),data);
+	synchronize(file);
+	EXPECT_EQ(static_cast<MPI_Offset>(size*data.size()*sizeof(int)),file.size());
+	const std::vector<int> results = file.readAtAll<int>(0,3*size);
+	ASSERT_EQ(static_cast<std::size_t>(3*size),results.size());
+	for(int i = 0; i < size; ++i) {
+		EXPECT_EQ(i,results[3*i]);
+		EXPECT_EQ(10*i,results[3*i+1]);
+		EXPECT_EQ(100*i,results[3*i+2]);
+	}
+}
+TEST_F(FileTests, independentWriteAndRead) {
+	File file = open();
+	file.writeAt(static_cast<MPI_Offset>(rank*sizeof(double)),std::vector<double>{ rank + 0.5 });
+	synchronize(file);
+	double result = 0;
+	const int other = (rank+1) % size;
+	EXPECT_EQ(1u,file.readAt(static_cast<MPI_Offset>(other*sizeof(double)),makeSpan(&result,1)));
+	EXPECT_EQ(other + 0.5,result);
+}
+TEST_F(FileTests, readAfterTheEnd) {
+	File file = open();
+	file.setView<int>(0);
+	if(rank == 0) file.writeAt(0,std::vector<int>{ 1, 2 });
+	synchronize(file);
+	std::vector<int> results(4);
+	EXPECT_EQ(1u,file.readAt(1,makeSpan(results)));
+	EXPECT_EQ(2,results[0]);
+}
+TEST_F(FileTests, writeOrdered) {
+	File file = open();
+	file.writeOrdered(std::vector<int>(static_cast<std::size_t>(rank+1),rank));
+	synchronize(file);
+	file.setView<int>(0);
+	const std::vector<int> results = file.readAtAll<int>(0,size*(size+1)/2);
+	ASSERT_EQ(static_cast<std::size_t>(size*(size+1)/2),results.size());
+	std::size_t i = 0;
+	for(int x = 0; x < size; ++x) {
+		for(int j = 0; j <= x; ++j) EXPECT_EQ(x,results[i++]);
+	}
+}
+TEST_F(FileTests, subarrayView) {
+	File file = open();
+	const int rows = 3;
+	file.setSubarrayView<int>(0,{rows,size},{rows,1},{0,rank});
+	std::vector<int> column;
+	for(int i = 0; i < rows; ++i) column.push_back(10*i + rank);
+	file.writeAtAll(0,column);
+	synchronize(file);
+	file.setView<int>(0);
+	const std::vector<int> results = file.readAtAll<int>(0,rows*size);
+	ASSERT_EQ(static_cast<std::size_t>(rows*size),results.size());
+	for(int i = 0; i < rows; ++i) {
+		for(int j = 0; j < size; ++j) EXPECT_EQ(10*i + j,results[i*size + j]);
+	}
+}
+TEST_F(FileTests, asyncWriteAndReadAtAll) {
+	File file = open();
+	file.setView<int>(0);
+	SendRequest written = file.asyncWriteAtAll(2*rank,std::vector<int>{ rank, -rank });
+	written.wait();
+	synchronize(file);
+	ReceiveRequest<std::vector<int>> r = file.asyncReadAtAll<int>(0,2*size);
+	r.wait();
+	const std::vector<int> results = r.take();
+	for(int i = 0; i < size; ++i) {
+		EXPECT_EQ(i,results[2*i]);
+		EXPECT_EQ(-i,results[2*i+1]);
+	}
+}
+TEST_F(FileTests, asyncWriteSpan) {
+	File file = open();
+	file.setView<double>(0);
+	const std::vector<double> data = { 1.5*rank };
+	SendRequest written = file.asyncWriteAtAll(rank,makeSpan(data));
+	written.wait();
+	synchronize(file);
+	EXPECT_EQ(std::vector<double>{ 1.5*rank },file.readAtAll<double>(rank,1));
+}
@@ -0,0 +1,82 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/HierarchicalCollectives.h>
+
+using namespace NiceMPI;
+
+class HierarchicalCollectivesTests : public ::testing::Test {
+public:
+	/** \brief Returns collectives on groups of processes of the same parity, so that the groups are not made of
+  contiguous ranks. */
+	HierarchicalCollectives createInterleaved(std::size_t threshold = 0) {
+		return HierarchicalCollectives(world,world.split(world.rank() % 2,world.rank()),threshold);
+	}
+	std::vector<int> createRanks(int count) const {
+		std::vector<int> result;
+		for(int i = 0; i < world.size(); ++i) {
+			for(int j = 0; j < count; ++j) result.push_back(10*i + j);
+		}
+		return result;
+	}
+
+	Communicator world;
+	const int rank = world.rank();
+	const int size = world.size();
+};
+
+
+TEST_F(HierarchicalCollectivesTests, allGather) {
+	HierarchicalCollectives collectives(world);
+	EXPECT_EQ(createRanks(1),collectives.allGather(10*rank));
+}
+TEST_F(HierarchicalCollectivesTests, allGatherInterleaved) {
+	HierarchicalCollectives collectives = createInterleaved();
+	EXPECT_EQ(createRanks(2),collectives.allGather(std::vector<int>{10*rank,10*rank + 1}));
+}
+TEST_F(HierarchicalCollectivesTests, allReduce) {
+	HierarchicalCollectives collectives(world);
+	EXPECT_EQ(size*(size-1)/2,collectives.allReduce(rank));
+}
+TEST_F(HierarchicalCollectivesTests, allReduceInterleaved) {
+	HierarchicalCollectives collectives = createInterleaved();
+	const std::array<int,2> expected{{size*(size-1)/2,size}};
+	EXPECT_EQ(expected,collectives.allReduce(std::array<int,2>{{rank,1}}));
+	EXPECT_EQ(size - 1,collectives.allReduce(rank,Maximum<int>{}));
+}
+TEST_F(HierarchicalCollectivesTests, broadcastFromEveryProcess) {
+	HierarchicalCollectives collectives = createInterleaved();
+	for(int source = 0; source < size; ++source) {
+		EXPECT_EQ(source,collectives.broadcast(source,rank));
+		const std::vector<int> toSend = rank == source ? std::vector<int>{source,2} : std::vector<int>{};
+		EXPECT_EQ((std::vector<int>{source,2}),collectives.broadcast(source,toSend));
+	}
+}
+TEST_F(HierarchicalCollectivesTests, flatBelowThreshold) {
+	HierarchicalCollectives collectives = createInterleaved(1000);
+	EXPECT_EQ(size,collectives.allReduce(1));
+	EXPECT_EQ(createRanks(1),collectives.allGather(10*rank));
+	EXPECT_EQ(0,collectives.broadcast(0,rank));
+}
@@ -0,0 +1,286 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <memory> // std::shared_ptr
+#include <numeric> // std::iota
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/NiceMPI.h>
+#include <NiceMPI/private/LargeCount.h>
+
+using namespace NiceMPI;
+
+class LargeCountTests : public ::testing::Test {
+public:
+	std::vector<int> createRange(int count, int first) const {
+		std::vector<int> result(count);
+		std::iota(result.begin(), result.end(), first);
+		return result;
+	}
+	std::vector<int> createCounts() const {
+		std::vector<int> counts(mpiWorld().size());
+		for(int i = 0; i < mpiWorld().size(); ++i) counts[i] = i + 2;
+		return counts;
+	}
+	std::vector<std::size_t> createDisplacements(const std::vector<int>& counts) const {
+		std::vector<std::size_t> displacements(counts.size());
+		for(unsigned i = 1; i < counts.size(); ++i) displacements[i] = displacements[i-1] + counts[i-1];
+		return displacements;
+	}
+	std::vector<int> createExpectedGathered(const std::vector<int>& counts) const {
+		std::vector<int> expected;
+		for(unsigned i = 0; i < counts.size(); ++i) {
+			for(auto&& x: createRange(counts[i],100*i)) expected.push_back(x);
+		}
+		return expected;
+	}
+
+	const std::size_t smallMaxCount = 3;
+	const int sourceIndex = 0;
+	const int destinationIndex = mpiWorld().size() - 1;
+};
+
+
+TEST_F(LargeCountTests, smallCountIsNotChanged) {
+	const LargeCountDatatype x(smallMaxCount, MPI_INT, smallMaxCount);
+	EXPECT_EQ(static_cast<int>(smallMaxCount), x.count());
+	EXPECT_EQ(MPI_INT, x.get());
+}
+TEST_F(LargeCountTests, largeCountIsOneBigElement) {
+	const std::size_t count = 3*smallMaxCount + 1;
+	const LargeCountDatatype x(count, MPI_INT, smallMaxCount);
+	EXPECT_EQ(1, x.count());
+	int size = 0;
+	MPI_Type_size(x.get(), &size);
+	EXPECT_EQ(static_cast<int>(count*sizeof(int)), size);
+	MPI_Aint lowerBound = 0, extent = 0;
+	MPI_Type_get_extent(x.get(), &lowerBound, &extent);
+	EXPECT_EQ(static_cast<MPI_Aint>(count*sizeof(int)), extent);
+}
+TEST_F(LargeCountTests, largeCountWithoutRemainder) {
+	const LargeCountDatatype x(2*smallMaxCount, MPI_INT, smallMaxCount);
+	int size = 0;
+	MPI_Type_size(x.get(), &size);
+	EXPECT_EQ(static_cast<int>(2*smallMaxCount*sizeof(int)), size);
+}
+TEST_F(LargeCountTests, sendAndReceive) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<int> toSend = createRange(10,0);
+	if(mpiWorld().rank() == sourceIndex) {
+		handleError(LargeCount::send(toSend.data(), toSend.size(), MPI_INT, destinationIndex, 0, MPI_COMM_WORLD,
+			smallMaxCount));
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		std::vector<int> received(toSend.size());
+		handleError(LargeCount::receive(received.data(), received.size(), MPI_INT, sourceIndex, 0, MPI_COMM_WORLD,
+			MPI_STATUS_IGNORE, smallMaxCount));
+		EXPECT_EQ(toSend, received);
+	}
+}
+TEST_F(LargeCountTests, probedMessageWithBigElements) {
+	if(sourceIndex == destinationIndex) return;
+	const int count = 5;
+	const int tag = 3;
+	if(mpiWorld().rank() == sourceIndex) {
+		const std::vector<int> toSend = createRange(count,0);
+		handleError(LargeCount::send(toSend.data(),toSend.size(),MPI_INT,destinationIndex,tag,MPI_COMM_WORLD,
+			smallMaxCount));
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		MPI_Message message;
+		MPI_Status status;
+		handleError(MPI_Mprobe(sourceIndex,tag,MPI_COMM_WORLD,&message,&status));
+		std::size_t received = 0;
+		handleError(LargeCount::getCount(status,MPI_INT,&received));
+		ASSERT_EQ(count,received);
+		std::vector<int> result(received);
+		handleError(LargeCount::matchedReceive(result.data(),result.size(),MPI_INT,&message,smallMaxCount));
+		EXPECT_EQ(createRange(count,0), result);
+	}
+}
+TEST_F(LargeCountTests, persistentSendAndReceive) {
+	std::vector<int> toSend = createRange(10,0);
+	std::vector<int> received(toSend.size());
+	MPI_Request requests[2];
+	std::shared_ptr<void> datatypeOwners[2];
+	handleError(LargeCount::receiveInit(received.data(), received.size(), MPI_INT, 0, 0, MPI_COMM_SELF,
+		&requests[0], datatypeOwners[0], smallMaxCount));
+	handleError(LargeCount::sendInit(toSend.data(), toSend.size(), MPI_INT, 0, 0, MPI_COMM_SELF, &requests[1],
+		datatypeOwners[1], smallMaxCount));
+	for(auto&& first: {0, 10}) {
+		std::iota(toSend.begin(), toSend.end(), first); // Keeps the buffer bound to the request
+		handleError(MPI_Startall(2, requests));
+		handleError(MPI_Waitall(2, requests, MPI_STATUSES_IGNORE));
+		EXPECT_EQ(toSend, received);
+	}
+	for(auto&& x: requests) MPI_Request_free(&x);
+}
+TEST_F(LargeCountTests, broadcast) {
+	std::vector<int> data(7);
+	if(mpiWorld().rank() == sourceIndex) data = createRange(7,1);
+	handleError(LargeCount::broadcast(data.data(), data.size(), MPI_INT, sourceIndex, MPI_COMM_WORLD,
+		smallMaxCount));
+	EXPECT_EQ(createRange(7,1), data);
+}
+TEST_F(LargeCountTests, asyncBroadcast) {
+	std::vector<int> data(7);
+	if(mpiWorld().rank() == sourceIndex) data = createRange(7,1);
+	MPI_Request request;
+	handleError(LargeCount::asyncBroadcast(data.data(), data.size(), MPI_INT, sourceIndex, MPI_COMM_WORLD, &request,
+		smallMaxCount));
+	handleError(MPI_Wait(&request, MPI_STATUS_IGNORE));
+	EXPECT_EQ(createRange(7,1), data);
+}
+TEST_F(LargeCountTests, allGather) {
+	const int count = 7;
+	const std::vector<int> data = createRange(count,100*mpiWorld().rank());
+	std::vector<int> result(count*mpiWorld().size());
+	handleError(LargeCount::allGather(data.data(), result.data(), data.size(), MPI_INT, MPI_COMM_WORLD,
+		smallMaxCount));
+	EXPECT_EQ(createExpectedGathered(std::vector<int>(mpiWorld().size(),count)), result);
+}
+TEST_F(LargeCountTests, allReduceInChunks) {
+	const std::vector<int> data = createRange(10,0);
+	std::vector<int> result(data.size());
+	handleError(LargeCount::allReduce(data.data(), result.data(), data.size(), MPI_INT, MPI_SUM, MPI_COMM_WORLD,
+		smallMaxCount));
+	for(unsigned i = 0; i < result.size(); ++i) EXPECT_EQ(static_cast<int>(i)*mpiWorld().size(), result[i]);
+}
+TEST_F(LargeCountTests, asyncAllReduceCantReduceInChunks) {
+#if MPI_VERSION < 4
+	const std::vector<int> data = createRange(10,0);
+	std::vector<int> result(data.size());
+	MPI_Request request;
+	EXPECT_EQ(MPI_ERR_COUNT, LargeCount::asyncAllReduce(data.data(), result.data(), data.size(), MPI_INT, MPI_SUM,
+		MPI_COMM_WORLD, &request, smallMaxCount));
+#endif
+}
+TEST_F(LargeCountTests, allReduceInChunksInPlace) {
+	std::vector<int> data = createRange(10,0);
+	handleError(LargeCount::allReduce(MPI_IN_PLACE, data.data(), data.size(), MPI_INT, MPI_SUM, MPI_COMM_WORLD,
+		smallMaxCount));
+	for(unsigned i = 0; i < data.size(); ++i) EXPECT_EQ(static_cast<int>(i)*mpiWorld().size(), data[i]);
+}
+TEST_F(LargeCountTests, varyingGather) {
+	const std::vector<int> counts = createCounts();
+	const std::vector<int> data = createRange(counts[mpiWorld().rank()],100*mpiWorld().rank());
+	std::vector<int> result(mpiWorld().rank() == sourceIndex ? createExpectedGathered(counts).size() : 0);
+	handleError(LargeCount::varyingGather(data.data(), data.size(), result.data(), counts,
+		createDisplacements(counts), MPI_INT, sourceIndex, MPI_COMM_WORLD, smallMaxCount));
+	if(mpiWorld().rank() == sourceIndex) {
+		EXPECT_EQ(createExpectedGathered(counts), result);
+	}
+}
+TEST_F(LargeCountTests, varyingGatherSequentially) {
+	const std::vector<int> counts = createCounts();
+	const std::vector<int> data = createRange(counts[mpiWorld().rank()],100*mpiWorld().rank());
+	for(std::size_t maxCount: {maxIntCount,smallMaxCount}) {
+		std::vector<int> result(mpiWorld().rank() == sourceIndex ? createExpectedGathered(counts).size() : 0);
+		handleError(LargeCount::varyingGather(data.data(), data.size(), result.data(), counts, MPI_INT, sourceIndex,
+			MPI_COMM_WORLD, maxCount));
+		if(mpiWorld().rank() == sourceIndex) {
+			EXPECT_EQ(createExpectedGathered(counts), result);
+		}
+	}
+}
+TEST_F(LargeCountTests, varyingAllGather) {
+	const std::vector<int> counts = createCounts();
+	const std::vector<int> data = createRange(counts[mpiWorld().rank()],100*mpiWorld().rank());
+	std::vector<int> result(createExpectedGathered(counts).size());
+	handleError(LargeCount::varyingAllGather(data.data(), data.size(), result.data(), counts,
+		createDisplacements(counts), MPI_INT, MPI_COMM_WORLD, smallMaxCount));
+	EXPECT_EQ(createExpectedGathered(counts), result);
+}
+TEST_F(LargeCountTests, allToAll) {
+	const int count = 5;
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) for(auto&& x: createRange(count,100*i)) toSend.push_back(x);
+	std::vector<int> result(toSend.size());
+	handleError(LargeCount::allToAll(toSend.data(),result.data(),count,MPI_INT,MPI_COMM_WORLD,smallMaxCount));
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		const std::vector<int> fromProcess(result.begin()+count*i,result.begin()+count*(i+1));
+		EXPECT_EQ(createRange(count,100*mpiWorld().rank()), fromProcess);
+	}
+}
+TEST_F(LargeCountTests, neighborAllGather) {
+	const int count = 5;
+	Communicator ring = mpiWorld().cartesian({mpiWorld().size()},{true},false);
+	const std::vector<int> toSend = createRange(count,100*ring.rank());
+	std::vector<int> result(2*count);
+	handleError(LargeCount::neighborAllGather(toSend.data(),result.data(),count,MPI_INT,ring.get(),smallMaxCount));
+	const Shift neighbors = ring.shift(0);
+	EXPECT_EQ(createRange(count,100*neighbors.source),std::vector<int>(result.begin(),result.begin()+count));
+	EXPECT_EQ(createRange(count,100*neighbors.destination),std::vector<int>(result.begin()+count,result.end()));
+}
+TEST_F(LargeCountTests, varyingAllToAll) {
+	const std::vector<int> sendCounts = createCounts();
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		for(auto&& x: createRange(sendCounts[i],1000*mpiWorld().rank())) toSend.push_back(x);
+	}
+	const std::vector<int> receiveCounts(mpiWorld().size(),sendCounts[mpiWorld().rank()]);
+	std::vector<int> result(receiveCounts[0]*mpiWorld().size());
+	handleError(LargeCount::varyingAllToAll(toSend.data(), sendCounts, createDisplacements(sendCounts), result.data(),
+		receiveCounts, createDisplacements(receiveCounts), MPI_INT, MPI_COMM_WORLD, smallMaxCount));
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		const std::vector<int> fromProcess(result.begin()+receiveCounts[0]*i,result.begin()+receiveCounts[0]*(i+1));
+		EXPECT_EQ(createRange(receiveCounts[0],1000*i), fromProcess);
+	}
+}
+TEST_F(LargeCountTests, varyingScatter) {
+	const std::vector<int> counts = createCounts();
+	std::vector<int> toSend;
+	if(mpiWorld().rank() == sourceIndex) toSend = createExpectedGathered(counts);
+	std::vector<int> result(counts[mpiWorld().rank()]);
+	handleError(LargeCount::varyingScatter(toSend.data(), counts, createDisplacements(counts), result.data(),
+		result.size(), MPI_INT, sourceIndex, MPI_COMM_WORLD, smallMaxCount));
+	EXPECT_EQ(createRange(counts[mpiWorld().rank()],100*mpiWorld().rank()), result);
+}
+TEST_F(LargeCountTests, varyingScatterSequentially) {
+	const std::vector<int> counts = createCounts();
+	std::vector<int> toSend;
+	if(mpiWorld().rank() == sourceIndex) toSend = createExpectedGathered(counts);
+	for(std::size_t maxCount: {maxIntCount,smallMaxCount}) {
+		std::vector<int> result(counts[mpiWorld().rank()]);
+		handleError(LargeCount::varyingScatter(toSend.data(), counts, result.data(), result.size(), MPI_INT,
+			sourceIndex, MPI_COMM_WORLD, maxCount));
+		EXPECT_EQ(createRange(counts[mpiWorld().rank()],100*mpiWorld().rank()), result);
+	}
+}
+TEST_F(LargeCountTests, writeAndReadFileAtAll) {
+	MPI_File file;
+	handleError(MPI_File_open(MPI_COMM_WORLD, "NiceMPI_LargeCountTests.bin",
+		MPI_MODE_CREATE | MPI_MODE_RDWR | MPI_MODE_DELETE_ON_CLOSE, MPI_INFO_NULL, &file));
+	const std::vector<int> data = createRange(7,100*mpiWorld().rank());
+	const MPI_Offset offset = static_cast<MPI_Offset>(mpiWorld().rank()*data.size()*sizeof(int));
+	handleError(LargeCount::writeAtAll(file, offset, data.data(), data.size(), MPI_INT, MPI_STATUS_IGNORE,
+		smallMaxCount));
+	handleError(MPI_File_sync(file));
+	std::vector<int> result(data.size());
+	MPI_Status status;
+	handleError(LargeCount::readAt(file, offset, result.data(), result.size(), MPI_INT, &status, smallMaxCount));
+	std::size_t count = 0;
+	handleError(LargeCount::getCount(status, MPI_INT, &count));
+	EXPECT_EQ(data.size(), count);
+	EXPECT_EQ(data, result);
+	handleError(MPI_File_close(&file));
+}
@@ -51,6 +51,12 @@ public:
 	OwnedCommunicator(MPI_Comm rhs) {
 		handleError(MPI_Comm_dup(rhs,&mpiCommunicator));
 	}
+	/** \brief Creates a communicator handle that owns \p rhs, without duplicating it. */
+	static std::unique_ptr<MPIcommunicatorHandleImpl> adopt(MPI_Comm rhs) {
+		OwnedCommunicator* x = new OwnedCommunicator;
+		x->mpiCommunicator = rhs;
+		return std::unique_ptr<MPIcommunicatorHandleImpl>(x);
+	}
 	/** \brief [Rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
 	OwnedCommunicator(const OwnedCommunicator&) = delete;
 	/** \brief [Rule of 5](http://en.cppreference.com/w/cpp/language/rule_of_three). */
@@ -76,6 +82,9 @@ public:
 	}
 
 private:
+	/** \brief Used by adopt(). */
+	OwnedCommunicator() = default;
+
 	/** \brief Underlying MPI implementation of this handle. */
 	MPI_Comm mpiCommunicator;	
 };
@@ -101,32 +110,94 @@ private:
 	MPI_Comm mpiCommunicator;
 };
 
+namespace {
+
+/** \brief Frees the handle of the private duplicate cached as an attribute, when its communicator is freed. */
+int deletePrivateDuplicate(MPI_Comm, int, void* attribute, void*) {
+	delete static_cast<MPIcommunicatorHandle*>(attribute);
+	return MPI_SUCCESS;
+}
+
+/** \brief Returns the key of the private duplicates cached in the communicators. The duplicates made by the user
+  don't inherit them. */
+int privateDuplicateKey() {
+	static const int key = [] () {
+		int x = MPI_KEYVAL_INVALID;
+		handleError(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,&deletePrivateDuplicate,&x,nullptr));
+		return x;
+	}();
+	return key;
+}
+
+} // namespace
+
 MPIcommunicatorHandle::MPIcommunicatorHandle(MPI_Comm mpiCommunicator)
 : impl(new OwnedCommunicator(mpiCommunicator))
-{}
+{
+	cache();
+}
 MPIcommunicatorHandle::MPIcommunicatorHandle(MPI_Comm* mpiCommunicator)
 : impl(new ProxyCommunicator(*mpiCommunicator))
-{}
+{
+	cache();
+}
+MPIcommunicatorHandle MPIcommunicatorHandle::adopt(MPI_Comm mpiCommunicator) {
+	if(mpiCommunicator == MPI_COMM_NULL) return MPIcommunicatorHandle(&mpiCommunicator);
+	return MPIcommunicatorHandle(std::shared_ptr<MPIcommunicatorHandleImpl>(OwnedCommunicator::adopt(mpiCommunicator)));
+}
 MPIcommunicatorHandle::MPIcommunicatorHandle(const MPIcommunicatorHandle& rhs) {
 	impl = rhs.impl->deepCopy();
+	cache();
 }
-MPIcommunicatorHandle::MPIcommunicatorHandle(MPIcommunicatorHandle&& rhs) {
+MPIcommunicatorHandle::MPIcommunicatorHandle(MPIcommunicatorHandle&& rhs)
+: mpiCommunicator(rhs.mpiCommunicator), cachedRank(rhs.cachedRank), cachedSize(rhs.cachedSize),
+	cachedTopology(rhs.cachedTopology)
+{
 	impl = std::move(rhs.impl);
 }
 MPIcommunicatorHandle::~MPIcommunicatorHandle() = default;
 MPIcommunicatorHandle& MPIcommunicatorHandle::operator=(const MPIcommunicatorHandle& rhs) {
 	impl = rhs.impl->deepCopy();
+	cache();
 	return *this;
 }
 MPIcommunicatorHandle& MPIcommunicatorHandle::operator=(MPIcommunicatorHandle&& rhs) {
 	impl = std::move(rhs.impl);
+	mpiCommunicator = rhs.mpiCommunicator;
+	cachedRank = rhs.cachedRank;
+	cachedSize = rhs.cachedSize;
+	cachedTopology = rhs.cachedTopology;
 	return *this;
 }
-MPI_Comm MPIcommunicatorHandle::get() const {
-	return impl->get();
+MPIcommunicatorHandle MPIcommunicatorHandle::shared() const {
+	return MPIcommunicatorHandle(impl);
+}
+MPIcommunicatorHandle MPIcommunicatorHandle::privateDuplicate() const {
+	void* attribute = nullptr;
+	int found = 0;
+	handleError(MPI_Comm_get_attr(mpiCommunicator,privateDuplicateKey(),&attribute,&found));
+	if(!found) {
+		MPI_Comm duplicate;
+		handleError(MPI_Comm_dup(mpiCommunicator,&duplicate));
+		attribute = new MPIcommunicatorHandle(adopt(duplicate));
+		handleError(MPI_Comm_set_attr(mpiCommunicator,privateDuplicateKey(),attribute));
+	}
+	return static_cast<MPIcommunicatorHandle*>(attribute)->shared();
+}
+MPIcommunicatorHandle::MPIcommunicatorHandle(std::shared_ptr<MPIcommunicatorHandleImpl> rhs)
+: impl(std::move(rhs))
+{
+	cache();
 }
-MPI_Comm MPIcommunicatorHandle::get() {
-	return impl->get();
+void MPIcommunicatorHandle::cache() {
+	mpiCommunicator = impl->get();
+	cachedRank = MPI_UNDEFINED;
+	cachedSize = 0;
+	cachedTopology = MPI_UNDEFINED;
+	if(mpiCommunicator == MPI_COMM_NULL) return;
+	handleError(MPI_Comm_rank(mpiCommunicator,&cachedRank));
+	handleError(MPI_Comm_size(mpiCommunicator,&cachedSize));
+	handleError(MPI_Topo_test(mpiCommunicator,&cachedTopology));
 }
 
 } // NiceMPi
@@ -78,3 +78,52 @@ TEST_F(MPIcommunicatorHandleTests, MoveAssignment) {
 	MPIcommunicatorHandle x{world};
 	EXPECT_TRUE( areIdenticalMPI(lhs,(x = std::move(self)).get()) );
 }
+TEST_F(MPIcommunicatorHandleTests, Shared) {
+	const MPIcommunicatorHandle shared = world.shared();
+	EXPECT_TRUE( areIdenticalMPI(world.get(),shared.get()) );
+}
+TEST_F(MPIcommunicatorHandleTests, Adopt) {
+	MPI_Comm duplicated;
+	MPI_Comm_dup(MPI_COMM_SELF,&duplicated);
+	const MPIcommunicatorHandle x = MPIcommunicatorHandle::adopt(duplicated);
+	EXPECT_TRUE( areIdenticalMPI(duplicated,x.get()) );
+	EXPECT_EQ(1, x.size());
+}
+TEST_F(MPIcommunicatorHandleTests, AdoptNull) {
+	const MPIcommunicatorHandle x = MPIcommunicatorHandle::adopt(MPI_COMM_NULL);
+	EXPECT_EQ(MPI_COMM_NULL, x.get());
+}
+TEST_F(MPIcommunicatorHandleTests, RankAndSize) {
+	int rank, size;
+	MPI_Comm_rank(MPI_COMM_WORLD,&rank);
+	MPI_Comm_size(MPI_COMM_WORLD,&size);
+	EXPECT_EQ(rank, world.rank());
+	EXPECT_EQ(size, world.size());
+}
+TEST_F(MPIcommunicatorHandleTests, RankAndSizeOfProxy) {
+	MPI_Comm notRvalue = MPI_COMM_SELF;
+	const MPIcommunicatorHandle x(&notRvalue);
+	EXPECT_EQ(0, x.rank());
+	EXPECT_EQ(1, x.size());
+}
+TEST_F(MPIcommunicatorHandleTests, RankAndSizeOfNullProxy) {
+	MPI_Comm notRvalue = MPI_COMM_NULL;
+	const MPIcommunicatorHandle x(&notRvalue);
+	EXPECT_EQ(MPI_UNDEFINED, x.rank());
+	EXPECT_EQ(0, x.size());
+}
+TEST_F(MPIcommunicatorHandleTests, RankAndSizeAreMovedAndAssigned) {
+	MPIcommunicatorHandle self(MPI_COMM_SELF);
+	MPIcommunicatorHandle x{world};
+	x = std::move(self);
+	EXPECT_EQ(1, x.size());
+	const MPIcommunicatorHandle y{std::move(x)};
+	EXPECT_EQ(1, y.size());
+	MPIcommunicatorHandle z{world};
+	z = y;
+	EXPECT_EQ(1, z.size());
+	EXPECT_EQ(0, z.rank());
+}
+TEST_F(MPIcommunicatorHandleTests, TopologyOfWorld) {
+	EXPECT_EQ(MPI_UNDEFINED, world.topology());
+}
@@ -0,0 +1,71 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <complex>
+#include <gtest/gtest.h>
+#include <NiceMPI/MPIdatatype.h>
+
+using namespace NiceMPI;
+
+class MPIdatatypeTests : public ::testing::Test {
+public:
+	struct PODtype {
+		int theInt;
+		double theDouble;
+		char theChar;
+	};
+};
+
+
+TEST_F(MPIdatatypeTests, arithmeticTypesAreNative) {
+	const bool isNative = mpi_datatype<double>::isNative;
+	EXPECT_TRUE(isNative);
+	EXPECT_EQ(MPI_DOUBLE, mpi_datatype<double>::get());
+	EXPECT_EQ(MPI_INT, mpi_datatype<int>::get());
+	EXPECT_EQ(MPI_UNSIGNED_LONG_LONG, mpi_datatype<unsigned long long>::get());
+	EXPECT_EQ(MPI_CXX_BOOL, mpi_datatype<bool>::get());
+}
+TEST_F(MPIdatatypeTests, complexTypesAreNative) {
+	const bool isNative = mpi_datatype<std::complex<double>>::isNative;
+	EXPECT_TRUE(isNative);
+	EXPECT_EQ(MPI_CXX_FLOAT_COMPLEX, mpi_datatype<std::complex<float>>::get());
+	EXPECT_EQ(MPI_CXX_DOUBLE_COMPLEX, mpi_datatype<std::complex<double>>::get());
+}
+TEST_F(MPIdatatypeTests, PODsAreNotNative) {
+	const bool isNative = mpi_datatype<PODtype>::isNative;
+	EXPECT_FALSE(isNative);
+}
+TEST_F(MPIdatatypeTests, PODdatatypeHasTheSizeOfThePOD) {
+	int size = 0;
+	MPI_Type_size(mpi_datatype<PODtype>::get(), &size);
+	EXPECT_EQ(static_cast<int>(sizeof(PODtype)), size);
+}
+TEST_F(MPIdatatypeTests, PODdatatypeHasTheExtentOfThePOD) {
+	MPI_Aint lowerBound = 0;
+	MPI_Aint extent = 0;
+	MPI_Type_get_extent(mpi_datatype<PODtype>::get(), &lowerBound, &extent);
+	EXPECT_EQ(0, lowerBound);
+	EXPECT_EQ(static_cast<MPI_Aint>(sizeof(PODtype)), extent);
+}
+TEST_F(MPIdatatypeTests, PODdatatypeIsCreatedOnce) {
+	EXPECT_EQ(mpi_datatype<PODtype>::get(), mpi_datatype<PODtype>::get());
+}
@@ -0,0 +1,89 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <complex>
+#include <functional> // std::plus
+#include <gtest/gtest.h>
+#include <NiceMPI/MPIoperator.h>
+
+using namespace NiceMPI;
+
+class MPIoperatorTests : public ::testing::Test {
+public:
+	struct PODtype {
+		int theInt;
+		double theDouble;
+	};
+	struct PODtypeSum {
+		PODtype operator()(const PODtype& a, const PODtype& b) const {
+			return PODtype{a.theInt + b.theInt, a.theDouble + b.theDouble};
+		}
+	};
+};
+
+
+TEST_F(MPIoperatorTests, maximum) {
+	EXPECT_EQ(3, Maximum<int>{}(2,3));
+	EXPECT_EQ(3, Maximum<int>{}(3,2));
+}
+TEST_F(MPIoperatorTests, minimum) {
+	EXPECT_EQ(2, Minimum<int>{}(2,3));
+	EXPECT_EQ(2, Minimum<int>{}(3,2));
+}
+TEST_F(MPIoperatorTests, predefinedOperators) {
+	EXPECT_EQ(MPI_SUM, (mpi_operator<std::plus<double>,double>::get({})));
+	EXPECT_EQ(MPI_PROD, (mpi_operator<std::multiplies<int>,int>::get({})));
+	EXPECT_EQ(MPI_MAX, (mpi_operator<Maximum<float>,float>::get({})));
+	EXPECT_EQ(MPI_MIN, (mpi_operator<Minimum<long>,long>::get({})));
+	EXPECT_EQ(MPI_LAND, (mpi_operator<std::logical_and<bool>,bool>::get({})));
+	EXPECT_EQ(MPI_BXOR, (mpi_operator<std::bit_xor<unsigned>,unsigned>::get({})));
+}
+TEST_F(MPIoperatorTests, complexPredefinedOperators) {
+	EXPECT_EQ(MPI_SUM, (mpi_operator<std::plus<std::complex<double>>,std::complex<double>>::get({})));
+	EXPECT_EQ(MPI_PROD, (mpi_operator<std::multiplies<std::complex<float>>,std::complex<float>>::get({})));
+}
+TEST_F(MPIoperatorTests, predefinedOperatorsOfCharactersAndBool) {
+	EXPECT_EQ(MPI_SUM, (mpi_operator<std::plus<signed char>,signed char>::get({})));
+	EXPECT_EQ(MPI_BAND, (mpi_operator<std::bit_and<unsigned char>,unsigned char>::get({})));
+	EXPECT_EQ(MPI_LOR, (mpi_operator<std::logical_or<bool>,bool>::get({})));
+	EXPECT_NE(MPI_SUM, (mpi_operator<std::plus<bool>,bool>::get({})));
+	EXPECT_NE(MPI_BAND, (mpi_operator<std::bit_and<bool>,bool>::get({})));
+	EXPECT_NE(MPI_MAX, (mpi_operator<Maximum<bool>,bool>::get({})));
+	EXPECT_NE(MPI_SUM, (mpi_operator<std::plus<char>,char>::get({})));
+	EXPECT_NE(MPI_MIN, (mpi_operator<Minimum<char>,char>::get({})));
+	EXPECT_NE(MPI_LAND, (mpi_operator<std::logical_and<char>,char>::get({})));
+	EXPECT_NE(MPI_PROD, (mpi_operator<std::multiplies<wchar_t>,wchar_t>::get({})));
+	EXPECT_NE(MPI_BXOR, (mpi_operator<std::bit_xor<wchar_t>,wchar_t>::get({})));
+}
+TEST_F(MPIoperatorTests, MPIopIsForwarded) {
+	EXPECT_EQ(MPI_MAXLOC, (mpi_operator<MPI_Op,int>::get(MPI_MAXLOC)));
+}
+TEST_F(MPIoperatorTests, userDefinedOperatorIsCreatedOnce) {
+	const MPI_Op op = mpi_operator<PODtypeSum,PODtype>::get({});
+	EXPECT_NE(MPI_OP_NULL, op);
+	EXPECT_EQ(op, (mpi_operator<PODtypeSum,PODtype>::get({})));
+}
+TEST_F(MPIoperatorTests, userDefinedOperatorIsNotCommutativeByDefault) {
+	int commutative = 1;
+	MPI_Op_commutative(mpi_operator<PODtypeSum,PODtype>::get({}), &commutative);
+	EXPECT_EQ(0, commutative);
+}
@@ -0,0 +1,190 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <NiceMPI/MemoryPool.h>
+#include <map>
+#include <mpi.h> // MPI_Alloc_mem, MPI_Free_mem
+#include <mutex> // std::mutex, std::lock_guard
+#include <new> // std::bad_alloc
+#include <utility> // std::pair
+#include <vector>
+#ifdef __linux__
+	#include <sys/mman.h> // mmap, madvise
+#endif
+#if defined(NICEMPI_CUDA)
+	#include <cuda_runtime.h> // cudaMalloc, cudaFree
+#elif defined(NICEMPI_HIP)
+	#include <hip/hip_runtime.h> // hipMalloc, hipFree
+#endif
+
+namespace NiceMPI {
+
+namespace {
+
+/** \brief Blocks that are not in use, by memory kind and by size. */
+struct Cache {
+	/** \brief Addresses of the free blocks of each kind and size. */
+	std::map<std::pair<MemoryKind,std::size_t>,std::vector<void*>> blocks;
+	/** \brief Sum of the sizes of the free blocks. */
+	std::size_t bytes = 0;
+	/** \brief Memory can be allocated by many threads at the same time. */
+	std::mutex mutex;
+};
+
+/** \brief Returns the unique instance of Cache. */
+Cache& cache() {
+	static Cache instance;
+	return instance;
+}
+
+/** \brief Returns true if MPI can be called. */
+bool isMPIactive() {
+	int initialized = 0, finalized = 0;
+	MPI_Initialized(&initialized);
+	MPI_Finalized(&finalized);
+	return initialized != 0 and finalized == 0;
+}
+
+/** \brief Size of a huge page, to which the blocks of huge pages are rounded. */
+constexpr std::size_t hugePageSize = 2*1024*1024;
+
+/** \brief Returns the size of the block that holds \p bytes bytes of the memory \p kind. */
+std::size_t blockSize(std::size_t bytes, MemoryKind kind) {
+	std::size_t result = kind == MemoryKind::hugePages ? hugePageSize : 64;
+	while(result < bytes) result *= 2;
+	return result;
+}
+
+/** \brief Returns a new block of \p size bytes of the memory \p kind, or nullptr if it can't be allocated. */
+void* allocateBlock(std::size_t size, MemoryKind kind) {
+	void* result = nullptr;
+	switch(kind) {
+	case MemoryKind::host:
+		return ::operator new(size,std::nothrow);
+	case MemoryKind::mpi:
+		if(!isMPIactive() or MPI_Alloc_mem(static_cast<MPI_Aint>(size),MPI_INFO_NULL,&result) != MPI_SUCCESS) {
+			return nullptr;
+		}
+		return result;
+	case MemoryKind::hugePages:
+#ifdef __linux__
+	#ifdef MAP_HUGETLB
+		result = mmap(nullptr,size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,-1,0);
+		if(result != MAP_FAILED) return result;
+	#endif
+		result = mmap(nullptr,size,PROT_READ | PROT_WRITE,MAP_PRIVATE | MAP_ANONYMOUS,-1,0);
+		if(result == MAP_FAILED) return nullptr;
+	#ifdef MADV_HUGEPAGE
+		madvise(result,size,MADV_HUGEPAGE);
+	#endif
+		return result;
+#else
+		return ::operator new(size,std::nothrow);
+#endif
+#if defined(NICEMPI_CUDA)
+	case MemoryKind::device:
+		return cudaMalloc(&result,size) == cudaSuccess ? result : nullptr;
+#elif defined(NICEMPI_HIP)
+	case MemoryKind::device:
+		return hipMalloc(&result,size) == hipSuccess ? result : nullptr;
+#endif
+	}
+	return nullptr;
+}
+
+/** \brief Frees the \p block of \p size bytes of the memory \p kind. */
+void freeBlock(void* block, std::size_t size, MemoryKind kind) {
+	((void)size); // Unused without huge pages
+	switch(kind) {
+	case MemoryKind::host:
+		::operator delete(block);
+		return;
+	case MemoryKind::mpi:
+		if(isMPIactive()) MPI_Free_mem(block); // Else, MPI already freed it
+		return;
+	case MemoryKind::hugePages:
+#ifdef __linux__
+		munmap(block,size);
+#else
+		::operator delete(block);
+#endif
+		return;
+#if defined(NICEMPI_CUDA)
+	case MemoryKind::device:
+		cudaFree(block);
+		return;
+#elif defined(NICEMPI_HIP)
+	case MemoryKind::device:
+		hipFree(block);
+		return;
+#endif
+	}
+}
+
+} // namespace
+
+void* MemoryPool::allocate(std::size_t bytes, MemoryKind kind) {
+	if(bytes == 0) return nullptr;
+	const std::size_t size = blockSize(bytes,kind);
+	Cache& x = cache();
+	{
+		std::lock_guard<std::mutex> lock(x.mutex);
+		const auto found = x.blocks.find({kind,size});
+		if(found != x.blocks.end() and !found->second.empty()) {
+			void* result = found->second.back();
+			found->second.pop_back();
+			x.bytes -= size;
+			return result;
+		}
+	}
+	void* result = allocateBlock(size,kind);
+	if(result == nullptr) throw std::bad_alloc{};
+	return result;
+}
+
+std::size_t MemoryPool::cachedBytes() {
+	Cache& x = cache();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	return x.bytes;
+}
+
+void MemoryPool::deallocate(void* data, std::size_t bytes, MemoryKind kind) {
+	if(data == nullptr) return;
+	if(kind == MemoryKind::mpi and !isMPIactive()) return; // MPI already freed it
+	const std::size_t size = blockSize(bytes,kind);
+	Cache& x = cache();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	x.blocks[{kind,size}].push_back(data);
+	x.bytes += size;
+}
+
+void MemoryPool::release() {
+	Cache& x = cache();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	for(auto&& blocks: x.blocks) {
+		for(void* block: blocks.second) freeBlock(block,blocks.first.second,blocks.first.first);
+	}
+	x.blocks.clear();
+	x.bytes = 0;
+}
+
+} // NiceMPi
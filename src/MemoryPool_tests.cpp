@@ -0,0 +1,79 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <cstring> // std::memset
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/MemoryPool.h>
+
+using namespace NiceMPI;
+
+TEST(MemoryPoolTests, reusesTheBlocks) {
+	MemoryPool::release();
+	void* first = MemoryPool::allocate(100,MemoryKind::host);
+	MemoryPool::deallocate(first,100,MemoryKind::host);
+	EXPECT_EQ(128,MemoryPool::cachedBytes());
+	EXPECT_EQ(first,MemoryPool::allocate(120,MemoryKind::host));
+	EXPECT_EQ(0,MemoryPool::cachedBytes());
+	MemoryPool::deallocate(first,120,MemoryKind::host);
+	MemoryPool::release();
+	EXPECT_EQ(0,MemoryPool::cachedBytes());
+}
+TEST(MemoryPoolTests, blocksAreCachedByKind) {
+	MemoryPool::release();
+	void* host = MemoryPool::allocate(64,MemoryKind::host);
+	MemoryPool::deallocate(host,64,MemoryKind::host);
+	void* mpi = MemoryPool::allocate(64,MemoryKind::mpi);
+	EXPECT_NE(host,mpi);
+	MemoryPool::deallocate(mpi,64,MemoryKind::mpi);
+	MemoryPool::release();
+}
+TEST(MemoryPoolTests, hugePagesAreWritable) {
+	MemoryPool::release();
+	const std::size_t size = 3*1024*1024;
+	void* data = MemoryPool::allocate(size,MemoryKind::hugePages);
+	std::memset(data,1,size);
+	MemoryPool::deallocate(data,size,MemoryKind::hugePages);
+	EXPECT_EQ(4*1024*1024,MemoryPool::cachedBytes());
+	MemoryPool::release();
+}
+TEST(MemoryPoolTests, emptyAllocation) {
+	EXPECT_EQ(nullptr,MemoryPool::allocate(0,MemoryKind::host));
+	MemoryPool::deallocate(nullptr,0,MemoryKind::host);
+}
+TEST(MemoryPoolTests, pooledVector) {
+	MemoryPool::release();
+	const double* first = nullptr;
+	{
+		PooledVector<double> data(10,1.5);
+		first = data.data();
+		EXPECT_EQ(1.5,data.at(9));
+	}
+	PooledVector<double> data(12);
+	EXPECT_EQ(first,data.data());
+}
+TEST(MemoryPoolTests, poolAllocatorsAreEqual) {
+	const PoolAllocator<int> a;
+	const PoolAllocator<double> b(a);
+	EXPECT_TRUE(a == b);
+	EXPECT_FALSE(a != b);
+}
@@ -0,0 +1,277 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <atomic>
+#include <cstdint> // std::int64_t
+#include <cstdlib> // std::malloc, std::free
+#include <new> // std::bad_alloc
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <NiceMPI/NiceMPI.h>
+
+using namespace NiceMPI;
+
+namespace {
+
+/** \brief Number of allocations made with operator new, to count the allocations of each call. */
+std::atomic<unsigned long long> allocations(0);
+
+/** \brief Reports nothing, for the processes other than the first one. */
+class NullReporter: public benchmark::BenchmarkReporter {
+public:
+	bool ReportContext(const Context&) override {
+		return true;
+	}
+	void ReportRuns(const std::vector<Run>&) override {}
+};
+
+/** \brief Returns the number of iterations for messages of \p bytes, the same on every process, so that they all
+  make the same calls. */
+benchmark::IterationCount iterationsFor(std::size_t bytes) {
+	const std::size_t iterations = (std::size_t(64) << 20)/bytes;
+	return static_cast<benchmark::IterationCount>(iterations < 20 ? 20 : iterations > 10000 ? 10000 : iterations);
+}
+
+/** \brief Times \p iteration on every process, for each iteration of \p state, and reports the time of the
+  slowest process, with the mean number of allocations of each iteration on the first process. */
+template<class Iteration>
+void run(benchmark::State& state, Iteration iteration) {
+	unsigned long long allocated = 0;
+	for(auto _: state) {
+		const unsigned long long before = allocations;
+		const double start = MPI_Wtime();
+		iteration();
+		double elapsed = MPI_Wtime() - start;
+		allocated += allocations - before;
+		MPI_Allreduce(MPI_IN_PLACE,&elapsed,1,MPI_DOUBLE,MPI_MAX,MPI_COMM_WORLD);
+		state.SetIterationTime(elapsed);
+	}
+	state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocated),
+		benchmark::Counter::kAvgIterations);
+}
+
+/** \brief Registers the \p benchmark of \p messages messages of \p bytes by iteration, which runs with \p count
+  doubles. */
+template<class Benchmark>
+void add(const std::string& name, std::size_t bytes, Benchmark benchmark, std::size_t messages = 1) {
+	const std::size_t count = bytes/sizeof(double);
+	benchmark::RegisterBenchmark((name + "/" + std::to_string(bytes)).c_str(),[=](benchmark::State& state) {
+		benchmark(state,count);
+		state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()*bytes*messages));
+	})->UseManualTime()->Iterations(iterationsFor(bytes))->Unit(benchmark::kMicrosecond);
+}
+
+/** \brief Returns the counts of varyingAllGather: the process \p i gives \p count + \p i elements. */
+std::vector<int> varyingCounts(std::size_t count) {
+	std::vector<int> counts(static_cast<std::size_t>(mpiWorld().size()));
+	for(std::size_t i = 0; i < counts.size(); ++i) counts[i] = static_cast<int>(count + i);
+	return counts;
+}
+
+/** \brief Number of messages in flight in the bandwidth and request pool benchmarks. */
+constexpr int window = 64;
+
+
+
+void pingPongRaw(benchmark::State& state, std::size_t count) {
+	if(mpiWorld().size() < 2) return state.SkipWithError("Requires two processes.");
+	std::vector<double> data(count);
+	const int rank = mpiWorld().rank();
+	run(state,[&]() {
+		if(rank == 0) {
+			MPI_Send(data.data(),static_cast<int>(count),MPI_DOUBLE,1,0,MPI_COMM_WORLD);
+			MPI_Recv(data.data(),static_cast<int>(count),MPI_DOUBLE,1,0,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+		}
+		if(rank == 1) {
+			MPI_Recv(data.data(),static_cast<int>(count),MPI_DOUBLE,0,0,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+			MPI_Send(data.data(),static_cast<int>(count),MPI_DOUBLE,0,0,MPI_COMM_WORLD);
+		}
+	});
+}
+void pingPongNiceMPI(benchmark::State& state, std::size_t count) {
+	if(mpiWorld().size() < 2) return state.SkipWithError("Requires two processes.");
+	std::vector<double> data(count);
+	Communicator& world = mpiWorld();
+	run(state,[&]() {
+		if(world.rank() == 0) {
+			world.send(data,1);
+			data = world.receive<std::vector<double>>(count,1);
+		}
+		if(world.rank() == 1) {
+			data = world.receive<std::vector<double>>(count,0);
+			world.send(data,0);
+		}
+	});
+}
+
+void bandwidthRaw(benchmark::State& state, std::size_t count) {
+	if(mpiWorld().size() < 2) return state.SkipWithError("Requires two processes.");
+	std::vector<std::vector<double>> data(window,std::vector<double>(count));
+	std::vector<MPI_Request> requests(window);
+	const int rank = mpiWorld().rank();
+	run(state,[&]() {
+		if(rank > 1) return;
+		for(int i = 0; i < window; ++i) {
+			if(rank == 0) MPI_Isend(data[i].data(),static_cast<int>(count),MPI_DOUBLE,1,0,MPI_COMM_WORLD,&requests[i]);
+			else MPI_Irecv(data[i].data(),static_cast<int>(count),MPI_DOUBLE,0,0,MPI_COMM_WORLD,&requests[i]);
+		}
+		MPI_Waitall(window,requests.data(),MPI_STATUSES_IGNORE);
+		if(rank == 0) MPI_Recv(nullptr,0,MPI_BYTE,1,1,MPI_COMM_WORLD,MPI_STATUS_IGNORE);
+		else MPI_Send(nullptr,0,MPI_BYTE,0,1,MPI_COMM_WORLD);
+	});
+	state.counters["messages"] = window;
+}
+void bandwidthNiceMPI(benchmark::State& state, std::size_t count) {
+	if(mpiWorld().size() < 2) return state.SkipWithError("Requires two processes.");
+	const std::vector<double> data(count);
+	Communicator& world = mpiWorld();
+	run(state,[&]() {
+		if(world.rank() > 1) return;
+		RequestSet requests;
+		for(int i = 0; i < window; ++i) {
+			if(world.rank() == 0) requests.add(world.asyncSend(makeSpan(data),1));
+			else requests.add(world.asyncReceive<PooledVector<double>>(count,0));
+		}
+		requests.waitAll();
+		if(world.rank() == 0) world.receive<int>(1,1);
+		else world.send(0,0,1);
+	});
+	state.counters["messages"] = window;
+}
+
+void broadcastRaw(benchmark::State& state, std::size_t count) {
+	std::vector<double> data(count);
+	run(state,[&]() {
+		MPI_Bcast(data.data(),static_cast<int>(count),MPI_DOUBLE,0,MPI_COMM_WORLD);
+	});
+}
+void broadcastNiceMPI(benchmark::State& state, std::size_t count) {
+	std::vector<double> data(count);
+	run(state,[&]() {
+		data = mpiWorld().broadcast(0,std::move(data));
+	});
+}
+
+void allGatherRaw(benchmark::State& state, std::size_t count) {
+	const std::vector<double> data(count);
+	std::vector<double> result(count*mpiWorld().size());
+	run(state,[&]() {
+		MPI_Allgather(data.data(),static_cast<int>(count),MPI_DOUBLE,result.data(),static_cast<int>(count),MPI_DOUBLE,
+			MPI_COMM_WORLD);
+	});
+}
+void allGatherNiceMPI(benchmark::State& state, std::size_t count) {
+	const std::vector<double> data(count);
+	run(state,[&]() {
+		benchmark::DoNotOptimize(mpiWorld().allGather(data));
+	});
+}
+
+void varyingAllGatherRaw(benchmark::State& state, std::size_t count) {
+	const std::vector<int> counts = varyingCounts(count);
+	std::vector<int> displacements(counts.size(),0);
+	for(std::size_t i = 1; i < counts.size(); ++i) displacements[i] = displacements[i-1] + counts[i-1];
+	const std::vector<double> data(static_cast<std::size_t>(counts[mpiWorld().rank()]));
+	std::vector<double> result(static_cast<std::size_t>(displacements.back() + counts.back()));
+	run(state,[&]() {
+		MPI_Allgatherv(data.data(),static_cast<int>(data.size()),MPI_DOUBLE,result.data(),counts.data(),
+			displacements.data(),MPI_DOUBLE,MPI_COMM_WORLD);
+	});
+}
+void varyingAllGatherNiceMPI(benchmark::State& state, std::size_t count) {
+	const std::vector<int> counts = varyingCounts(count);
+	const std::vector<double> data(static_cast<std::size_t>(counts[mpiWorld().rank()]));
+	run(state,[&]() {
+		benchmark::DoNotOptimize(mpiWorld().varyingAllGather(data,counts));
+	});
+}
+
+void requestPoolRaw(benchmark::State& state, std::size_t) {
+	const int size = mpiWorld().size(), rank = mpiWorld().rank();
+	std::vector<double> received(window), sent(window);
+	std::vector<MPI_Request> requests(2*window);
+	run(state,[&]() {
+		for(int i = 0; i < window; ++i) {
+			MPI_Irecv(&received[i],1,MPI_DOUBLE,(rank+size-1) % size,i,MPI_COMM_WORLD,&requests[i]);
+			MPI_Isend(&sent[i],1,MPI_DOUBLE,(rank+1) % size,i,MPI_COMM_WORLD,&requests[window+i]);
+		}
+		MPI_Waitall(2*window,requests.data(),MPI_STATUSES_IGNORE);
+	});
+	state.counters["requests"] = benchmark::Counter(static_cast<double>(2*window*state.iterations()),
+		benchmark::Counter::kIsRate);
+}
+void requestPoolNiceMPI(benchmark::State& state, std::size_t) {
+	Communicator& world = mpiWorld();
+	const int size = world.size(), rank = world.rank();
+	run(state,[&]() {
+		RequestSet requests;
+		for(int i = 0; i < window; ++i) {
+			requests.add(world.asyncReceive<double>((rank+size-1) % size,i));
+			requests.add(world.asyncSend(0.5,(rank+1) % size,i));
+		}
+		requests.waitAll();
+	});
+	state.counters["requests"] = benchmark::Counter(static_cast<double>(2*window*state.iterations()),
+		benchmark::Counter::kIsRate);
+}
+
+} // namespace
+
+/** \brief Counts the allocations. The other forms of operator new call this one. */
+void* operator new(std::size_t size) {
+	++allocations;
+	if(void* p = std::malloc(size == 0 ? 1 : size)) return p;
+	throw std::bad_alloc();
+}
+/** \brief Frees the memory of the operator new that counts the allocations. */
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+/** \brief Runs each case with raw MPI and with NiceMPI, on every process. Only the first process reports, and the
+  results can be written in JSON with --benchmark_out=results.json. */
+int main(int argc, char** argv) {
+	Initializer init(argc,argv);
+	for(std::size_t bytes = 8; bytes <= (std::size_t(4) << 20); bytes *= 8) {
+		add("pingPong/raw",bytes,pingPongRaw);
+		add("pingPong/NiceMPI",bytes,pingPongNiceMPI);
+		add("bandwidth/raw",bytes,bandwidthRaw,window);
+		add("bandwidth/NiceMPI",bytes,bandwidthNiceMPI,window);
+		add("broadcast/raw",bytes,broadcastRaw);
+		add("broadcast/NiceMPI",bytes,broadcastNiceMPI);
+		add("allGather/raw",bytes,allGatherRaw);
+		add("allGather/NiceMPI",bytes,allGatherNiceMPI);
+		add("varyingAllGather/raw",bytes,varyingAllGatherRaw);
+		add("varyingAllGather/NiceMPI",bytes,varyingAllGatherNiceMPI);
+	}
+	add("requestPool/raw",sizeof(double),requestPoolRaw,2*window);
+	add("requestPool/NiceMPI",sizeof(double),requestPoolNiceMPI,2*window);
+
+	benchmark::Initialize(&argc,argv);
+	if(mpiWorld().rank() == 0) benchmark::RunSpecifiedBenchmarks();
+	else {
+		NullReporter display, file;
+		benchmark::RunSpecifiedBenchmarks(&display,&file);
+	}
+	benchmark::Shutdown();
+	return 0;
+}
@@ -20,7 +20,15 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE. */
 
+#include <algorithm> // std::equal, std::is_sorted, std::max
+#include <array>
 #include <chrono> // std::chrono::microseconds
+#include <functional> // std::bit_and, std::logical_or
+#include <map>
+#include <memory> // std::unique_ptr
+#include <numeric> // std::accumulate, std::iota
+#include <stdexcept> // std::runtime_error
+#include <string>
 #include <thread> // std::this_thread::sleep_for;
 #include <utility> // std::move
 #include <vector>
@@ -37,6 +45,11 @@ public:
 		double theDouble;
 		char theChar;
 	};
+	struct PODtypeSum {
+		PODtype operator()(const PODtype& a, const PODtype& b) const {
+			return PODtype{a.theInt + b.theInt, a.theDouble + b.theDouble, a.theChar};
+		}
+	};
 
 	bool areCongruentMPI(const MPI_Comm &a, const MPI_Comm &b) const {
 		int result;
@@ -54,6 +67,37 @@ public:
 		result.theInt = rank*2;
 		return result;
 	}
+	int createAllToAllValue(int from, int to) const {
+		return 100*from + to;
+	}
+	int createVaryingAllToAllCount(int from, int to) const {
+		return (from + to) % 3;
+	}
+	std::vector<int> createRange(int count, int first) const {
+		std::vector<int> result(count);
+		std::iota(result.begin(), result.end(), first);
+		return result;
+	}
+	std::vector<int> createVaryingAllToAllData(const std::vector<int>& sendCounts) const {
+		std::vector<int> result;
+		for(int i = 0; i < world.size(); ++i) result.insert(result.end(),sendCounts[i],createAllToAllValue(world.rank(),i));
+		return result;
+	}
+	std::vector<int> createVaryingAllToAllSendCounts() const {
+		std::vector<int> result(world.size());
+		for(int i = 0; i < world.size(); ++i) result[i] = createVaryingAllToAllCount(world.rank(),i);
+		return result;
+	}
+	void expectVaryingAllToAll(const std::vector<int>& received) const {
+		std::size_t index = 0;
+		for(int from = 0; from < world.size(); ++from) {
+			for(int i = 0; i < createVaryingAllToAllCount(from,world.rank()); ++i) {
+				ASSERT_LT(index,received.size());
+				EXPECT_EQ(createAllToAllValue(from,world.rank()),received[index++]);
+			}
+		}
+		EXPECT_EQ(index,received.size());
+	}
 	void expectGathered(const std::vector<PODtype>& gathered) {
 		ASSERT_EQ(mpiWorld().size(),gathered.size());
 		for(int i=0; i<mpiWorld().size(); ++i) {
@@ -120,6 +164,24 @@ public:
 		else EXPECT_EQ(0,gathered.size());
 	}
 	template<class CollectionType>
+	void testAllReduceCollection() {
+		const CollectionType data = {{ mpiWorld().rank(), 2*mpiWorld().rank() }};
+		const CollectionType results = mpiWorld().allReduce(data);
+		EXPECT_EQ(2,results.size());
+		EXPECT_EQ(sumOfRanks(),results[0]);
+		EXPECT_EQ(2*sumOfRanks(),results[1]);
+	}
+	template<class CollectionType>
+	void testReduceCollection() {
+		const CollectionType data = {{ mpiWorld().rank(), 2*mpiWorld().rank() }};
+		const CollectionType results = mpiWorld().reduce(sourceIndex, data);
+		if(mpiWorld().rank() == sourceIndex) {
+			ASSERT_EQ(2,results.size());
+			EXPECT_EQ(sumOfRanks(),results[0]);
+			EXPECT_EQ(2*sumOfRanks(),results[1]);
+		}
+	}
+	template<class CollectionType>
 	void testSendAndReceiveCollection() {
 		if(sourceIndex == destinationIndex) return;
 		if(mpiWorld().rank() == sourceIndex) {
@@ -134,6 +196,10 @@ public:
 		}
 	}
 
+	int sumOfRanks() const {
+		return world.size()*(world.size()-1)/2;
+	}
+
 	const Communicator world;
 	const int sourceIndex = 0;
 	const int destinationIndex = world.size() -1;
@@ -171,6 +237,107 @@ TEST_F(NiceMPItests, size) {
 	MPI_Comm_size(MPI_COMM_WORLD, &size);
 	EXPECT_EQ(size,world.size());
 }
+TEST_F(NiceMPItests, splitWithUndefinedColor) {
+	const Communicator splitted = world.split(MPI_UNDEFINED,0);
+	EXPECT_EQ(MPI_COMM_NULL,splitted.get());
+	EXPECT_EQ(0,splitted.size());
+}
+TEST_F(NiceMPItests, splitShared) {
+	Communicator node = world.splitShared();
+	EXPECT_GE(node.size(),1);
+	EXPECT_LE(node.size(),world.size());
+	const std::vector<int> worldRanks = node.allGather(world.rank());
+	EXPECT_TRUE(std::is_sorted(worldRanks.begin(),worldRanks.end()));
+}
+TEST_F(NiceMPItests, splitNodeLeaders) {
+	Communicator node = world.splitShared();
+	Communicator leaders = world.splitNodeLeaders();
+	if(node.rank() == 0) {
+		EXPECT_NE(MPI_COMM_NULL,leaders.get());
+		EXPECT_EQ(world.size(),leaders.allReduce(node.size()));
+	}
+	else {
+		EXPECT_EQ(MPI_COMM_NULL,leaders.get());
+	}
+}
+TEST_F(NiceMPItests, topology) {
+	EXPECT_EQ(MPI_UNDEFINED, mpiWorld().topology());
+}
+TEST_F(NiceMPItests, cartesian) {
+	const Communicator ring = world.cartesian({world.size()},{true},false);
+	EXPECT_EQ(MPI_CART,ring.topology());
+	EXPECT_EQ(std::vector<int>{world.rank()},ring.coordinates());
+	EXPECT_EQ(world.rank(),ring.rankOf({world.rank()}));
+	const Shift neighbors = ring.shift(0);
+	EXPECT_EQ((world.rank() + world.size() - 1) % world.size(),neighbors.source);
+	EXPECT_EQ((world.rank() + 1) % world.size(),neighbors.destination);
+	EXPECT_EQ((std::vector<int>{neighbors.source,neighbors.destination}),ring.neighborSources());
+	EXPECT_EQ(ring.neighborSources(),ring.neighborDestinations());
+}
+TEST_F(NiceMPItests, cartesianBorder) {
+	const Communicator line = world.cartesian({world.size()},{false});
+	const Shift neighbors = line.shift(0);
+	if(line.rank() == 0) {
+		EXPECT_EQ(MPI_PROC_NULL,neighbors.source);
+	}
+	if(line.rank() == line.size() - 1) {
+		EXPECT_EQ(MPI_PROC_NULL,neighbors.destination);
+	}
+}
+TEST_F(NiceMPItests, cartesianWithoutEveryProcess) {
+	const Communicator single = world.cartesian({1},{false});
+	if(world.rank() == 0) {
+		EXPECT_EQ(1,single.size());
+	}
+	else {
+		EXPECT_EQ(MPI_COMM_NULL,single.get());
+	}
+}
+TEST_F(NiceMPItests, neighborAllGatherCartesian) {
+	Communicator line = world.cartesian({world.size()},{false},false);
+	const int rank = line.rank();
+	const std::vector<int> expected{rank > 0 ? rank : 0, rank < line.size() - 1 ? rank + 2 : 0};
+	EXPECT_EQ(expected,line.neighborAllGather(rank + 1));
+	auto request = line.asyncNeighborAllGather(std::vector<int>{rank + 1});
+	request.wait();
+	EXPECT_EQ(expected,request.take());
+}
+TEST_F(NiceMPItests, neighborAllToAllCartesian) {
+	Communicator ring = world.cartesian({world.size()},{true},false);
+	const Shift neighbors = ring.shift(0);
+	const std::vector<int> toSend{10*ring.rank(), 10*ring.rank() + 1};
+	const std::vector<int> expected{10*neighbors.source + 1, 10*neighbors.destination};
+	EXPECT_EQ(expected,ring.neighborAllToAll(toSend));
+}
+TEST_F(NiceMPItests, asyncNeighborAllToAllCartesian) {
+	Communicator line = world.cartesian({world.size()},{false},false); // Without duplicated neighbors
+	const int rank = line.rank();
+	const std::vector<int> toSend{10*rank + 1, 10*rank + 2};
+	const std::vector<int> expected{rank > 0 ? 10*(rank-1) + 2 : 0, rank < line.size() - 1 ? 10*(rank+1) + 1 : 0};
+	auto request = line.asyncNeighborAllToAll(toSend);
+	request.wait();
+	EXPECT_EQ(expected,request.take());
+}
+TEST_F(NiceMPItests, distGraph) {
+	const int previous = (world.rank() + world.size() - 1) % world.size();
+	const int next = (world.rank() + 1) % world.size();
+	Communicator graph = world.distGraph({previous},{next},false);
+	EXPECT_EQ(MPI_DIST_GRAPH,graph.topology());
+	EXPECT_EQ(std::vector<int>{previous},graph.neighborSources());
+	EXPECT_EQ(std::vector<int>{next},graph.neighborDestinations());
+	EXPECT_EQ(std::vector<int>{previous},graph.neighborAllGather(world.rank()));
+}
+TEST_F(NiceMPItests, neighborVaryingAllToAll) {
+	const int previous = (world.rank() + world.size() - 1) % world.size();
+	const int next = (world.rank() + 1) % world.size();
+	Communicator graph = world.distGraph({previous},{next},false);
+	const std::vector<int> toSend(world.rank() + 1,world.rank());
+	const std::vector<int> expected(previous + 1,previous);
+	EXPECT_EQ(expected,graph.neighborVaryingAllToAll(toSend,{world.rank() + 1},{previous + 1}));
+	auto request = graph.asyncNeighborVaryingAllToAll(toSend,{world.rank() + 1},{previous + 1});
+	request.wait();
+	EXPECT_EQ(expected,request.take());
+}
 TEST_F(NiceMPItests, split) {
 	const int color = world.rank() % 2;
 	const int key = world.rank();
@@ -203,6 +370,36 @@ TEST_F(NiceMPItests, movedProxiesAreProxies) {
 	const Communicator moved(std::move(proxy));
 	EXPECT_TRUE( areIdentical(world,moved) );
 }
+TEST_F(NiceMPItests, sharedIsIdentical) {
+	EXPECT_TRUE( areIdentical(world,world.shared()) );
+}
+TEST_F(NiceMPItests, sharedOutlivesTheOriginal) {
+	std::unique_ptr<Communicator> original(new Communicator);
+	const Communicator shared = original->shared();
+	original.reset();
+	EXPECT_EQ(sumOfRanks(), shared.shared().allReduce(shared.rank()));
+}
+TEST_F(NiceMPItests, sharedProxiesAreProxies) {
+	const Communicator shared = createProxy(world.get()).shared();
+	EXPECT_TRUE( areIdentical(world,shared) );
+}
+TEST_F(NiceMPItests, duplicateIsCongruent) {
+	const Communicator duplicated = world.duplicate();
+	EXPECT_TRUE( areCongruent(world,duplicated) );
+	EXPECT_FALSE( areIdentical(world,duplicated) );
+}
+TEST_F(NiceMPItests, asyncDuplicate) {
+	CommunicatorRequest r = world.asyncDuplicate();
+	const Communicator duplicated = r.take();
+	EXPECT_TRUE( areCongruent(world,duplicated) );
+	EXPECT_FALSE( areIdentical(world,duplicated) );
+	EXPECT_EQ(world.rank(),duplicated.rank());
+}
+TEST_F(NiceMPItests, asyncDuplicateNotTaken) {
+	CommunicatorRequest r = world.asyncDuplicate();
+	while(!r.isCompleted()) std::this_thread::sleep_for(std::chrono::microseconds{});
+	SUCCEED();
+}
 TEST_F(NiceMPItests, mpiWorld) {
 	EXPECT_TRUE( areIdentical(createProxy(MPI_COMM_WORLD),mpiWorld()) );
 	EXPECT_TRUE( areIdentical(mpiWorld(),mpiWorld()) );
@@ -238,6 +435,14 @@ TEST_F(NiceMPItests, sendAndReceiveWithTag) {
 		EXPECT_EQ(toSend,mpiWorld().receive<unsigned char>(sourceIndex,MPI_ANY_TAG));
 	}
 }
+TEST_F(NiceMPItests, sendAndReceiveNativeCollection) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<double> toSend = { 1.5, 2.5, 3.5 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(toSend,mpiWorld().receive<std::vector<double>>(toSend.size(),sourceIndex));
+	}
+}
 TEST_F(NiceMPItests, broadcast) {
 	PODtype data;
 	if(mpiWorld().rank() == sourceIndex) data = podTypeInstance;
@@ -267,6 +472,63 @@ TEST_F(NiceMPItests, allGather) {
 	const PODtype myData = createPODtypeForRank(mpiWorld().rank());
 	expectGathered(mpiWorld().allGather(myData));
 }
+TEST_F(NiceMPItests, allReduce) {
+	EXPECT_EQ(sumOfRanks(), mpiWorld().allReduce(mpiWorld().rank()));
+}
+TEST_F(NiceMPItests, allReduceMaximum) {
+	const double expected = mpiWorld().size() - 1;
+	EXPECT_NEAR(expected, mpiWorld().allReduce(1.0*mpiWorld().rank(), Maximum<double>{}), defaultTolerance);
+}
+TEST_F(NiceMPItests, allReduceMPIop) {
+	EXPECT_EQ(0, mpiWorld().allReduce(mpiWorld().rank(), MPI_MIN));
+}
+TEST_F(NiceMPItests, allReduceBoolAndCharacters) {
+	EXPECT_TRUE(mpiWorld().allReduce(true));
+	EXPECT_TRUE(mpiWorld().allReduce(true, std::bit_and<bool>{}));
+	EXPECT_TRUE(mpiWorld().allReduce(mpiWorld().rank() == 0, std::logical_or<bool>{}));
+	EXPECT_EQ(static_cast<char>(mpiWorld().size()), mpiWorld().allReduce(static_cast<char>(1)));
+	const wchar_t rank = static_cast<wchar_t>(mpiWorld().rank());
+	EXPECT_EQ(static_cast<wchar_t>(mpiWorld().size()-1), mpiWorld().allReduce(rank, Maximum<wchar_t>{}));
+}
+TEST_F(NiceMPItests, allReduceUserDefinedOperator) {
+	const PODtype reduced = mpiWorld().allReduce(createPODtypeForRank(mpiWorld().rank()), PODtypeSum{});
+	PODtype expected = podTypeInstance;
+	expected.theInt = 2*sumOfRanks();
+	expected.theDouble = podTypeInstance.theDouble*mpiWorld().size();
+	expectNear(expected, reduced, defaultTolerance);
+}
+TEST_F(NiceMPItests, reduce) {
+	const int reduced = mpiWorld().reduce(sourceIndex, mpiWorld().rank());
+	if(mpiWorld().rank() == sourceIndex) {
+		EXPECT_EQ(sumOfRanks(), reduced);
+	}
+}
+TEST_F(NiceMPItests, reduceVectorIsEmptyOnOtherProcesses) {
+	const std::vector<int> reduced = mpiWorld().reduce(sourceIndex, std::vector<int>{ mpiWorld().rank() });
+	if(mpiWorld().rank() != sourceIndex) {
+		EXPECT_EQ(0,reduced.size());
+	}
+}
+TEST_F(NiceMPItests, scan) {
+	const int rank = mpiWorld().rank();
+	EXPECT_EQ(rank*(rank+1)/2, mpiWorld().scan(rank));
+}
+TEST_F(NiceMPItests, exScan) {
+	const int rank = mpiWorld().rank();
+	const int scanned = mpiWorld().exScan(rank);
+	if(rank != 0) {
+		EXPECT_EQ(rank*(rank-1)/2, scanned);
+	}
+}
+TEST_F(NiceMPItests, exScanVector) {
+	const int rank = mpiWorld().rank();
+	const std::vector<int> scanned = mpiWorld().exScan(std::vector<int>{ rank, 1 }, std::multiplies<int>{});
+	ASSERT_EQ(2,scanned.size());
+	if(rank != 0) {
+		EXPECT_EQ(0, scanned[0]);
+		EXPECT_EQ(1, scanned[1]);
+	}
+}
 
 
 TEST_F(NiceMPItests, varyingScatterNothingSent) {
@@ -363,6 +625,82 @@ TEST_F(NiceMPItests, varyingAllGatherWithDisplacements) {
 		expectNear(createPODtypeForRank(expectedOrder[i]), gathered[i], defaultTolerance);
 	}
 }
+TEST_F(NiceMPItests, receiveInSpan) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<double> toSend = { 1.5, 2.5, 3.5 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		std::vector<double> results(toSend.size());
+		mpiWorld().receive(makeSpan(results),sourceIndex);
+		EXPECT_EQ(toSend,results);
+	}
+}
+TEST_F(NiceMPItests, broadcastSpan) {
+	std::array<PODtype,2> data;
+	if(mpiWorld().rank() == sourceIndex) data = {{ podTypeInstance, podTypeInstance }};
+	mpiWorld().broadcast(sourceIndex, makeSpan(data));
+	for(auto&& x: data) expectNear(podTypeInstance, x, defaultTolerance);
+}
+TEST_F(NiceMPItests, scatterInSpan) {
+	std::vector<PODtype> scattered(1);
+	mpiWorld().scatter(sourceIndex,defaultCollection,makeSpan(scattered));
+	expectNear(createPODtypeForRank(mpiWorld().rank()), scattered[0], defaultTolerance);
+}
+TEST_F(NiceMPItests, gatherInSpan) {
+	std::vector<PODtype> gathered;
+	if(mpiWorld().rank()==sourceIndex) gathered.resize(mpiWorld().size());
+	mpiWorld().gather(sourceIndex, createPODtypeForRank(mpiWorld().rank()), makeSpan(gathered));
+	if(mpiWorld().rank()==sourceIndex) expectGathered(gathered);
+}
+TEST_F(NiceMPItests, gatherInPlace) {
+	const int rank = mpiWorld().rank();
+	std::vector<PODtype> data(1,createPODtypeForRank(rank));
+	if(rank==sourceIndex) {
+		data.resize(mpiWorld().size());
+		data[sourceIndex] = createPODtypeForRank(rank);
+	}
+	mpiWorld().gatherInPlace(sourceIndex, makeSpan(data));
+	if(rank==sourceIndex) expectGathered(data);
+}
+TEST_F(NiceMPItests, allGatherInSpan) {
+	std::vector<PODtype> gathered(mpiWorld().size());
+	mpiWorld().allGather(createPODtypeForRank(mpiWorld().rank()), makeSpan(gathered));
+	expectGathered(gathered);
+}
+TEST_F(NiceMPItests, allGatherCollectionInSpan) {
+	const PODtype x = createPODtypeForRank(mpiWorld().rank());
+	const std::vector<PODtype> toSend = { x, x };
+	std::vector<PODtype> gathered(mpiWorld().size()*toSend.size());
+	mpiWorld().allGather(toSend, makeSpan(gathered));
+	expectGatheredCollection(gathered,toSend.size());
+}
+TEST_F(NiceMPItests, allGatherInPlace) {
+	std::vector<PODtype> data(mpiWorld().size());
+	data[mpiWorld().rank()] = createPODtypeForRank(mpiWorld().rank());
+	mpiWorld().allGatherInPlace(makeSpan(data));
+	expectGathered(data);
+}
+TEST_F(NiceMPItests, varyingScatterInSpan) {
+	const std::vector<int> sendCounts(mpiWorld().size(),1);
+	std::vector<PODtype> scattered(1);
+	mpiWorld().varyingScatter(sourceIndex,defaultCollection,makeSpan(scattered),sendCounts);
+	expectNear(createPODtypeForRank(mpiWorld().rank()), scattered[0], defaultTolerance);
+}
+TEST_F(NiceMPItests, varyingGatherInSpan) {
+	const std::vector<PODtype> data = { createPODtypeForRank(mpiWorld().rank()) };
+	const std::vector<int> receiveCounts(mpiWorld().size(),1);
+	std::vector<PODtype> gathered;
+	if(mpiWorld().rank()==sourceIndex) gathered.resize(mpiWorld().size());
+	mpiWorld().varyingGather(sourceIndex,data,makeSpan(gathered),receiveCounts);
+	if(mpiWorld().rank()==sourceIndex) expectGathered(gathered);
+}
+TEST_F(NiceMPItests, varyingAllGatherInSpan) {
+	const std::vector<PODtype> data = { createPODtypeForRank(mpiWorld().rank()) };
+	const std::vector<int> receiveCounts(mpiWorld().size(),1);
+	std::vector<PODtype> gathered(mpiWorld().size());
+	mpiWorld().varyingAllGather(data,makeSpan(gathered),receiveCounts);
+	expectGathered(gathered);
+}
 
 
 TEST_F(NiceMPItests, asyncSendDoNotBlock) {
@@ -418,6 +756,703 @@ TEST_F(NiceMPItests, asyncSendAndReceiveAndTest) {
 		expectNear(podTypeInstance, data[0], defaultTolerance);
 	}
 }
+TEST_F(NiceMPItests, asyncSendFireAndForget) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 5;
+	if(mpiWorld().rank() == sourceIndex) {
+		PODtype toSend = podTypeInstance;
+		mpiWorld().asyncSend(toSend,destinationIndex,tag);
+		toSend.theInt = 0;
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		expectNear(podTypeInstance, mpiWorld().receive<PODtype>(sourceIndex,tag), defaultTolerance);
+	}
+}
+TEST_F(NiceMPItests, asyncSendOwnsMovedCollection) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 6;
+	const std::vector<double> expected = { 1.5, 2.5, 3.5 };
+	if(mpiWorld().rank() == sourceIndex) {
+		std::vector<double> toSend = expected;
+		SendRequest r = mpiWorld().asyncSend(std::move(toSend),destinationIndex,tag);
+		EXPECT_TRUE(toSend.empty());
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(expected,mpiWorld().receive<std::vector<double>>(expected.size(),sourceIndex,tag));
+	}
+}
+TEST_F(NiceMPItests, asyncSendCopiesLvalueCollection) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 7;
+	const std::vector<double> expected = { 1.5, 2.5, 3.5 };
+	if(mpiWorld().rank() == sourceIndex) {
+		std::vector<double> toSend = expected;
+		mpiWorld().asyncSend(toSend,destinationIndex,tag);
+		toSend.assign(toSend.size(),0.0);
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(expected,mpiWorld().receive<std::vector<double>>(expected.size(),sourceIndex,tag));
+	}
+}
+TEST_F(NiceMPItests, asyncSendBorrowedSpan) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 8;
+	const std::vector<double> toSend = { 1.5, 2.5, 3.5 };
+	if(mpiWorld().rank() == sourceIndex) {
+		SendRequest r = mpiWorld().asyncSend(makeSpan(toSend),destinationIndex,tag);
+		r.wait();
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(toSend,mpiWorld().receive<std::vector<double>>(toSend.size(),sourceIndex,tag));
+	}
+}
+TEST_F(NiceMPItests, sendStridedColumn) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<int> matrix = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(stridedView(matrix.data()+1,3,1,3),destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		const std::vector<int> expected = { 2, 5, 8 };
+		EXPECT_EQ(expected,mpiWorld().receive<std::vector<int>>(3,sourceIndex));
+	}
+}
+TEST_F(NiceMPItests, receiveInSubarray) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<int> toSend = { 1, 2, 3, 4 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		std::vector<int> grid(16);
+		mpiWorld().receive(subarrayView(grid.data(),{4,4},{2,2},{1,2}),sourceIndex);
+		const std::vector<int> expected = { 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 3, 4, 0, 0, 0, 0 };
+		EXPECT_EQ(expected,grid);
+	}
+}
+TEST_F(NiceMPItests, asyncSendAndReceiveStridedViews) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 26;
+	const std::vector<double> toSend = { 1.5, 0, 2.5, 0, 3.5, 0 };
+	if(mpiWorld().rank() == sourceIndex) {
+		SendRequest r = mpiWorld().asyncSend(stridedView(toSend.data(),3,1,2),destinationIndex,tag);
+		r.wait();
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		std::vector<double> received(9);
+		SendRequest r = mpiWorld().asyncReceive(stridedView(received.data(),3,1,3),sourceIndex,tag);
+		r.wait();
+		const std::vector<double> expected = { 1.5, 0, 0, 2.5, 0, 0, 3.5, 0, 0 };
+		EXPECT_EQ(expected,received);
+	}
+}
+TEST_F(NiceMPItests, unmatchedStridedReceiveIsCancelledWhenDestroyed) {
+	std::vector<int> grid(16);
+	{
+		SendRequest r = mpiSelf().asyncReceive(stridedView(grid.data(),4,1,4),0,99);
+	}
+	DetachedRequests::completeAll(); // Would block forever if the receive was not cancellable
+	EXPECT_EQ(0,DetachedRequests::pendingCount());
+}
+TEST_F(NiceMPItests, persistentStridedViews) {
+	const int tag = 27;
+	const int next = (mpiWorld().rank() + 1) % mpiWorld().size();
+	const int previous = (mpiWorld().rank() + mpiWorld().size() - 1) % mpiWorld().size();
+	std::vector<int> toSend(4), received(4);
+	PersistentRequest send = mpiWorld().makePersistentSend(stridedView(toSend.data(),2,1,2),next,tag);
+	PersistentRequest receive = mpiWorld().makePersistentReceive(stridedView(received.data()+1,2,1,2),previous,
+		tag);
+	for(int iteration = 0; iteration < 3; ++iteration) {
+		toSend[0] = mpiWorld().rank();
+		toSend[2] = iteration;
+		receive.start();
+		send.start();
+		send.wait();
+		receive.wait();
+		EXPECT_EQ(previous,received[1]);
+		EXPECT_EQ(iteration,received[3]);
+	}
+}
+TEST_F(NiceMPItests, sendTriviallyCopyableType) {
+	struct WithInitializers {
+		int first = 1;
+		double second = 2.5;
+	};
+	if(sourceIndex == destinationIndex) return;
+	WithInitializers toSend;
+	toSend.first = 3;
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		const WithInitializers received = mpiWorld().receive<WithInitializers>(sourceIndex);
+		EXPECT_EQ(3,received.first);
+		EXPECT_EQ(2.5,received.second);
+	}
+}
+TEST_F(NiceMPItests, isTriviallyCommunicable) {
+	struct WithConstructor {
+		WithConstructor(): x(1) {}
+		int x;
+	};
+	const bool withConstructor = is_trivially_communicable<WithConstructor>::value;
+	const bool span = is_trivially_communicable<Span<int>>::value;
+	const bool view = is_trivially_communicable<StridedView<int>>::value;
+	const bool vector = is_trivially_communicable<std::vector<int>>::value;
+	EXPECT_TRUE(withConstructor);
+	EXPECT_FALSE(span);
+	EXPECT_FALSE(view);
+	EXPECT_FALSE(vector);
+}
+TEST_F(NiceMPItests, receiveInUninitializedVector) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<int> toSend = { 1, 2, 3 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		const UninitializedVector<int> received = mpiWorld().receive<UninitializedVector<int>>(3,sourceIndex);
+		EXPECT_TRUE(std::equal(toSend.begin(),toSend.end(),received.begin()));
+	}
+}
+TEST_F(NiceMPItests, asyncReceivePooledVector) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 29;
+	const std::vector<int> toSend = { 1, 2, 3 };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex,tag);
+	if(mpiWorld().rank() == destinationIndex) {
+		ReceiveRequest<PooledVector<int>> r = mpiWorld().asyncReceive<PooledVector<int>>(3,sourceIndex,tag);
+		r.wait();
+		const PooledVector<int> received = r.take();
+		EXPECT_TRUE(std::equal(toSend.begin(),toSend.end(),received.begin()));
+	}
+}
+TEST_F(NiceMPItests, sendAndReceiveSerialized) {
+	if(sourceIndex == destinationIndex) return;
+	const std::vector<std::string> toSend = { "one", "two", "three" };
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(toSend,destinationIndex);
+	if(mpiWorld().rank() == destinationIndex) {
+		EXPECT_EQ(toSend,mpiWorld().receive<std::vector<std::string>>(sourceIndex));
+	}
+}
+TEST_F(NiceMPItests, asyncSendSerialized) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 28;
+	std::map<int,std::string> toSend = { { 1, "one" }, { 2, "two" } };
+	if(mpiWorld().rank() == sourceIndex) {
+		SendRequest r = mpiWorld().asyncSend(toSend,destinationIndex,tag);
+		toSend.clear();
+		r.wait();
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		const std::map<int,std::string> expected = { { 1, "one" }, { 2, "two" } };
+		EXPECT_EQ(expected,(mpiWorld().receive<std::map<int,std::string>>(sourceIndex,tag)));
+	}
+}
+TEST_F(NiceMPItests, broadcastSerialized) {
+	std::vector<std::vector<int>> data;
+	if(mpiWorld().rank() == sourceIndex) data = { { 1, 2 }, {}, { 3 } };
+	const std::vector<std::vector<int>> expected = { { 1, 2 }, {}, { 3 } };
+	EXPECT_EQ(expected,mpiWorld().broadcast(sourceIndex,data));
+}
+TEST_F(NiceMPItests, segmentedBroadcast) {
+	std::vector<int> data;
+	if(mpiWorld().rank() == sourceIndex) {
+		data.resize(1000);
+		for(std::size_t i = 0; i < data.size(); ++i) data[i] = static_cast<int>(i);
+	}
+	std::vector<std::size_t> offsets;
+	std::size_t consumed = 0;
+	const std::vector<int> results = mpiWorld().segmentedBroadcast(sourceIndex,data,64*sizeof(int),
+		[&](std::size_t offset, Span<const int> segment) {
+			offsets.push_back(offset);
+			for(std::size_t i = 0; i < segment.size(); ++i) {
+				if(segment[i] != static_cast<int>(offset+i)) return;
+			}
+			consumed += segment.size();
+		});
+	ASSERT_EQ(1000u,results.size());
+	for(std::size_t i = 0; i < results.size(); ++i) EXPECT_EQ(static_cast<int>(i),results[i]);
+	EXPECT_EQ(1000u,consumed);
+	ASSERT_EQ(16u,offsets.size());
+	for(std::size_t i = 0; i < offsets.size(); ++i) EXPECT_EQ(64*i,offsets[i]);
+}
+TEST_F(NiceMPItests, segmentedBroadcastRefillsSegmentsInFlight) {
+	std::vector<int> data;
+	if(mpiWorld().rank() == sourceIndex) data.assign(60,7);
+	std::vector<std::size_t> offsets;
+	const std::vector<int> results = mpiWorld().segmentedBroadcast(sourceIndex,data,8*sizeof(int),
+		[&](std::size_t offset, Span<const int>) { offsets.push_back(offset); });
+	EXPECT_EQ(std::vector<int>(60,7),results);
+	EXPECT_EQ((std::vector<std::size_t>{0,8,16,24,32,40,48,56}),offsets);
+}
+TEST_F(NiceMPItests, segmentedBroadcastCompletesWhenConsumerThrows) {
+	std::vector<int> data;
+	if(mpiWorld().rank() == sourceIndex) data.assign(60,7);
+	const bool throws = mpiWorld().rank() == sourceIndex;
+	std::size_t calls = 0;
+	const auto consume = [&](std::size_t, Span<const int>) {
+		++calls;
+		if(throws) throw std::runtime_error("consumer");
+	};
+	if(throws) EXPECT_THROW(mpiWorld().segmentedBroadcast(sourceIndex,data,8*sizeof(int),consume),std::runtime_error);
+	else EXPECT_EQ(std::vector<int>(60,7),mpiWorld().segmentedBroadcast(sourceIndex,data,8*sizeof(int),consume));
+	EXPECT_EQ(throws ? 1u : 8u,calls);
+	EXPECT_EQ(sumOfRanks(),mpiWorld().allReduce(mpiWorld().rank())); // No collective left behind
+}
+TEST_F(NiceMPItests, segmentedBroadcastInFirstSegment) {
+	std::vector<double> data;
+	if(mpiWorld().rank() == sourceIndex) data = { 1.5, 2.5 };
+	const std::vector<double> expected = { 1.5, 2.5 };
+	EXPECT_EQ(expected,mpiWorld().segmentedBroadcast(sourceIndex,data));
+}
+TEST_F(NiceMPItests, segmentedBroadcastEmpty) {
+	int calls = 0;
+	const std::vector<int> results = mpiWorld().segmentedBroadcast(sourceIndex,std::vector<int>{},16,
+		[&](std::size_t, Span<const int> segment) {
+			EXPECT_EQ(0u,segment.size());
+			++calls;
+		});
+	EXPECT_TRUE(results.empty());
+	EXPECT_EQ(1,calls);
+}
+TEST_F(NiceMPItests, sendRequestCanBeMoved) {
+	if(sourceIndex == destinationIndex) return;
+	const int tag = 9;
+	if(mpiWorld().rank() == sourceIndex) {
+		SendRequest r = mpiWorld().asyncSend(podTypeInstance,destinationIndex,tag);
+		SendRequest moved(std::move(r));
+		r = mpiWorld().asyncSend(podTypeInstance,destinationIndex,tag);
+		moved.wait();
+		r.wait();
+	}
+	if(mpiWorld().rank() == destinationIndex) {
+		for(auto&& i: {0,1}) {
+			UNUSED(i);
+			expectNear(podTypeInstance, mpiWorld().receive<PODtype>(sourceIndex,tag), defaultTolerance);
+		}
+	}
+}
+TEST_F(NiceMPItests, requestSetWaitAll) {
+	const int tag = 12;
+	RequestSet requests;
+	std::vector<std::size_t> receives;
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		requests.add(mpiWorld().asyncSend(createPODtypeForRank(mpiWorld().rank()),i,tag));
+		receives.push_back(requests.add(mpiWorld().asyncReceive<PODtype>(i,tag)));
+	}
+	EXPECT_EQ(2*mpiWorld().size(),requests.size());
+	requests.waitAll();
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		const std::vector<PODtype> data = requests.take<PODtype>(receives[i]);
+		ASSERT_EQ(1,data.size());
+		expectNear(createPODtypeForRank(i), data[0], defaultTolerance);
+	}
+}
+TEST_F(NiceMPItests, requestSetWaitAny) {
+	const int tag = 13;
+	RequestSet requests;
+	requests.add(mpiWorld().asyncSend(podTypeInstance,mpiWorld().rank(),tag));
+	const std::size_t receive = requests.add(mpiWorld().asyncReceive<std::vector<PODtype>>(1,mpiWorld().rank(),tag));
+	std::size_t completed = 0;
+	for(std::size_t index = requests.waitAny(); index != requests.size(); index = requests.waitAny()) ++completed;
+	EXPECT_EQ(2,completed);
+	const std::vector<PODtype> data = requests.take<std::vector<PODtype>>(receive);
+	ASSERT_EQ(1,data.size());
+	expectNear(podTypeInstance, data[0], defaultTolerance);
+}
+TEST_F(NiceMPItests, requestSetWaitSomeReportsEachRequestOnce) {
+	const int tag = 14;
+	RequestSet requests;
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		requests.add(mpiWorld().asyncSend(mpiWorld().rank(),i,tag));
+		requests.add(mpiWorld().asyncReceive<int>(i,tag));
+	}
+	std::vector<int> timesCompleted(requests.size());
+	for(auto completed = requests.waitSome(); !completed.empty(); completed = requests.waitSome()) {
+		for(auto&& i: completed) ++timesCompleted[i];
+	}
+	for(auto&& x: timesCompleted) EXPECT_EQ(1,x);
+}
+TEST_F(NiceMPItests, requestSetTestSome) {
+	const int tag = 15;
+	RequestSet requests;
+	const std::size_t receive = requests.add(mpiWorld().asyncReceive<int>(mpiWorld().rank(),tag));
+	EXPECT_TRUE(requests.testSome().empty());
+	mpiWorld().send(42,mpiWorld().rank(),tag);
+	std::vector<std::size_t> completed;
+	while(completed.empty()) completed = requests.testSome();
+	ASSERT_EQ(1,completed.size());
+	EXPECT_EQ(receive,completed[0]);
+	EXPECT_EQ(42,requests.take<int>(receive).at(0));
+}
+TEST_F(NiceMPItests, persistentSendAndReceive) {
+	const int tag = 16;
+	const int next = (mpiWorld().rank() + 1) % mpiWorld().size();
+	const int previous = (mpiWorld().rank() + mpiWorld().size() - 1) % mpiWorld().size();
+	std::vector<int> toSend(2), received(2);
+	PersistentRequest send = mpiWorld().makePersistentSend(makeSpan(toSend),next,tag);
+	PersistentRequest receive = mpiWorld().makePersistentReceive(makeSpan(received),previous,tag);
+	EXPECT_TRUE(send.isCompleted());
+	for(int iteration = 0; iteration < 3; ++iteration) {
+		toSend[0] = mpiWorld().rank();
+		toSend[1] = iteration;
+		receive.start();
+		send.start();
+		send.wait();
+		receive.wait();
+		EXPECT_EQ(previous,received[0]);
+		EXPECT_EQ(iteration,received[1]);
+	}
+}
+TEST_F(NiceMPItests, requestSetStartAll) {
+	const int tag = 17;
+	const int next = (mpiWorld().rank() + 1) % mpiWorld().size();
+	const int previous = (mpiWorld().rank() + mpiWorld().size() - 1) % mpiWorld().size();
+	int toSend = 0, received = -1;
+	RequestSet requests;
+	requests.add(mpiWorld().makePersistentReceive(makeSpan(&received,1),previous,tag));
+	requests.add(mpiWorld().makePersistentSend(makeSpan(&toSend,1),next,tag));
+	for(int iteration = 0; iteration < 3; ++iteration) {
+		toSend = iteration*mpiWorld().rank();
+		requests.startAll();
+		requests.waitAll();
+		EXPECT_EQ(iteration*previous,received);
+	}
+	EXPECT_EQ(requests.size(),requests.waitAny());
+}
+TEST_F(NiceMPItests, requestSetStartsOnlyPersistentRequests) {
+	const int tag = 18;
+	int received = -1;
+	RequestSet requests;
+	requests.add(mpiWorld().makePersistentReceive(makeSpan(&received,1),mpiWorld().rank(),tag));
+	requests.add(mpiWorld().asyncSend(42,mpiWorld().rank(),tag));
+	requests.startAll();
+	requests.waitAll();
+	EXPECT_EQ(42,received);
+}
+TEST_F(NiceMPItests, asyncAllGather) {
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncAllGather(createPODtypeForRank(mpiWorld().rank()));
+	r.wait();
+	expectGathered(r.take());
+}
+TEST_F(NiceMPItests, asyncAllGatherVector) {
+	const PODtype x = createPODtypeForRank(mpiWorld().rank());
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncAllGather(std::vector<PODtype>{ x, x });
+	while(!r.isCompleted()) std::this_thread::sleep_for(std::chrono::microseconds{});
+	expectGatheredCollection(r.take(),2);
+}
+TEST_F(NiceMPItests, asyncCollectivesMoveRvalueVectors) {
+	const PODtype x = createPODtypeForRank(mpiWorld().rank());
+	std::vector<PODtype> data{ x, x };
+	ReceiveRequest<std::vector<PODtype>> gathered = mpiWorld().asyncAllGather(std::move(data));
+	EXPECT_TRUE(data.empty());
+	std::vector<int> ranks{ mpiWorld().rank() };
+	ReceiveRequest<std::vector<int>> reduced = mpiWorld().asyncAllReduce(std::move(ranks));
+	EXPECT_TRUE(ranks.empty());
+	std::vector<PODtype> single{ x };
+	ReceiveRequest<std::vector<PODtype>> varying = mpiWorld().asyncVaryingAllGather(std::move(single),
+		std::vector<int>(mpiWorld().size(),1));
+	EXPECT_TRUE(single.empty());
+	gathered.wait();
+	reduced.wait();
+	varying.wait();
+	expectGatheredCollection(gathered.take(),2);
+	EXPECT_EQ(sumOfRanks(),reduced.take().at(0));
+	expectGathered(varying.take());
+}
+TEST_F(NiceMPItests, asyncAllReduce) {
+	ReceiveRequest<int> r = mpiWorld().asyncAllReduce(mpiWorld().rank());
+	r.wait();
+	EXPECT_EQ(sumOfRanks(),r.take().at(0));
+}
+TEST_F(NiceMPItests, asyncAllReduceVectorMaximum) {
+	const std::vector<int> data = { mpiWorld().rank(), -mpiWorld().rank() };
+	ReceiveRequest<std::vector<int>> r = mpiWorld().asyncAllReduce(data, Maximum<int>{});
+	r.wait();
+	const std::vector<int> expected = { mpiWorld().size() - 1, 0 };
+	EXPECT_EQ(expected,r.take());
+}
+TEST_F(NiceMPItests, asyncBroadcast) {
+	PODtype data;
+	if(mpiWorld().rank() == sourceIndex) data = podTypeInstance;
+	ReceiveRequest<PODtype> r = mpiWorld().asyncBroadcast(sourceIndex, data);
+	r.wait();
+	expectNear(podTypeInstance, r.take().at(0), defaultTolerance);
+}
+TEST_F(NiceMPItests, asyncBroadcastVectorInTwoSteps) {
+	std::vector<PODtype> data;
+	if(mpiWorld().rank() == sourceIndex) data.assign(3,podTypeInstance);
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncBroadcast(sourceIndex, data);
+	while(!r.isCompleted()) std::this_thread::sleep_for(std::chrono::microseconds{});
+	const std::vector<PODtype> results = r.take();
+	ASSERT_EQ(3,results.size());
+	for(auto&& x: results) expectNear(podTypeInstance, x, defaultTolerance);
+}
+TEST_F(NiceMPItests, asyncBroadcastArray) {
+	std::array<int,2> data = {{ 0, 0 }};
+	if(mpiWorld().rank() == sourceIndex) data = {{ 4, 2 }};
+	ReceiveRequest<std::array<int,2>> r = mpiWorld().asyncBroadcast(sourceIndex, data);
+	r.wait();
+	const std::vector<int> expected = { 4, 2 };
+	EXPECT_EQ(expected,r.take());
+}
+TEST_F(NiceMPItests, asyncBroadcastInRequestSet) {
+	std::vector<int> data;
+	if(mpiWorld().rank() == sourceIndex) data = { 4, 2 };
+	RequestSet requests;
+	const std::size_t index = requests.add(mpiWorld().asyncBroadcast(sourceIndex, data));
+	EXPECT_EQ(index,requests.waitAny());
+	const std::vector<int> expected = { 4, 2 };
+	EXPECT_EQ(expected,requests.take<std::vector<int>>(index));
+}
+TEST_F(NiceMPItests, asyncBroadcastVectorAllowsOtherCollectives) {
+	std::vector<int> data;
+	if(mpiWorld().rank() == sourceIndex) data = { 4, 2 };
+	ReceiveRequest<std::vector<int>> r = mpiWorld().asyncBroadcast(sourceIndex, data);
+	if(mpiWorld().rank() == sourceIndex) {
+		for(int i = 0; i < 100; ++i) r.isCompleted();
+	}
+	EXPECT_EQ(mpiWorld().size(), mpiWorld().allReduce(1));
+	r.wait();
+	const std::vector<int> expected = { 4, 2 };
+	EXPECT_EQ(expected,r.take());
+}
+TEST_F(NiceMPItests, asyncBroadcastVectorsWaitedInAnyOrder) {
+	std::vector<int> first, second;
+	if(mpiWorld().rank() == sourceIndex) {
+		first = { 1, 2, 3 };
+		second = { 4 };
+	}
+	ReceiveRequest<std::vector<int>> r1 = mpiWorld().asyncBroadcast(sourceIndex, first);
+	ReceiveRequest<std::vector<int>> r2 = mpiWorld().asyncBroadcast(sourceIndex, second);
+	if(mpiWorld().rank() % 2 == 0) {
+		r2.wait();
+		r1.wait();
+	}
+	else {
+		r1.wait();
+		r2.wait();
+	}
+	EXPECT_EQ(std::vector<int>({ 1, 2, 3 }),r1.take());
+	EXPECT_EQ(std::vector<int>({ 4 }),r2.take());
+}
+TEST_F(NiceMPItests, asyncGather) {
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncGather(sourceIndex,
+		createPODtypeForRank(mpiWorld().rank()));
+	r.wait();
+	const std::vector<PODtype> gathered = r.take();
+	if(mpiWorld().rank() == sourceIndex) expectGathered(gathered);
+	else EXPECT_EQ(0,gathered.size());
+}
+TEST_F(NiceMPItests, asyncGatherArray) {
+	const PODtype x = createPODtypeForRank(mpiWorld().rank());
+	const std::array<PODtype,2> toSend = {{ x, x }};
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncGather(sourceIndex, toSend);
+	r.wait();
+	const std::vector<PODtype> gathered = r.take();
+	if(mpiWorld().rank() == sourceIndex) expectGatheredCollection(gathered,2);
+	else EXPECT_EQ(0,gathered.size());
+}
+TEST_F(NiceMPItests, asyncScatter) {
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncScatter(sourceIndex,defaultCollection,1);
+	r.wait();
+	const std::vector<PODtype> scattered = r.take();
+	ASSERT_EQ(1,scattered.size());
+	expectNear(createPODtypeForRank(mpiWorld().rank()), scattered[0], defaultTolerance);
+}
+TEST_F(NiceMPItests, asyncVaryingAllGather) {
+	const std::vector<PODtype> data = { createPODtypeForRank(mpiWorld().rank()) };
+	const std::vector<int> receiveCounts(mpiWorld().size(),1);
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncVaryingAllGather(data,receiveCounts);
+	r.wait();
+	expectGathered(r.take());
+}
+TEST_F(NiceMPItests, asyncVaryingGather) {
+	const std::vector<PODtype> data = { createPODtypeForRank(mpiWorld().rank()) };
+	const std::vector<int> receiveCounts(mpiWorld().size(),1);
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncVaryingGather(sourceIndex,data,receiveCounts);
+	r.wait();
+	const std::vector<PODtype> gathered = r.take();
+	if(mpiWorld().rank() == sourceIndex) expectGathered(gathered);
+	else EXPECT_EQ(0,gathered.size());
+}
+TEST_F(NiceMPItests, asyncVaryingScatter) {
+	const std::vector<int> sendCounts(mpiWorld().size(),1);
+	ReceiveRequest<std::vector<PODtype>> r = mpiWorld().asyncVaryingScatter(sourceIndex,defaultCollection,
+		sendCounts);
+	r.wait();
+	const std::vector<PODtype> scattered = r.take();
+	ASSERT_EQ(1,scattered.size());
+	expectNear(createPODtypeForRank(mpiWorld().rank()), scattered[0], defaultTolerance);
+}
+TEST_F(NiceMPItests, allToAll) {
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) toSend.insert(toSend.end(),2,createAllToAllValue(mpiWorld().rank(),i));
+	const std::vector<int> received = mpiWorld().allToAll(toSend,2);
+	ASSERT_EQ(2*mpiWorld().size(),received.size());
+	for(unsigned i = 0; i < received.size(); ++i) {
+		EXPECT_EQ(createAllToAllValue(i/2,mpiWorld().rank()),received[i]);
+	}
+}
+TEST_F(NiceMPItests, allToAllInSpan) {
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) toSend.push_back(createAllToAllValue(mpiWorld().rank(),i));
+	std::vector<int> received(mpiWorld().size());
+	mpiWorld().allToAll(toSend,makeSpan(received));
+	for(int i = 0; i < mpiWorld().size(); ++i) EXPECT_EQ(createAllToAllValue(i,mpiWorld().rank()),received[i]);
+}
+TEST_F(NiceMPItests, exchangeCounts) {
+	std::vector<int> sendCounts;
+	for(int i = 0; i < mpiWorld().size(); ++i) sendCounts.push_back(createAllToAllValue(mpiWorld().rank(),i));
+	const std::vector<int> receiveCounts = mpiWorld().exchangeCounts(sendCounts);
+	ASSERT_EQ(mpiWorld().size(),receiveCounts.size());
+	for(int i = 0; i < mpiWorld().size(); ++i) EXPECT_EQ(createAllToAllValue(i,mpiWorld().rank()),receiveCounts[i]);
+}
+TEST_F(NiceMPItests, varyingAllToAllExchangesCounts) {
+	const std::vector<int> sendCounts = createVaryingAllToAllSendCounts();
+	expectVaryingAllToAll(mpiWorld().varyingAllToAll(createVaryingAllToAllData(sendCounts),sendCounts));
+}
+TEST_F(NiceMPItests, varyingAllToAllWithReceiveDisplacements) {
+	const std::vector<int> sendCounts(mpiWorld().size(),1);
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) toSend.push_back(createAllToAllValue(mpiWorld().rank(),i));
+	const std::vector<int> receiveCounts(mpiWorld().size(),1);
+	std::vector<int> reversed(mpiWorld().size());
+	for(int i = 0; i < mpiWorld().size(); ++i) reversed[i] = mpiWorld().size() - 1 - i;
+
+	const std::vector<int> received = mpiWorld().varyingAllToAll(toSend,sendCounts,receiveCounts,{},reversed);
+	ASSERT_EQ(mpiWorld().size(),received.size());
+	for(int i = 0; i < mpiWorld().size(); ++i) {
+		EXPECT_EQ(createAllToAllValue(i,mpiWorld().rank()),received[reversed[i]]);
+	}
+}
+TEST_F(NiceMPItests, varyingAllToAllInSpan) {
+	const std::vector<int> sendCounts = createVaryingAllToAllSendCounts();
+	const std::vector<int> receiveCounts = mpiWorld().exchangeCounts(sendCounts);
+	std::vector<int> received(std::accumulate(receiveCounts.begin(),receiveCounts.end(),0));
+	mpiWorld().varyingAllToAll(createVaryingAllToAllData(sendCounts),makeSpan(received),sendCounts,receiveCounts);
+	expectVaryingAllToAll(received);
+}
+TEST_F(NiceMPItests, sparseAllToAll) {
+	const std::vector<int> sendCounts = createVaryingAllToAllSendCounts();
+	expectVaryingAllToAll(mpiWorld().sparseAllToAll(createVaryingAllToAllData(sendCounts),sendCounts,19));
+}
+TEST_F(NiceMPItests, sparseAllToAllOnlyToNextProcess) {
+	const int next = (mpiWorld().rank() + 1) % mpiWorld().size();
+	const int previous = (mpiWorld().rank() + mpiWorld().size() - 1) % mpiWorld().size();
+	std::vector<int> sendCounts(mpiWorld().size());
+	sendCounts[next] = 1;
+	const std::vector<int> received = mpiWorld().sparseAllToAll(std::vector<int>{ mpiWorld().rank() },sendCounts,19);
+	ASSERT_EQ(1,received.size());
+	EXPECT_EQ(previous,received[0]);
+}
+TEST_F(NiceMPItests, sparseAllToAllDoesNotMatchPendingReceives) {
+	const int next = (mpiWorld().rank() + 1) % mpiWorld().size();
+	const int previous = (mpiWorld().rank() + mpiWorld().size() - 1) % mpiWorld().size();
+	ReceiveRequest<int> pending = mpiWorld().asyncReceive<int>(MPI_ANY_SOURCE,0);
+	std::vector<int> sendCounts(mpiWorld().size());
+	sendCounts[next] = 1;
+	const std::vector<int> received = mpiWorld().sparseAllToAll(std::vector<int>{ mpiWorld().rank() },sendCounts,0);
+	ASSERT_EQ(1,received.size());
+	EXPECT_EQ(previous,received[0]);
+	EXPECT_FALSE(pending.isCompleted());
+	mpiWorld().send(-1,next,0);
+	pending.wait();
+	EXPECT_EQ(-1,pending.take()[0]);
+}
+TEST_F(NiceMPItests, asyncAllToAll) {
+	std::vector<int> toSend;
+	for(int i = 0; i < mpiWorld().size(); ++i) toSend.push_back(createAllToAllValue(mpiWorld().rank(),i));
+	ReceiveRequest<std::vector<int>> r = mpiWorld().asyncAllToAll(toSend,1);
+	toSend.clear();
+	r.wait();
+	const std::vector<int> received = r.take();
+	ASSERT_EQ(mpiWorld().size(),received.size());
+	for(int i = 0; i < mpiWorld().size(); ++i) EXPECT_EQ(createAllToAllValue(i,mpiWorld().rank()),received[i]);
+}
+TEST_F(NiceMPItests, asyncVaryingAllToAll) {
+	const std::vector<int> sendCounts = createVaryingAllToAllSendCounts();
+	const std::vector<int> receiveCounts = mpiWorld().exchangeCounts(sendCounts);
+	ReceiveRequest<std::vector<int>> r = mpiWorld().asyncVaryingAllToAll(createVaryingAllToAllData(sendCounts),
+		sendCounts,receiveCounts);
+	r.wait();
+	expectVaryingAllToAll(r.take());
+}
+
+TEST_F(NiceMPItests, receiveMessageOfUnknownSize) {
+	const int tag = 20;
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(std::vector<PODtype>(5,podTypeInstance),destinationIndex,tag);
+	if(mpiWorld().rank() == destinationIndex) {
+		const Message<std::vector<PODtype>> m = mpiWorld().receiveMessage<std::vector<PODtype>>(sourceIndex,tag);
+		EXPECT_EQ(sourceIndex,m.source);
+		EXPECT_EQ(tag,m.tag);
+		ASSERT_EQ(5,m.data.size());
+		for(auto&& x: m.data) expectNear(podTypeInstance, x, defaultTolerance);
+	}
+}
+TEST_F(NiceMPItests, receiveMessageFromAnySourceAndTag) {
+	Communicator isolated; // MPI_ANY_TAG must not match the messages of the other tests
+	const int firstTag = 30;
+	if(isolated.rank() != sourceIndex) {
+		isolated.send(std::vector<int>(isolated.rank(),isolated.rank()),sourceIndex,firstTag+isolated.rank());
+	}
+	else {
+		for(int i = 1; i < isolated.size(); ++i) {
+			const Message<std::vector<int>> m = isolated.receiveMessage<std::vector<int>>(MPI_ANY_SOURCE,
+				MPI_ANY_TAG);
+			EXPECT_EQ(firstTag+m.source,m.tag);
+			EXPECT_EQ(std::vector<int>(m.source,m.source),m.data);
+		}
+	}
+}
+TEST_F(NiceMPItests, receiveMessageInArray) {
+	const int tag = 21;
+	using Array = std::array<int,3>;
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(Array{{ 1, 2, 3 }},destinationIndex,tag);
+	if(mpiWorld().rank() == destinationIndex) {
+		const Message<Array> m = mpiWorld().receiveMessage<Array>(MPI_ANY_SOURCE,tag);
+		EXPECT_EQ(sourceIndex,m.source);
+		EXPECT_EQ((Array{{ 1, 2, 3 }}),m.data);
+	}
+}
+TEST_F(NiceMPItests, asyncReceiveMessagePostedBeforeSend) {
+	if(mpiWorld().size() == 1) return;
+	const int tag = 22;
+	const int readyTag = 26;
+	if(mpiWorld().rank() == destinationIndex) {
+		ReceiveRequest<std::vector<int>> r = mpiWorld().asyncReceiveMessage<std::vector<int>>(MPI_ANY_SOURCE,tag);
+		EXPECT_EQ(false,r.isCompleted());
+		mpiWorld().send(mpiWorld().rank(),sourceIndex,readyTag);
+		r.wait();
+		EXPECT_EQ(sourceIndex,r.source());
+		EXPECT_EQ(tag,r.tag());
+		EXPECT_EQ(createRange(7,0),r.take());
+	}
+	if(mpiWorld().rank() == sourceIndex) {
+		mpiWorld().receive<int>(destinationIndex,readyTag);
+		mpiWorld().send(createRange(7,0),destinationIndex,tag);
+	}
+}
+TEST_F(NiceMPItests, asyncReceiveMessageInRequestSet) {
+	const int tag = 23;
+	if(mpiWorld().rank() == sourceIndex) mpiWorld().send(createRange(4,10),destinationIndex,tag);
+	if(mpiWorld().rank() == destinationIndex) {
+		RequestSet set;
+		const std::size_t index = set.add(mpiWorld().asyncReceiveMessage<std::vector<int>>(sourceIndex,tag));
+		EXPECT_EQ(index,set.waitAny());
+		EXPECT_EQ(createRange(4,10),set.take<std::vector<int>>(index));
+	}
+}
+TEST_F(NiceMPItests, unmatchedAsyncReceiveMessageIsDropped) {
+	ReceiveRequest<std::vector<int>> r = mpiWorld().asyncReceiveMessage<std::vector<int>>(mpiWorld().rank(),24);
+	EXPECT_EQ(false,r.isCompleted());
+}
+TEST_F(NiceMPItests, asyncReceiveReportsSourceAndTag) {
+	Communicator isolated; // MPI_ANY_TAG must not match the messages of the other tests
+	const int tag = 25;
+	if(isolated.rank() == sourceIndex) isolated.send(42,destinationIndex,tag);
+	if(isolated.rank() == destinationIndex) {
+		ReceiveRequest<int> r = isolated.asyncReceive<int>(MPI_ANY_SOURCE,MPI_ANY_TAG);
+		r.wait();
+		EXPECT_EQ(sourceIndex,r.source());
+		EXPECT_EQ(tag,r.tag());
+		EXPECT_EQ(42,r.take()[0]);
+	}
+}
+
 
 
 TEST_F(NiceMPItests, sendAndReceiveAnythingVector) {
@@ -444,6 +1479,18 @@ TEST_F(NiceMPItests, allGatherVector) {
 TEST_F(NiceMPItests, allGatherArray) {
 	testAllGather<std::array<PODtype,2>>();
 }
+TEST_F(NiceMPItests, allReduceVector) {
+	testAllReduceCollection<std::vector<int>>();
+}
+TEST_F(NiceMPItests, allReduceArray) {
+	testAllReduceCollection<std::array<int,2>>();
+}
+TEST_F(NiceMPItests, reduceVector) {
+	testReduceCollection<std::vector<int>>();
+}
+TEST_F(NiceMPItests, reduceArray) {
+	testReduceCollection<std::array<int,2>>();
+}
 TEST_F(NiceMPItests, asyncSendAndReceiveAndWaitVector) {
 	testAsyncSendAndReceiveCollection<std::vector<PODtype>>();
 }
@@ -0,0 +1,133 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <NiceMPI/private/OrderedBroadcasts.h>
+#include <cassert>
+#include <deque>
+#include <mutex> // std::mutex, std::lock_guard
+#include <utility> // std::move
+#include <NiceMPI/MPIdatatype.h> // mpi_datatype
+#include <NiceMPI/NiceMPIexception.h> // handleError
+
+namespace NiceMPI {
+
+namespace {
+
+/** \brief Data steps of the broadcasts of a communicator, not started yet. */
+struct Queue {
+	/** \brief Takes the private duplicate of \p communicator, on which the data steps are started. Collective
+  the first time. */
+	explicit Queue(const MPIcommunicatorHandle& communicator): duplicate(communicator.privateDuplicate())
+	{}
+
+	/** \brief Private communicator of the data steps. */
+	MPIcommunicatorHandle duplicate;
+	/** \brief Broadcasts whose data step is not started, in the order of creation. */
+	std::deque<std::shared_ptr<OrderedBroadcasts::Broadcast>> waiting;
+	/** \brief The broadcasts can be tested by many threads, like the thread of ProgressEngine. */
+	std::mutex mutex;
+};
+
+/** \brief Frees the queue cached as an attribute, when its communicator is freed. */
+int deleteQueue(MPI_Comm, int, void* attribute, void*) {
+	delete static_cast<std::shared_ptr<Queue>*>(attribute);
+	return MPI_SUCCESS;
+}
+
+/** \brief Returns the key of the queues cached in the communicators. The duplicates of a communicator don't
+  inherit its queue. */
+int queueKey() {
+	static const int key = [] () {
+		int x = MPI_KEYVAL_INVALID;
+		handleError(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,&deleteQueue,&x,nullptr));
+		return x;
+	}();
+	return key;
+}
+
+/** \brief Returns the queue of \p communicator, created the first time. Collective the first time. */
+std::shared_ptr<Queue> queueOf(const MPIcommunicatorHandle& communicator) {
+	void* attribute = nullptr;
+	int found = 0;
+	handleError(MPI_Comm_get_attr(communicator.get(),queueKey(),&attribute,&found));
+	if(found) return *static_cast<std::shared_ptr<Queue>*>(attribute);
+	auto x = new std::shared_ptr<Queue>(std::make_shared<Queue>(communicator));
+	handleError(MPI_Comm_set_attr(communicator.get(),queueKey(),x));
+	return *x;
+}
+
+} // namespace
+
+/** \brief Broadcast whose data step is not taken yet. */
+struct OrderedBroadcasts::Broadcast {
+	/** \brief Count broadcast by the first step. */
+	std::size_t count;
+	/** \brief Request of the first step. */
+	MPI_Request countRequest;
+	/** \brief Starts the data step. */
+	DataStep step;
+	/** \brief Request of the data step, until it is taken by start(). */
+	MPI_Request dataRequest;
+	/** \brief True if the data step is started. */
+	bool started;
+	/** \brief Queue of the communicator, kept alive until the data step is taken. */
+	std::shared_ptr<Queue> queue;
+};
+
+std::shared_ptr<OrderedBroadcasts::Broadcast> OrderedBroadcasts::add(const MPIcommunicatorHandle& communicator,
+	std::size_t count, int source, DataStep step)
+{
+	const std::shared_ptr<Queue> queue = queueOf(communicator);
+	const auto x = std::make_shared<Broadcast>();
+	x->count = count;
+	x->countRequest = MPI_REQUEST_NULL;
+	x->step = std::move(step);
+	x->dataRequest = MPI_REQUEST_NULL;
+	x->started = false;
+	x->queue = queue;
+	std::lock_guard<std::mutex> lock(queue->mutex);
+	handleError(MPI_Ibcast(&x->count,1,mpi_datatype<std::size_t>::get(),source,communicator.get(),
+		&x->countRequest));
+	queue->waiting.push_back(x);
+	return x;
+}
+
+bool OrderedBroadcasts::start(const std::shared_ptr<Broadcast>& broadcast, MPI_Request& request) {
+	Queue& queue = *broadcast->queue;
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	while(!broadcast->started) {
+		assert(!queue.waiting.empty());
+		Broadcast& x = *queue.waiting.front();
+		int flag = 0;
+		handleError(MPI_Test(&x.countRequest,&flag,MPI_STATUS_IGNORE));
+		if(flag == 0) return false;
+		x.step(x.count,queue.duplicate.get(),x.dataRequest);
+		x.started = true;
+		x.step = nullptr;
+		queue.waiting.pop_front();
+	}
+	request = broadcast->dataRequest;
+	broadcast->dataRequest = MPI_REQUEST_NULL;
+	return true;
+}
+
+} // NiceMPi
@@ -0,0 +1,235 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <NiceMPI/Profiler.h>
+#include <atomic>
+#include <fstream>
+#include <iomanip> // std::setw
+#include <mutex> // std::mutex, std::lock_guard
+#include <set>
+#include <vector>
+#include <NiceMPI/NiceMPIexception.h> // handleError
+
+namespace NiceMPI {
+
+namespace {
+
+/** \brief Call traced, for the Chrome trace. */
+struct Event {
+	/** \brief Name of the operation, which has a static storage duration, like __func__. */
+	const char* operation;
+	/** \brief MPI_Wtime at the start of the call. */
+	double start;
+	/** \brief Duration of the call, in seconds. */
+	double duration;
+	/** \brief Index of the thread that made the call. */
+	int thread;
+};
+
+/** \brief What the Profiler recorded, and the files it must write. */
+struct Records {
+	/** \brief Statistics by operation. */
+	std::map<std::string,ProfiledStatistics> statistics;
+	/** \brief Calls traced since setOutput(). */
+	std::vector<Event> events;
+	/** \brief True if the calls are traced. */
+	bool isTracing = false;
+	/** \brief True if the imbalance must be written. */
+	bool isReportingImbalance = false;
+	/** \brief Prefix of the files to write, or empty. */
+	std::string prefix;
+	/** \brief Calls can be recorded by many threads at the same time. */
+	std::mutex mutex;
+};
+
+/** \brief Returns the unique instance of Records. */
+Records& records() {
+	static Records instance;
+	return instance;
+}
+
+/** \brief Number of calls being recorded on this thread, to find the nested ones. */
+thread_local int depth = 0;
+
+/** \brief Returns the index of this thread, given in the order of their first call. */
+int threadIndex() {
+	static std::atomic<int> count(0);
+	thread_local const int index = count++;
+	return index;
+}
+
+/** \brief Writes the \p imbalance of each operation, one per line. */
+void writeImbalanceTable(std::ostream& out, const std::map<std::string,Profiler::Imbalance>& imbalance) {
+	out << std::left << std::setw(32) << "operation" << std::right << std::setw(14) << "minimum" << std::setw(14)
+		<< "mean" << std::setw(14) << "maximum" << "\n";
+	for(auto&& x: imbalance) {
+		out << std::left << std::setw(32) << x.first << std::right << std::setw(14) << x.second.minimum
+			<< std::setw(14) << x.second.mean << std::setw(14) << x.second.maximum << "\n";
+	}
+}
+
+} // namespace
+
+void Profiler::finish() {
+	Records& x = records();
+	std::string prefix;
+	bool isTracing, isReportingImbalance;
+	{
+		std::lock_guard<std::mutex> lock(x.mutex);
+		prefix = x.prefix;
+		isTracing = x.isTracing;
+		isReportingImbalance = x.isReportingImbalance;
+	}
+	if(prefix.empty()) return;
+	int rank = 0;
+	handleError(MPI_Comm_rank(MPI_COMM_WORLD,&rank));
+	std::ofstream summary(prefix + "." + std::to_string(rank) + ".txt");
+	writeSummary(summary);
+	if(isTracing) {
+		std::ofstream trace(prefix + "." + std::to_string(rank) + ".json");
+		writeTrace(trace,rank);
+	}
+	if(!isReportingImbalance) return;
+	const std::map<std::string,Imbalance> result = imbalance(MPI_COMM_WORLD);
+	if(rank != 0) return;
+	std::ofstream out(prefix + ".imbalance.txt");
+	writeImbalanceTable(out,result);
+}
+
+std::map<std::string,Profiler::Imbalance> Profiler::imbalance(MPI_Comm communicator) {
+	std::string names;
+	for(auto&& x: statistics()) names += x.first + '\n';
+	int size = 0;
+	handleError(MPI_Comm_size(communicator,&size));
+	std::vector<int> lengths(static_cast<std::size_t>(size));
+	int length = static_cast<int>(names.size());
+	handleError(MPI_Allgather(&length,1,MPI_INT,lengths.data(),1,MPI_INT,communicator));
+	std::vector<int> displacements(lengths.size(),0);
+	for(std::size_t i = 1; i < lengths.size(); ++i) displacements[i] = displacements[i-1] + lengths[i-1];
+	std::string all(static_cast<std::size_t>(displacements.back() + lengths.back()),'\n');
+	handleError(MPI_Allgatherv(names.data(),length,MPI_CHAR,&all[0],lengths.data(),displacements.data(),MPI_CHAR,
+		communicator));
+
+	std::set<std::string> operations;
+	for(std::size_t first = 0, last = 0; (last = all.find('\n',first)) != std::string::npos; first = last + 1) {
+		if(last > first) operations.insert(all.substr(first,last-first));
+	}
+	const std::map<std::string,ProfiledStatistics> local = statistics();
+	std::vector<double> times;
+	for(auto&& x: operations) {
+		const auto found = local.find(x);
+		times.push_back(found == local.end() ? 0 : found->second.time);
+	}
+	std::vector<double> minimum(times.size()), sum(times.size()), maximum(times.size());
+	const int count = static_cast<int>(times.size());
+	handleError(MPI_Allreduce(times.data(),minimum.data(),count,MPI_DOUBLE,MPI_MIN,communicator));
+	handleError(MPI_Allreduce(times.data(),sum.data(),count,MPI_DOUBLE,MPI_SUM,communicator));
+	handleError(MPI_Allreduce(times.data(),maximum.data(),count,MPI_DOUBLE,MPI_MAX,communicator));
+
+	std::map<std::string,Imbalance> result;
+	std::size_t i = 0;
+	for(auto&& x: operations) {
+		result[x] = Imbalance{ minimum[i], sum[i]/size, maximum[i] };
+		++i;
+	}
+	return result;
+}
+
+std::map<std::string,ProfiledStatistics> Profiler::statistics() {
+	Records& x = records();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	return x.statistics;
+}
+
+void Profiler::record(const char* operation, std::size_t bytes, double start, double end, bool isWait) {
+	Records& x = records();
+	const int thread = threadIndex();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	ProfiledStatistics& y = x.statistics[operation];
+	++y.calls;
+	y.bytes += bytes;
+	y.time += end - start;
+	if(isWait) y.waitTime += end - start;
+	if(x.isTracing) x.events.push_back(Event{ operation, start, end - start, thread });
+}
+
+void Profiler::reset() {
+	Records& x = records();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	x.statistics.clear();
+	x.events.clear();
+}
+
+void Profiler::setOutput(const std::string& prefix, bool trace, bool imbalance) {
+	Records& x = records();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	x.prefix = prefix;
+	x.isTracing = trace and !prefix.empty();
+	x.isReportingImbalance = imbalance;
+}
+
+void Profiler::writeImbalance(std::ostream& out, MPI_Comm communicator) {
+	writeImbalanceTable(out,imbalance(communicator));
+}
+
+void Profiler::writeSummary(std::ostream& out) {
+	out << std::left << std::setw(32) << "operation" << std::right << std::setw(12) << "calls" << std::setw(16)
+		<< "bytes" << std::setw(14) << "time" << std::setw(14) << "waitTime" << "\n";
+	for(auto&& x: statistics()) {
+		out << std::left << std::setw(32) << x.first << std::right << std::setw(12) << x.second.calls
+			<< std::setw(16) << x.second.bytes << std::setw(14) << x.second.time << std::setw(14)
+			<< x.second.waitTime << "\n";
+	}
+}
+
+void Profiler::writeTrace(std::ostream& out, int process) {
+	std::vector<Event> events;
+	{
+		Records& x = records();
+		std::lock_guard<std::mutex> lock(x.mutex);
+		events = x.events;
+	}
+	const std::ios::fmtflags flags = out.flags();
+	const std::streamsize precision = out.precision();
+	out << "{\"traceEvents\":[";
+	for(std::size_t i = 0; i < events.size(); ++i) {
+		const Event& x = events[i];
+		out << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << x.operation << "\",\"ph\":\"X\",\"ts\":" << std::fixed
+			<< std::setprecision(3) << x.start*1e6 << ",\"dur\":" << x.duration*1e6 << ",\"pid\":" << process
+			<< ",\"tid\":" << x.thread << "}";
+	}
+	out << "\n]}\n";
+	out.flags(flags);
+	out.precision(precision);
+}
+
+
+
+ProfiledCall::ProfiledCall(const char* operation, std::size_t bytes, bool isWait)
+: operation(operation), bytes(bytes), isWait(isWait), isOutermost(depth++ == 0), start(isOutermost ? MPI_Wtime() : 0)
+{}
+
+ProfiledCall::~ProfiledCall() {
+	--depth;
+	if(isOutermost) Profiler::record(operation,bytes,start,MPI_Wtime(),isWait);
+}
+
+} // NiceMPi
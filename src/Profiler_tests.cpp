@@ -0,0 +1,133 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+#include <algorithm> // std::count
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/NiceMPI.h>
+#include <NiceMPI/Profiler.h>
+
+using namespace NiceMPI;
+
+class ProfilerTests : public ::testing::Test {
+public:
+	void SetUp() override {
+		Profiler::reset();
+	}
+	void TearDown() override {
+		Profiler::setOutput("");
+		Profiler::reset();
+	}
+};
+
+
+TEST_F(ProfilerTests, callsAreRecorded) {
+	{ ProfiledCall call("first",8); }
+	{ ProfiledCall call("first",4); }
+	const ProfiledStatistics x = Profiler::statistics()["first"];
+	EXPECT_EQ(2u,x.calls);
+	EXPECT_EQ(12u,x.bytes);
+	EXPECT_LE(0,x.time);
+	EXPECT_EQ(0,x.waitTime);
+}
+TEST_F(ProfilerTests, nestedCallsAreRecordedOnce) {
+	{
+		ProfiledCall outer("outer");
+		ProfiledCall inner("inner");
+	}
+	const std::map<std::string,ProfiledStatistics> x = Profiler::statistics();
+	EXPECT_EQ(1u,x.size());
+	EXPECT_EQ(1u,x.count("outer"));
+}
+TEST_F(ProfilerTests, waitsAreWaitTime) {
+	Profiler::record("wait",0,1,3.5,true);
+	const ProfiledStatistics x = Profiler::statistics()["wait"];
+	EXPECT_EQ(2.5,x.time);
+	EXPECT_EQ(2.5,x.waitTime);
+}
+TEST_F(ProfilerTests, bytesOfTheData) {
+	const std::vector<double> data(3);
+	EXPECT_EQ(3*sizeof(double),profiledBytes(data,0));
+	EXPECT_EQ(3*sizeof(double),profiledBytes(makeSpan(data),0));
+	EXPECT_EQ(sizeof(int),profiledBytes(7,0));
+	EXPECT_EQ(0u,profiledBytes(std::vector<std::string>(2),0));
+}
+TEST_F(ProfilerTests, summaryHasALinePerOperation) {
+	Profiler::record("first",0,0,1,false);
+	Profiler::record("second",0,0,1,false);
+	std::ostringstream out;
+	Profiler::writeSummary(out);
+	const std::string summary = out.str();
+	EXPECT_EQ(3,std::count(summary.begin(),summary.end(),'\n'));
+	EXPECT_NE(std::string::npos,summary.find("second"));
+}
+TEST_F(ProfilerTests, callsAreTracedAfterSetOutput) {
+	Profiler::record("untraced",0,0,1,false);
+	Profiler::setOutput("NiceMPI_ProfilerTests",true);
+	Profiler::record("traced",0,1,1.5,false);
+	std::ostringstream out;
+	Profiler::writeTrace(out,3);
+	const std::string trace = out.str();
+	EXPECT_EQ(0u,trace.find("{\"traceEvents\":["));
+	EXPECT_NE(std::string::npos,trace.find("\"name\":\"traced\",\"ph\":\"X\",\"ts\":1000000.000,\"dur\":500000.000"));
+	EXPECT_NE(std::string::npos,trace.find("\"pid\":3"));
+	EXPECT_EQ(std::string::npos,trace.find("untraced"));
+}
+TEST_F(ProfilerTests, imbalanceOfEveryOperation) {
+	const int rank = mpiWorld().rank();
+	const int size = mpiWorld().size();
+	Profiler::record("common",0,0,rank,false);
+	if(rank == 0) Profiler::record("onlyFirst",0,0,size,false);
+	const std::map<std::string,Profiler::Imbalance> x = Profiler::imbalance(MPI_COMM_WORLD);
+	ASSERT_EQ(2u,x.size());
+	EXPECT_EQ(0,x.at("common").minimum);
+	EXPECT_DOUBLE_EQ((size-1)/2.,x.at("common").mean);
+	EXPECT_EQ(size-1,x.at("common").maximum);
+	EXPECT_EQ(size == 1 ? 1 : 0,x.at("onlyFirst").minimum);
+	EXPECT_DOUBLE_EQ(1,x.at("onlyFirst").mean);
+	EXPECT_EQ(size,x.at("onlyFirst").maximum);
+}
+#ifdef NICEMPI_PROFILING
+TEST_F(ProfilerTests, communicatorCallsAreRecorded) {
+	Communicator world = mpiWorld().duplicate();
+	Profiler::reset();
+	world.broadcast(0,std::vector<int>(5));
+	world.allReduce(1);
+	const std::map<std::string,ProfiledStatistics> x = Profiler::statistics();
+	EXPECT_EQ(2u,x.size());
+	EXPECT_EQ(1u,x.at("broadcast").calls);
+	EXPECT_EQ(5*sizeof(int),x.at("broadcast").bytes);
+	EXPECT_EQ(sizeof(int),x.at("allReduce").bytes);
+}
+TEST_F(ProfilerTests, waitsOfRequestsAreRecorded) {
+	Communicator world = mpiWorld().duplicate();
+	Profiler::reset();
+	ReceiveRequest<int> r = world.asyncAllReduce(1);
+	r.wait();
+	const std::map<std::string,ProfiledStatistics> x = Profiler::statistics();
+	EXPECT_EQ(1u,x.at("asyncAllReduce").calls);
+	EXPECT_EQ(1u,x.at("ReceiveRequest::wait").calls);
+	EXPECT_EQ(x.at("ReceiveRequest::wait").time,x.at("ReceiveRequest::wait").waitTime);
+}
+#endif
@@ -0,0 +1,243 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <NiceMPI/ProgressEngine.h>
+#include <NiceMPI/NiceMPIexception.h> // handleError
+#include <NiceMPI/private/DetachedRequests.h> // DetachedRequests
+#include <atomic> // std::atomic
+#include <cassert>
+#include <exception> // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <memory> // std::shared_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <thread> // std::thread, std::this_thread
+#include <utility> // std::move
+#include <vector>
+
+namespace NiceMPI {
+
+namespace {
+
+/** \brief Operation handed over to the engine. */
+struct Entry {
+	/** \brief Starts the next step of the operation, see ProgressEngine::add. */
+	ProgressEngine::Advance advance;
+	/** \brief Calls the continuation of the operation. */
+	std::function<void()> finish;
+	/** \brief True if the operation can be cancelled. */
+	bool cancellable;
+};
+
+/** \brief Operations handed over and not finished yet, and the background thread. */
+struct Engine {
+	/** \brief MPI implementations of the operations. Contiguous, as required by MPI_Testsome. */
+	std::vector<MPI_Request> requests;
+	/** \brief Operation of the request of the same index. Shared, so that it can be given to DetachedRequests. */
+	std::vector<std::shared_ptr<Entry>> entries;
+	/** \brief Operations can be added and polled by many threads at the same time. */
+	std::mutex mutex;
+	/** \brief Background thread, if started. */
+	std::thread thread;
+	/** \brief True while the background thread must run. */
+	std::atomic<bool> running{false};
+	/** \brief Serializes the start and the stop of the background thread. */
+	std::mutex threadMutex;
+	/** \brief Exception thrown in the background thread, not rethrown yet. Guarded by mutex. */
+	std::exception_ptr failure;
+};
+
+/** \brief Returns the unique instance of Engine. */
+Engine& engine() {
+	static Engine instance;
+	return instance;
+}
+
+/** \brief Returns true if MPI can still be called. */
+bool isMPIactive() {
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	return finalized == 0;
+}
+
+/** \brief Advances the operation of \p entry, whose \p request completed. If a step throws, the operation is
+  finished, and its continuation rethrows the exception instead, so that it is reported once by poll(). */
+bool advance(Entry& entry, MPI_Request& request) {
+	try {
+		return entry.advance(request);
+	} catch(...) {
+		const std::exception_ptr failure = std::current_exception();
+		entry.finish = [failure]() { std::rethrow_exception(failure); };
+		return true;
+	}
+}
+
+/** \brief Advances the operations of \p x, and moves the finished ones into \p finished. Returns the MPI error
+  code. */
+int advanceAll(Engine& x, std::vector<std::shared_ptr<Entry>>& finished) {
+	std::lock_guard<std::mutex> lock(x.mutex);
+	if(x.requests.empty()) return MPI_SUCCESS;
+	std::vector<bool> done(x.requests.size(),false);
+	for(std::size_t i = 0; i < x.requests.size(); ++i) {
+		if(x.requests[i] == MPI_REQUEST_NULL) done[i] = advance(*x.entries[i],x.requests[i]);
+	}
+	int outcount = 0;
+	std::vector<int> indices(x.requests.size());
+	int error = MPI_Testsome(static_cast<int>(x.requests.size()),x.requests.data(),&outcount,indices.data(),
+		MPI_STATUSES_IGNORE);
+	if(error != MPI_SUCCESS) return error;
+	for(int i = 0; i < outcount and outcount != MPI_UNDEFINED; ++i) {
+		const std::size_t index = static_cast<std::size_t>(indices[i]);
+		if(!done[index]) done[index] = advance(*x.entries[index],x.requests[index]);
+	}
+	std::size_t kept = 0;
+	for(std::size_t i = 0; i < x.requests.size(); ++i) {
+		if(done[i]) {
+			finished.push_back(std::move(x.entries[i]));
+			continue;
+		}
+		x.requests[kept] = x.requests[i];
+		x.entries[kept] = std::move(x.entries[i]);
+		++kept;
+	}
+	x.requests.resize(kept);
+	x.entries.resize(kept);
+	return MPI_SUCCESS;
+}
+
+/** \brief Calls the continuations of the \p finished operations. If some of them throw, the other ones are still
+  called, and the first exception is then rethrown. */
+void callContinuations(const std::vector<std::shared_ptr<Entry>>& finished) {
+	std::exception_ptr first;
+	for(const std::shared_ptr<Entry>& entry: finished) {
+		try {
+			entry->finish();
+		} catch(...) {
+			if(!first) first = std::current_exception();
+		}
+	}
+	if(first) std::rethrow_exception(first);
+}
+
+/** \brief Takes the exception thrown in the background thread of \p x, if any. */
+std::exception_ptr takeFailure(Engine& x) {
+	std::lock_guard<std::mutex> lock(x.mutex);
+	std::exception_ptr failure = x.failure;
+	x.failure = nullptr;
+	return failure;
+}
+
+/** \brief Polls every \p interval while the background thread of \p x must run. Stops at the first exception,
+  and keeps it in \p x to be rethrown by the next poll() or stopThread(). */
+void pollInBackground(Engine& x, std::chrono::microseconds interval) {
+	while(x.running) {
+		try {
+			ProgressEngine::poll();
+		} catch(...) {
+			std::lock_guard<std::mutex> lock(x.mutex);
+			x.failure = std::current_exception();
+			return;
+		}
+		std::this_thread::sleep_for(interval);
+	}
+}
+
+/** \brief Stops the background thread of \p x, if one was started, and returns the exception it threw, if any. */
+std::exception_ptr joinThread(Engine& x) {
+	std::lock_guard<std::mutex> lock(x.threadMutex);
+	x.running = false;
+	if(x.thread.joinable()) x.thread.join();
+	return takeFailure(x);
+}
+
+/** \brief Returns true if some operations of \p x can't be cancelled. */
+bool hasUncancellable(Engine& x) {
+	std::lock_guard<std::mutex> lock(x.mutex);
+	for(const std::shared_ptr<Entry>& entry: x.entries) {
+		if(!entry->cancellable) return true;
+	}
+	return false;
+}
+
+} // namespace
+
+void ProgressEngine::add(MPI_Request request, Advance advance, std::function<void()> finish, bool cancellable) {
+	if(!isMPIactive()) return;
+	Engine& x = engine();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	x.requests.push_back(request);
+	x.entries.push_back(std::make_shared<Entry>(Entry{std::move(advance),std::move(finish),cancellable}));
+}
+
+void ProgressEngine::finishAll() {
+	joinThread(engine()); // Called from destructors, can't throw
+	if(!isMPIactive()) return;
+	Engine& x = engine();
+	while(hasUncancellable(x)) {
+		std::vector<std::shared_ptr<Entry>> finished;
+		int error = advanceAll(x,finished);
+		((void)error); // Unused in release mode
+		assert(error == MPI_SUCCESS); // Called from destructors, can't throw
+		try {
+			callContinuations(finished);
+		} catch(...) {
+			// Called from destructors, can't throw: the exceptions of the continuations and the steps are dropped
+		}
+	}
+	std::lock_guard<std::mutex> lock(x.mutex);
+	for(std::size_t i = 0; i < x.requests.size(); ++i) DetachedRequests::add(x.requests[i],x.entries[i],true);
+	x.requests.clear();
+	x.entries.clear();
+}
+
+std::size_t ProgressEngine::pendingCount() {
+	Engine& x = engine();
+	std::lock_guard<std::mutex> lock(x.mutex);
+	return x.requests.size();
+}
+
+std::size_t ProgressEngine::poll() {
+	Engine& x = engine();
+	std::exception_ptr failure = takeFailure(x);
+	if(failure) std::rethrow_exception(failure);
+	std::vector<std::shared_ptr<Entry>> finished;
+	handleError(advanceAll(x,finished));
+	callContinuations(finished);
+	return finished.size();
+}
+
+void ProgressEngine::startThread(std::chrono::microseconds interval) {
+	int provided = MPI_THREAD_SINGLE;
+	handleError(MPI_Query_thread(&provided));
+	if(provided != MPI_THREAD_MULTIPLE) handleError(MPI_ERR_OTHER);
+	Engine& x = engine();
+	std::lock_guard<std::mutex> lock(x.threadMutex);
+	if(x.running) return;
+	if(x.thread.joinable()) x.thread.join(); // Stopped by an exception
+	x.running = true;
+	x.thread = std::thread(&pollInBackground,std::ref(x),interval);
+}
+
+void ProgressEngine::stopThread() {
+	std::exception_ptr failure = joinThread(engine());
+	if(failure) std::rethrow_exception(failure);
+}
+
+} // NiceMPi
@@ -0,0 +1,152 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <atomic> // std::atomic
+#include <stdexcept> // std::runtime_error
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/NiceMPI.h>
+
+using namespace NiceMPI;
+
+class ProgressEngineTests : public ::testing::Test {
+public:
+	void TearDown() override {
+		EXPECT_EQ(0,ProgressEngine::pendingCount());
+	}
+
+	bool isThreadMultiple() const {
+		int provided;
+		MPI_Query_thread(&provided);
+		return provided == MPI_THREAD_MULTIPLE;
+	}
+	void pollUntilFinished() {
+		while(ProgressEngine::pendingCount() != 0) ProgressEngine::poll();
+	}
+
+	Communicator isolated; // The requests of the other tests must not be matched
+	const int self = isolated.rank();
+};
+
+
+TEST_F(ProgressEngineTests, pollWithoutOperations) {
+	EXPECT_EQ(0,ProgressEngine::poll());
+}
+TEST_F(ProgressEngineTests, sendContinuation) {
+	bool sent = false;
+	isolated.asyncSend(42,self).then([&sent]() { sent = true; });
+	EXPECT_EQ(42,isolated.receive<int>(self));
+	pollUntilFinished();
+	EXPECT_TRUE(sent);
+}
+TEST_F(ProgressEngineTests, receiveContinuation) {
+	int received = 0;
+	isolated.asyncReceive<int>(self).then([&received](std::vector<int> data) { received = data.at(0); });
+	EXPECT_EQ(1,ProgressEngine::pendingCount());
+	isolated.send(42,self);
+	pollUntilFinished();
+	EXPECT_EQ(42,received);
+}
+TEST_F(ProgressEngineTests, stepsAreStarted) {
+	const int source = 0;
+	const std::vector<int> toSend = self == source ? std::vector<int>{1,2,3} : std::vector<int>{};
+	std::vector<int> received;
+	isolated.asyncBroadcast(source,toSend).then([&received](std::vector<int> data) { received = data; });
+	pollUntilFinished();
+	EXPECT_EQ((std::vector<int>{1,2,3}),received);
+}
+TEST_F(ProgressEngineTests, matchedMessageContinuation) {
+	const int tag = 3;
+	std::vector<int> received;
+	isolated.asyncReceiveMessage<std::vector<int>>(self,tag).then([&received](std::vector<int> data) {
+		received = data;
+	});
+	EXPECT_EQ(0,ProgressEngine::poll());
+	isolated.send(std::vector<int>{4,5},self,tag);
+	pollUntilFinished();
+	EXPECT_EQ((std::vector<int>{4,5}),received);
+}
+TEST_F(ProgressEngineTests, continuationHandsOverRequests) {
+	int received = 0;
+	Communicator& communicator = isolated;
+	const int destination = self;
+	isolated.asyncReceive<int>(self).then([&communicator,&received,destination](std::vector<int> data) {
+		communicator.asyncSend(data.at(0) + 1,destination).then([&received]() { ++received; });
+	});
+	isolated.send(1,self);
+	while(ProgressEngine::poll() == 0) {}
+	EXPECT_EQ(1,ProgressEngine::pendingCount());
+	EXPECT_EQ(2,isolated.receive<int>(self));
+	pollUntilFinished();
+	EXPECT_EQ(1,received);
+}
+TEST_F(ProgressEngineTests, backgroundThread) {
+	if(!isThreadMultiple()) return;
+	std::atomic<int> received{0};
+	ProgressEngine::startThread();
+	isolated.asyncReceive<int>(self).then([&received](std::vector<int> data) { received = data.at(0); });
+	isolated.send(42,self);
+	while(received == 0) {}
+	ProgressEngine::stopThread();
+	EXPECT_EQ(42,received);
+}
+TEST_F(ProgressEngineTests, continuationExceptionIsRethrownByPoll) {
+	bool called = false;
+	isolated.asyncSend(1,self).then([]() { throw std::runtime_error("continuation"); });
+	isolated.asyncSend(2,self).then([&called]() { called = true; });
+	EXPECT_EQ(1,isolated.receive<int>(self));
+	EXPECT_EQ(2,isolated.receive<int>(self));
+	EXPECT_THROW(pollUntilFinished(),std::runtime_error);
+	pollUntilFinished();
+	EXPECT_TRUE(called);
+}
+TEST_F(ProgressEngineTests, backgroundThreadExceptionIsRethrownByStop) {
+	if(!isThreadMultiple()) return;
+	std::atomic<bool> called{false};
+	ProgressEngine::startThread();
+	isolated.asyncSend(42,self).then([&called]() {
+		called = true;
+		throw std::runtime_error("continuation");
+	});
+	EXPECT_EQ(42,isolated.receive<int>(self));
+	while(!called) {}
+	EXPECT_THROW(ProgressEngine::stopThread(),std::runtime_error);
+	EXPECT_NO_THROW(ProgressEngine::stopThread());
+}
+TEST_F(ProgressEngineTests, unmatchedStridedReceiveIsCancelledWhenFinished) {
+	std::vector<int> grid(16);
+	bool called = false;
+	isolated.asyncReceive(stridedView(grid.data(),4,1,4),self,99).then([&called]() { called = true; });
+	ProgressEngine::finishAll(); // Would spin forever if the receive was not cancellable
+	DetachedRequests::completeAll();
+	EXPECT_EQ(0,DetachedRequests::pendingCount());
+	EXPECT_FALSE(called);
+}
+TEST_F(ProgressEngineTests, finishAllDropsContinuationExceptions) {
+	bool called = false;
+	isolated.asyncSend(1,self).then([]() { throw std::runtime_error("continuation"); });
+	isolated.asyncSend(2,self).then([&called]() { called = true; });
+	EXPECT_EQ(1,isolated.receive<int>(self));
+	EXPECT_EQ(2,isolated.receive<int>(self));
+	EXPECT_NO_THROW(ProgressEngine::finishAll());
+	EXPECT_TRUE(called);
+}
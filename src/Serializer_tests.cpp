@@ -0,0 +1,105 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <map>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/Serializer.h>
+
+using namespace NiceMPI;
+
+namespace {
+struct Particle {
+	std::string name;
+	std::vector<double> position;
+};
+}
+
+namespace NiceMPI {
+template<>
+struct Serializer<Particle> {
+	static constexpr bool isDefined = true;
+	static std::size_t size(const Particle& data) {
+		return Serializer<std::string>::size(data.name) + Serializer<std::vector<double>>::size(data.position);
+	}
+	static void write(const Particle& data, unsigned char*& out) {
+		Serializer<std::string>::write(data.name,out);
+		Serializer<std::vector<double>>::write(data.position,out);
+	}
+	static void read(Particle& data, const unsigned char*& in) {
+		Serializer<std::string>::read(data.name,in);
+		Serializer<std::vector<double>>::read(data.position,in);
+	}
+};
+}
+
+template<class Type>
+Type roundTrip(const Type& data) {
+	std::vector<unsigned char> buffer;
+	serialize(data,buffer);
+	EXPECT_EQ(Serializer<Type>::size(data),buffer.size());
+	return deserialize<Type>(buffer);
+}
+
+TEST(SerializerTests, podsArePackedAsTheirBytes) {
+	EXPECT_EQ(sizeof(double),Serializer<double>::size(1.5));
+	EXPECT_EQ(1.5,roundTrip(1.5));
+}
+TEST(SerializerTests, vectorOfPodsIsASingleBlock) {
+	const std::vector<int> data = { 1, 2, 3 };
+	EXPECT_EQ(sizeof(std::uint64_t) + 3*sizeof(int),Serializer<std::vector<int>>::size(data));
+	EXPECT_EQ(data,roundTrip(data));
+}
+TEST(SerializerTests, vectorOfStrings) {
+	const std::vector<std::string> data = { "one", "", "three" };
+	EXPECT_EQ(data,roundTrip(data));
+}
+TEST(SerializerTests, nestedVectors) {
+	const std::vector<std::vector<int>> data = { { 1, 2 }, {}, { 3 } };
+	EXPECT_EQ(data,roundTrip(data));
+}
+TEST(SerializerTests, map) {
+	const std::map<std::string,std::vector<double>> data = { { "a", { 1.5 } }, { "b", { 2.5, 3.5 } } };
+	EXPECT_EQ(data,roundTrip(data));
+}
+TEST(SerializerTests, userSpecialization) {
+	const std::vector<Particle> data = { { "electron", { 0, 1, 2 } }, { "proton", {} } };
+	const std::vector<Particle> result = roundTrip(data);
+	ASSERT_EQ(data.size(),result.size());
+	for(std::size_t i = 0; i < data.size(); ++i) {
+		EXPECT_EQ(data[i].name,result[i].name);
+		EXPECT_EQ(data[i].position,result[i].position);
+	}
+}
+TEST(SerializerTests, isSerialized) {
+	const bool vectorOfStrings = is_serialized<std::vector<std::string>>::value;
+	const bool map = is_serialized<std::map<int,int>>::value;
+	const bool pod = is_serialized<int>::value;
+	const bool vectorOfPods = is_serialized<std::vector<int>>::value;
+	const bool string = is_serialized<std::string>::value;
+	EXPECT_TRUE(vectorOfStrings);
+	EXPECT_TRUE(map);
+	EXPECT_FALSE(pod);
+	EXPECT_FALSE(vectorOfPods);
+	EXPECT_FALSE(string);
+}
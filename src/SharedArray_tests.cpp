@@ -0,0 +1,65 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <utility> // std::move
+#include <gtest/gtest.h>
+#include <NiceMPI/SharedArray.h>
+
+using namespace NiceMPI;
+
+class SharedArrayTests : public ::testing::Test {
+public:
+	const Communicator node = mpiWorld().splitShared();
+};
+
+
+TEST_F(SharedArrayTests, everyProcessSeesTheElements) {
+	SharedArray<int> table(node,3);
+	EXPECT_EQ(3,table.size());
+}
+TEST_F(SharedArrayTests, ownerStoresOthersLoad) {
+	SharedArray<int> table(node,4);
+	if(node.rank() == 0) {
+		for(std::size_t i = 0; i < table.size(); ++i) table[i] = static_cast<int>(10*i);
+	}
+	table.synchronize();
+	for(std::size_t i = 0; i < table.size(); ++i) {
+		EXPECT_EQ(static_cast<int>(10*i),table[i]);
+	}
+}
+TEST_F(SharedArrayTests, everyProcessStores) {
+	SharedArray<int> slots(node,node.size(),node.size() - 1);
+	slots[node.rank()] = node.rank() + 1;
+	slots.synchronize();
+	for(int i = 0; i < node.size(); ++i) {
+		EXPECT_EQ(i + 1,slots[i]);
+	}
+	slots.synchronize(); // The slots are read before being freed
+}
+TEST_F(SharedArrayTests, canBeMoved) {
+	SharedArray<double> table(node,2);
+	if(node.rank() == 0) table[1] = 6.5;
+	table.synchronize();
+	const SharedArray<double> moved(std::move(table));
+	EXPECT_EQ(2,moved.size());
+	EXPECT_EQ(6.5,moved[1]);
+}
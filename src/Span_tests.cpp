@@ -0,0 +1,75 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <array>
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/Span.h>
+
+using namespace NiceMPI;
+
+TEST(SpanTests, viewsTheElementsOfAVector) {
+	std::vector<int> data = { 1, 2, 3 };
+	const Span<int> view = makeSpan(data);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(data.size(),view.size());
+	EXPECT_FALSE(view.empty());
+}
+TEST(SpanTests, viewsTheElementsOfAnArray) {
+	const std::array<int,2> data = {{ 1, 2 }};
+	const Span<const int> view = makeSpan(data);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(2,view.size());
+}
+TEST(SpanTests, writesThroughTheView) {
+	std::vector<int> data(2);
+	const Span<int> view = makeSpan(data);
+	view[1] = 3;
+	EXPECT_EQ(3,data[1]);
+}
+TEST(SpanTests, iteratesOverTheElements) {
+	std::vector<int> data = { 1, 2, 3 };
+	int sum = 0;
+	for(auto&& x: makeSpan(data)) sum += x;
+	EXPECT_EQ(6,sum);
+}
+TEST(SpanTests, subspan) {
+	std::vector<int> data = { 1, 2, 3 };
+	const Span<int> view = makeSpan(data).subspan(1,2);
+	EXPECT_EQ(&data[1],view.data());
+	EXPECT_EQ(2,view.size());
+}
+TEST(SpanTests, nonConstViewConvertsToConstView) {
+	std::vector<int> data = { 1, 2, 3 };
+	const Span<const int> view = makeSpan(data);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(data.size(),view.size());
+}
+TEST(SpanTests, emptyView) {
+	EXPECT_TRUE(makeSpan<int>(nullptr,0).empty());
+}
+TEST(SpanTests, isSpan) {
+	const bool spanIsSpan = is_span<Span<int>>::value;
+	const bool vectorIsSpan = is_span<std::vector<int>>::value;
+	EXPECT_TRUE(spanIsSpan);
+	EXPECT_FALSE(vectorIsSpan);
+}
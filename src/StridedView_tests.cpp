@@ -0,0 +1,63 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/NiceMPI.h>
+
+using namespace NiceMPI;
+
+TEST(StridedViewTests, vectorViewsItsElements) {
+	std::vector<int> data(9);
+	const StridedView<int> view = stridedView(data.data(),3,2,3);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(6,view.size());
+	MPI_Aint lowerBound, extent;
+	MPI_Type_get_extent(view.datatype(),&lowerBound,&extent);
+	EXPECT_EQ(8*sizeof(int),extent);
+}
+TEST(StridedViewTests, subarrayViewsItsElements) {
+	std::vector<double> data(12);
+	const StridedView<double> view = subarrayView(data.data(),{3,4},{2,3},{1,1});
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(6,view.size());
+	int size = 0;
+	MPI_Type_size(view.datatype(),&size);
+	EXPECT_EQ(6*sizeof(double),size);
+}
+TEST(StridedViewTests, datatypesAreCachedByShape) {
+	std::vector<int> data(20);
+	const MPI_Datatype first = stridedView(data.data(),2,1,4).datatype();
+	EXPECT_EQ(first,stridedView(data.data()+1,2,1,4).datatype());
+	EXPECT_NE(first,stridedView(data.data(),2,1,5).datatype());
+	EXPECT_NE(first,subarrayView(data.data(),{2,1,4},{2,1,1},{0,0,0}).datatype());
+}
+TEST(StridedViewTests, nonConstViewConvertsToConstView) {
+	std::vector<int> data(4);
+	const StridedView<const int> view = stridedView(data.data(),2,1,2);
+	EXPECT_EQ(data.data(),view.data());
+	EXPECT_EQ(2,view.size());
+}
+TEST(StridedViewTests, subarrayDimensionsMustMatch) {
+	std::vector<int> data(4);
+	EXPECT_THROW(subarrayView(data.data(),{2,2},{1},{0,0}),NiceMPIexception);
+}
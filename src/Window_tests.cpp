@@ -0,0 +1,167 @@
+/* MIT License
+
+Copyright (c) 2016 Kevin Lalumiere
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE. */
+
+#include <algorithm> // std::sort
+#include <utility> // std::move
+#include <vector>
+#include <gtest/gtest.h>
+#include <NiceMPI/Window.h>
+
+using namespace NiceMPI;
+
+class WindowTests : public ::testing::Test {
+public:
+	Communicator world;
+	const int rank = world.rank();
+	const int size = world.size();
+	const int next = (rank + 1) % size;
+	const int previous = (rank + size - 1) % size;
+};
+
+
+TEST_F(WindowTests, localMemory) {
+	Window<double> window(world,3);
+	EXPECT_EQ(3,window.local().size());
+	EXPECT_NE(MPI_WIN_NULL,window.get());
+}
+TEST_F(WindowTests, putBetweenFences) {
+	Window<int> window(world,2);
+	window.local()[0] = -1;
+	window.local()[1] = -1;
+	window.fence();
+	window.put(rank,next,1);
+	window.fence();
+	EXPECT_EQ(-1,window.local()[0]);
+	EXPECT_EQ(previous,window.local()[1]);
+}
+TEST_F(WindowTests, putCollection) {
+	Window<int> window(world,3);
+	const std::vector<int> toPut{rank,rank+1,rank+2};
+	window.fence();
+	window.put(makeSpan(toPut),next,0);
+	window.fence();
+	EXPECT_EQ((std::vector<int>{previous,previous+1,previous+2}),
+		std::vector<int>(window.local().begin(),window.local().end()));
+}
+TEST_F(WindowTests, getInPassiveEpoch) {
+	Window<int> window(world,1);
+	window.local()[0] = 10*rank;
+	world.allReduce(0); // Every process initialized its memory
+	window.lockAll();
+	EXPECT_EQ(10*next,window.get(next,0));
+	window.unlockAll();
+	world.allReduce(0); // Every process read before the window is freed
+}
+TEST_F(WindowTests, accumulateSums) {
+	Window<int> window(world,1);
+	window.local()[0] = 0;
+	window.fence();
+	window.accumulate(rank + 1,0,0);
+	window.fence();
+	if(rank == 0) {
+		EXPECT_EQ(size*(size+1)/2,window.local()[0]);
+	}
+}
+TEST_F(WindowTests, fetchAndOpIsAtomic) {
+	Window<int> window(world,1);
+	window.local()[0] = 0;
+	window.fence();
+	window.lockAll();
+	const int previousValue = window.fetchAndOp(1,0,0);
+	window.unlockAll();
+	window.fence();
+	EXPECT_GE(previousValue,0);
+	EXPECT_LT(previousValue,size);
+	std::vector<int> all = world.allGather(previousValue);
+	std::sort(all.begin(),all.end());
+	for(int i = 0; i < size; ++i) {
+		EXPECT_EQ(i,all[i]);
+	}
+	if(rank == 0) {
+		EXPECT_EQ(size,window.local()[0]);
+	}
+}
+TEST_F(WindowTests, fetchAndNoOpReads) {
+	Window<int> window(world,1);
+	window.local()[0] = rank;
+	window.fence();
+	window.lockAll();
+	EXPECT_EQ(next,window.fetchAndOp(0,next,0,MPI_NO_OP));
+	window.unlockAll();
+	window.fence();
+}
+TEST_F(WindowTests, compareAndSwapOnce) {
+	Window<int> window(world,1);
+	window.local()[0] = -1;
+	window.fence();
+	window.lockAll();
+	const bool swapped = window.compareAndSwap(rank,-1,0,0) == -1;
+	window.unlockAll();
+	window.fence();
+	EXPECT_EQ(1,world.allReduce(swapped ? 1 : 0));
+}
+TEST_F(WindowTests, exclusiveLock) {
+	Window<int> window(world,1);
+	window.local()[0] = 0;
+	window.fence();
+	window.lock(0,true);
+	window.put(window.get(0,0) + 1,0,0);
+	window.unlock(0);
+	window.fence();
+	if(rank == 0) {
+		EXPECT_EQ(size,window.local()[0]);
+	}
+}
+TEST_F(WindowTests, sharedMemory) {
+	Communicator node = world.splitShared();
+	Window<int> window = Window<int>::allocateShared(node,1);
+	window.local()[0] = node.rank();
+	window.lockAll();
+	window.sync();
+	node.allReduce(0); // Every process stored its element
+	window.sync();
+	const int last = node.size() - 1;
+	ASSERT_EQ(1,window.sharedMemory(last).size());
+	EXPECT_EQ(last,window.sharedMemory(last)[0]);
+	window.unlockAll();
+}
+TEST_F(WindowTests, dynamicWindow) {
+	if(size == 1) return; // The shared memory component of Open MPI, used for one process, has no dynamic window
+	Window<int> window = Window<int>::createDynamic(world);
+	EXPECT_EQ(0,window.local().size());
+	std::vector<int> memory{rank,-rank};
+	const MPI_Aint address = window.attach(makeSpan(memory));
+	const std::vector<MPI_Aint> addresses = world.allGather(address);
+	window.lockAll();
+	EXPECT_EQ(-next,window.get(next,window.displace(addresses[next],1)));
+	window.unlockAll();
+	world.allReduce(0); // Every process read before the memory is detached
+	window.detach(makeSpan(memory));
+}
+TEST_F(WindowTests, canBeMoved) {
+	Window<int> window(world,1);
+	window.local()[0] = rank;
+	Window<int> moved(std::move(window));
+	EXPECT_EQ(MPI_WIN_NULL,window.get());
+	EXPECT_EQ(1,moved.local().size());
+	EXPECT_EQ(rank,moved.local()[0]);
+}
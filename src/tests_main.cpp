@@ -24,7 +24,7 @@ SOFTWARE. */
 #include <NiceMPI/NiceMPI.h>
 
 int main(int argc, char* argv[]) {
-	NiceMPI::Initializer instance{argc,argv};
+	NiceMPI::Initializer instance{argc,argv,MPI_THREAD_MULTIPLE};
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }